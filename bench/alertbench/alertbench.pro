@@ -0,0 +1,14 @@
+# Benchmark of the alert engine: thousands of rules against a replayed
+# random-walk tick stream. Build and run on the desktop:
+#   qmake && make && ./alertbench [rules] [ticks]
+
+TARGET = alertbench
+TEMPLATE = app
+
+QT = core
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../../src/core/core.pri)
+
+SOURCES += main.cpp
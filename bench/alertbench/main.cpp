@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include "alerts.h"
+#include "symbols.h"
+
+namespace {
+    // deterministic xorshift, the stream must be identical between runs
+    quint32 s_state = 2463534242u;
+
+    quint32 nextRandom()
+    {
+        s_state ^= s_state << 13;
+        s_state ^= s_state >> 17;
+        s_state ^= s_state << 5;
+        return s_state;
+    }
+
+    double uniform()
+    {
+        return double(nextRandom()) / 4294967296.0;
+    }
+}
+
+class Counter : public QObject
+{
+    Q_OBJECT
+
+public:
+    Counter()
+        :   fired(0)
+    {
+    }
+
+    qint64 fired;
+
+public slots:
+    void onTriggered(int rule, int pair, const Price &price)
+    {
+        Q_UNUSED(rule);
+        Q_UNUSED(pair);
+        Q_UNUSED(price);
+        fired++;
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int rules = args.size() > 1 ? args.at(1).toInt() : 5000;
+    int ticks = args.size() > 2 ? args.at(2).toInt() : 1000000;
+    QTextStream out(stdout);
+
+    // every pair random walks around 1.0 in its own scale
+    int pairs = Symbols::count();
+    QVector<double> prices(pairs, 1.0);
+
+    AlertEngine engine;
+    Counter counter;
+    QObject::connect(&engine, SIGNAL(triggered(int,int,Price)), &counter, SLOT(onTriggered(int,int,Price)));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rules; i++)
+    {
+        int pair = nextRandom() % pairs;
+        int scale = Symbols::info(pair).scale;
+        switch (nextRandom() % 10)
+        {
+        case 0:
+            engine.addPercentMove(pair, 1.0 + uniform() * 4.0);
+            break;
+        case 1:
+            engine.addSpread(pair, nextRandom() % pairs, 1.0 + uniform() * 4.0);
+            break;
+        default:
+            engine.addThreshold(pair, nextRandom() % 2, Price::fromDouble(0.8 + uniform() * 0.4, scale));
+            break;
+        }
+    }
+    qint64 setup = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < ticks; i++)
+    {
+        int pair = nextRandom() % pairs;
+        prices[pair] *= 1.0 + (uniform() - 0.5) * 0.002;
+        engine.add(pair, Price::fromDouble(prices.at(pair), Symbols::info(pair).scale));
+    }
+    qint64 replay = timer.nsecsElapsed();
+
+    out << "rules:        " << engine.count() << " (setup " << setup / 1000000.0 << " ms)\n";
+    out << "ticks:        " << ticks << "\n";
+    out << "alerts fired: " << counter.fired << "\n";
+    out << "replay:       " << replay / 1000000.0 << " ms, "
+        << double(replay) / qMax(ticks, 1) << " ns/tick, "
+        << qint64(ticks / (replay / 1000000000.0)) << " ticks/s\n";
+    return 0;
+}
+
+#include "main.moc"
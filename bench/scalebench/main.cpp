@@ -0,0 +1,596 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+#include <cstdlib>
+#include <new>
+#include <time.h>
+
+#include "tickercore.h"
+#include "memoryreport.h"
+
+/*
+ * Every step runs in its own process, the exchange config can only be
+ * loaded once. The parent spawns one child per scale step and prints their
+ * report lines as a table.
+ *
+ * A child serves Venues simulated exchanges from a local http server on its
+ * own thread. Each venue lists every asset, so each asset pair has a
+ * consensus over all venues. A share of the markets moves per request. The
+ * core sees them as configured exchanges, and every cycle goes through
+ * fetch, parse, store and notify. After each cycle the strings the overview
+ * page shows are formatted for all pairs. That stands in for the ui refresh,
+ * real frame times need the device.
+ *
+ * With --soak SECONDS a single step polls at --interval for that long and
+ * then prints the memory report of the core. Resident size is sampled after
+ * every cycle once the first tenth of the run is over. The run fails if the
+ * steady state peak exceeds --max-rss or grew by more than --max-growth
+ * (MB) over its first sample.
+ */
+
+namespace {
+    QAtomicInt s_allocations;
+
+    // deterministic xorshift, the walks must be identical between runs
+    quint32 nextRandom(quint32 &state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    double cpuSeconds(clockid_t clock)
+    {
+        timespec now;
+        clock_gettime(clock, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+    }
+
+    // resident and peak resident size in kB
+    qint64 memory(const char *field)
+    {
+        QFile status("/proc/self/status");
+        if (!status.open(QIODevice::ReadOnly))
+        {
+            return 0;
+        }
+        QByteArray data = status.readAll();
+        int pos = data.indexOf(field);
+        if (pos < 0)
+        {
+            return 0;
+        }
+        pos += qstrlen(field);
+        while (pos < data.size() && (data.at(pos) == ' ' || data.at(pos) == '\t'))
+        {
+            pos++;
+        }
+        int end = pos;
+        while (end < data.size() && data.at(end) >= '0' && data.at(end) <= '9')
+        {
+            end++;
+        }
+        return data.mid(pos, end - pos).toLongLong();
+    }
+}
+
+void *operator new(size_t size)
+{
+    s_allocations.ref();
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *p) throw()
+{
+    free(p);
+}
+
+class SimServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    SimServer(int venues, int markets, double moving)
+        :   m_venues(venues)
+        ,   m_markets(markets)
+        ,   m_moving(moving)
+        ,   m_prices(venues * markets)
+        ,   m_state(2463534242u)
+    {
+        for (int i = 0; i < m_prices.size(); i++)
+        {
+            // venues of one asset start close to each other
+            m_prices[i] = 0.001 * (1 + i % markets) * (1.0 + 0.001 * (i / markets));
+        }
+    }
+
+    quint16 port() const
+    {
+        return m_server.serverPort();
+    }
+
+public slots:
+    void start()
+    {
+        connect(&m_server, SIGNAL(newConnection()), this, SLOT(onConnection()));
+        m_server.listen(QHostAddress::LocalHost);
+    }
+
+private slots:
+    void onConnection()
+    {
+        while (m_server.hasPendingConnections())
+        {
+            QTcpSocket *socket = m_server.nextPendingConnection();
+            connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+            connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        }
+    }
+
+    void onReadyRead()
+    {
+        // keep-alive connections carry one GET /v<n> after the other
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        QByteArray &buffer = m_buffers[socket];
+        buffer.append(socket->readAll());
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) >= 0)
+        {
+            QByteArray request = buffer.left(end);
+            buffer.remove(0, end + 4);
+            int venue = request.mid(request.indexOf("/v") + 2).split(' ').first().toInt();
+            QByteArray body = render(qBound(0, venue, m_venues - 1));
+            socket->write(QByteArray("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: ")
+                          .append(QByteArray::number(body.size())).append("\r\n\r\n").append(body));
+        }
+    }
+
+private:
+    QByteArray render(int venue)
+    {
+        QByteArray body;
+        body.reserve(m_markets * 96);
+        body.append('{');
+        char buffer[Price::MaxFormatted];
+        for (int market = 0; market < m_markets; market++)
+        {
+            double &price = m_prices[venue * m_markets + market];
+            if (nextRandom(m_state) < m_moving * 4294967295.0)
+            {
+                price *= 1.0 + (double(nextRandom(m_state)) / 4294967296.0 - 0.5) * 0.002;
+            }
+            Price bid = Price::fromDouble(price, 8);
+            Price ask = Price::fromDouble(price * 1.002, 8);
+            if (market > 0)
+            {
+                body.append(',');
+            }
+            body.append("\"M").append(QByteArray::number(market)).append("\":{\"bid\":\"");
+            body.append(buffer, bid.format(buffer, 8)).append("\",\"ask\":\"");
+            body.append(buffer, ask.format(buffer, 8)).append("\",\"volume\":\"1234.5\"}");
+        }
+        body.append('}');
+        return body;
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    int m_venues;
+    int m_markets;
+    double m_moving;
+    QVector<double> m_prices;
+    quint32 m_state;
+};
+
+class Step : public QObject
+{
+    Q_OBJECT
+
+public:
+    Step(TickerCore *core, const QList<ConfigExchange *> &exchanges, int cycles)
+        :   m_core(core)
+        ,   m_exchanges(exchanges)
+        ,   m_cycles(cycles)
+        ,   m_cycle(0)
+        ,   m_pending(0)
+        ,   m_quotes(0)
+        ,   m_cycleNs(0)
+        ,   m_worstNs(0)
+        ,   m_uiNs(0)
+        ,   m_cpu(0.0)
+        ,   m_allocations(0)
+        ,   m_soak(0)
+        ,   m_interval(0)
+        ,   m_firstRss(0)
+        ,   m_peakRss(0)
+    {
+        for (int i = 0; i < m_exchanges.size(); i++)
+        {
+            connect(m_exchanges.at(i), SIGNAL(quoteUpdated(int)), m_core, SLOT(ingest(int)));
+            connect(m_exchanges.at(i), SIGNAL(fetched()), this, SLOT(onFetched()));
+        }
+        connect(m_core, SIGNAL(quoteUpdated(int)), this, SLOT(onQuote()));
+    }
+
+    void setSoak(int seconds, int interval)
+    {
+        m_soak = qint64(seconds) * 1000;
+        m_interval = interval;
+    }
+
+    // resident kB after the warm-up, first sample and peak
+    qint64 firstRss() const
+    {
+        return m_firstRss;
+    }
+
+    qint64 peakRss() const
+    {
+        return m_peakRss;
+    }
+
+    QString report() const
+    {
+        int pairs = Symbols::count() - Pair::Count;
+        int cycles = qMax(m_cycle, 1);
+        return QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10")
+                .arg(pairs, 6).arg(m_exchanges.size(), 6)
+                .arg(m_cycleNs / cycles / 1e6, 9, 'f', 2).arg(m_worstNs / 1e6, 9, 'f', 2)
+                .arg(m_cpu * 1e3 / cycles, 9, 'f', 2)
+                .arg(m_quotes > 0 ? m_cpu * 1e9 / m_quotes : 0.0, 9, 'f', 0)
+                .arg(m_allocations / cycles, 9)
+                .arg(m_uiNs / cycles / 1e6, 9, 'f', 2)
+                .arg(memory("VmRSS:") / 1024.0, 8, 'f', 1)
+                .arg(memory("VmHWM:") / 1024.0, 8, 'f', 1);
+    }
+
+public slots:
+    void next()
+    {
+        if (!m_clock.isValid())
+        {
+            m_clock.start();
+        }
+        if (m_soak > 0 ? m_clock.elapsed() >= m_soak : m_cycle == m_cycles)
+        {
+            QCoreApplication::quit();
+            return;
+        }
+        m_timer.start();
+        m_cpuStart = cpuSeconds(CLOCK_THREAD_CPUTIME_ID);
+        m_allocationStart = s_allocations.load();
+        m_pending = 0;
+        for (int i = 0; i < m_exchanges.size(); i++)
+        {
+            m_pending += m_exchanges.at(i)->fetch() ? 1 : 0;
+        }
+        if (m_pending == 0)
+        {
+            QCoreApplication::exit(1);
+        }
+    }
+
+private slots:
+    void onQuote()
+    {
+        m_quotes++;
+    }
+
+    void onFetched()
+    {
+        if (--m_pending > 0)
+        {
+            return;
+        }
+
+        // what the overview page formats once per second
+        QElapsedTimer ui;
+        ui.start();
+        int length = 0;
+        const PriceTable *prices = m_core->prices();
+        for (int pair = Pair::Count; pair < Symbols::count(); pair++)
+        {
+            length += prices->quote(pair).value.toString(Symbols::info(pair).precision).size();
+        }
+        for (int market = 0; market < m_core->consensus()->count(); market++)
+        {
+            length += m_core->consensus()->book(market).median.toString(8).size();
+        }
+        m_uiNs += ui.nsecsElapsed();
+        m_length = length;
+
+        // the first cycle warms up connections and tables
+        qint64 elapsed = m_timer.nsecsElapsed();
+        if (m_cycle > 0 || m_cycles == 1)
+        {
+            m_cycleNs += elapsed;
+            m_worstNs = qMax(m_worstNs, elapsed);
+            m_cpu += cpuSeconds(CLOCK_THREAD_CPUTIME_ID) - m_cpuStart;
+            m_allocations += s_allocations.load() - m_allocationStart;
+        }
+        else
+        {
+            m_quotes = 0;
+        }
+        m_cycle++;
+
+        if (m_soak > 0 && m_clock.elapsed() >= m_soak / 10)
+        {
+            qint64 rss = memory("VmRSS:");
+            m_firstRss = m_firstRss > 0 ? m_firstRss : rss;
+            m_peakRss = qMax(m_peakRss, rss);
+        }
+        QTimer::singleShot(m_interval, this, SLOT(next()));
+    }
+
+private:
+    TickerCore *m_core;
+    QList<ConfigExchange *> m_exchanges;
+    QElapsedTimer m_timer;
+    QElapsedTimer m_clock;
+    int m_cycles;
+    int m_cycle;
+    int m_pending;
+    int m_length;
+    qint64 m_quotes;
+    qint64 m_cycleNs;
+    qint64 m_worstNs;
+    qint64 m_uiNs;
+    double m_cpu;
+    double m_cpuStart;
+    qint64 m_allocations;
+    int m_allocationStart;
+    qint64 m_soak;
+    int m_interval;
+    qint64 m_firstRss;
+    qint64 m_peakRss;
+};
+
+namespace {
+    const char HEADER[] =
+        " pairs venues  cycle ms  worst ms    cpu ms   ns/quote allocs/cy     ui ms   rss MB  peak MB\n";
+
+    struct Options
+    {
+        Options()
+            :   venues(4)
+            ,   cycles(20)
+            ,   moving(0.3)
+            ,   soak(0)
+            ,   interval(0)
+            ,   maxRss(128.0)
+            ,   maxGrowth(4.0)
+        {
+        }
+
+        int venues;
+        int cycles;
+        double moving;
+        int soak;           // seconds
+        int interval;       // ms between cycles
+        double maxRss;      // MB
+        double maxGrowth;   // MB
+    };
+
+    int runStep(QCoreApplication &app, int pairs, const Options &options)
+    {
+        int venues = options.venues;
+        // a throwaway data directory, the tick log and candles are written
+        QStandardPaths::setTestModeEnabled(true);
+        QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).removeRecursively();
+
+        int markets = qMax(1, pairs / venues);
+        SimServer server(venues, markets, options.moving);
+        QThread thread;
+        server.moveToThread(&thread);
+        thread.start();
+        QMetaObject::invokeMethod(&server, "start", Qt::BlockingQueuedConnection);
+
+        // one shared reply per venue, paths compiled per market
+        QByteArray config("{\"exchanges\":[");
+        for (int venue = 0; venue < venues; venue++)
+        {
+            config.append(venue > 0 ? "," : "").append("{\"name\":\"Sim").append(QByteArray::number(venue))
+                  .append("\",\"url\":\"http://127.0.0.1:").append(QByteArray::number(server.port()))
+                  .append("/v").append(QByteArray::number(venue))
+                  .append("\",\"fields\":{\"bid\":\"{market}.bid\",\"ask\":\"{market}.ask\",\"volume\":\"{market}.volume\"},\"markets\":[");
+            for (int market = 0; market < markets; market++)
+            {
+                config.append(market > 0 ? "," : "").append("{\"market\":\"M").append(QByteArray::number(market))
+                      .append("\",\"base\":\"A").append(QByteArray::number(market)).append("\",\"quote\":\"BTC\"}");
+            }
+            config.append("]}");
+        }
+        config.append("]}");
+
+        QString path = QDir::temp().filePath(QString("scalebench-%1.json").arg(app.applicationPid()));
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(config) != config.size())
+        {
+            return 1;
+        }
+        file.close();
+        bool loaded = ExchangeConfig::load(path);
+        file.remove();
+        if (!loaded)
+        {
+            QTextStream(stderr) << ExchangeConfig::errorString() << "\n";
+            return 1;
+        }
+
+        // the built-in exchanges stay idle, only the simulated ones are polled
+        TickerCore core;
+        QList<ConfigExchange *> exchanges;
+        const QList<ExchangeConfig::Definition> &definitions = ExchangeConfig::definitions();
+        for (int i = 0; i < definitions.size(); i++)
+        {
+            exchanges.append(new ConfigExchange(definitions.at(i), core.prices(), core.usage(), &core));
+        }
+
+        Step step(&core, exchanges, options.cycles + 1);
+        step.setSoak(options.soak, options.interval);
+        QMetaObject::invokeMethod(&step, "next", Qt::QueuedConnection);
+        int result = app.exec();
+        core.ticks()->flush();
+        QTextStream(stdout) << step.report() << "\n";
+
+        if (options.soak > 0 && result == 0)
+        {
+            MemoryReport report;
+            core.measure(report);
+            for (int i = 0; i < exchanges.size(); i++)
+            {
+                exchanges.at(i)->measure(report);
+            }
+            double peak = step.peakRss() / 1024.0;
+            double growth = (step.peakRss() - step.firstRss()) / 1024.0;
+            QTextStream(stdout) << "\n" << report.toText()
+                                << QString("steady rss %1 MB (bound %2), growth %3 MB (bound %4)\n")
+                                   .arg(peak, 0, 'f', 1).arg(options.maxRss, 0, 'f', 1)
+                                   .arg(growth, 0, 'f', 1).arg(options.maxGrowth, 0, 'f', 1);
+            if (peak > options.maxRss || growth > options.maxGrowth)
+            {
+                QTextStream(stdout) << "FAIL\n";
+                result = 1;
+            }
+        }
+
+        QMetaObject::invokeMethod(&thread, "quit", Qt::QueuedConnection);
+        thread.wait();
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("drkjolla-scalebench");
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    Options options;
+    QList<int> steps;
+    steps << 22 << 100 << 250 << 500 << 1000 << 2000 << 5000;
+    bool child = false;
+    for (int i = 1; i + 1 < args.size(); i += 2)
+    {
+        if (args.at(i) == "--pairs")
+        {
+            steps = QList<int>() << args.at(i + 1).toInt();
+            child = true;
+        }
+        else if (args.at(i) == "--venues")
+        {
+            // every venue is a configured exchange, their ids end at Max
+            int venues = args.at(i + 1).toInt();
+            int limit = Exchange::Max - Exchange::Count + 1;
+            options.venues = qBound(1, venues, limit);
+            if (options.venues != venues)
+            {
+                QTextStream(stderr) << "--venues " << venues << " out of range, using " << options.venues
+                                    << " (1 to " << limit << " configured exchanges)\n";
+            }
+        }
+        else if (args.at(i) == "--cycles")
+        {
+            options.cycles = qMax(1, args.at(i + 1).toInt());
+        }
+        else if (args.at(i) == "--moving")
+        {
+            options.moving = qBound(0.0, args.at(i + 1).toDouble(), 1.0);
+        }
+        else if (args.at(i) == "--soak")
+        {
+            options.soak = qMax(1, args.at(i + 1).toInt());
+        }
+        else if (args.at(i) == "--interval")
+        {
+            options.interval = qMax(0, args.at(i + 1).toInt());
+        }
+        else if (args.at(i) == "--max-rss")
+        {
+            options.maxRss = args.at(i + 1).toDouble();
+        }
+        else if (args.at(i) == "--max-growth")
+        {
+            options.maxGrowth = args.at(i + 1).toDouble();
+        }
+    }
+
+    // a soak is a single step, 500 pairs unless told otherwise
+    if (options.soak > 0)
+    {
+        out << HEADER;
+        out.flush();
+        return runStep(app, child ? steps.first() : 500, options);
+    }
+    if (child)
+    {
+        return runStep(app, steps.first(), options);
+    }
+
+    out << "venues " << options.venues << ", " << options.cycles << " cycles per step, "
+        << int(options.moving * 100) << "% of the markets move per request\n" << HEADER;
+    out.flush();
+    for (int i = 0; i < steps.size(); i++)
+    {
+        QProcess process;
+        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        process.start(app.applicationFilePath(), QStringList()
+                      << "--pairs" << QString::number(steps.at(i))
+                      << "--venues" << QString::number(options.venues)
+                      << "--cycles" << QString::number(options.cycles)
+                      << "--moving" << QString::number(options.moving)
+                      << "--interval" << QString::number(options.interval));
+        process.waitForFinished(-1);
+        out << process.readAllStandardOutput();
+        out.flush();
+    }
+    return 0;
+}
+
+#include "main.moc"
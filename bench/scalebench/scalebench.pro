@@ -0,0 +1,17 @@
+# Scale harness: simulated exchanges serving random-walk tickers for
+# thousands of pairs over local http, driven through the full core pipeline.
+# Build and run on the desktop:
+#   qmake && make && ./scalebench [--pairs N] [--venues N] [--cycles N]
+# Soak with a bound on the steady state resident size, exits 1 above it:
+#   ./scalebench --soak 3600 --interval 1000 --max-rss 128 --max-growth 4
+
+TARGET = scalebench
+TEMPLATE = app
+
+QT = core
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../../src/core/core.pri)
+
+SOURCES += main.cpp
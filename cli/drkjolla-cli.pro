@@ -0,0 +1,23 @@
+# Command line front end of the ticker core for desktop Linux and servers.
+#   qmake && make
+#   ./drkjolla-cli --format json --pairs poloniexXmrBtc,bitfinexBtcUsd
+#   ./drkjolla-cli --interval 60 --format csv --output prices.csv
+#   ./drkjolla-cli --listen 8421 &
+#   curl localhost:8421/snapshot
+#   ./drkjolla-cli --dbus
+
+TARGET = drkjolla-cli
+TEMPLATE = app
+
+QT = core
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../src/core/core.pri)
+include(../src/dbus/dbus.pri)
+
+HEADERS += \
+    runner.h
+
+SOURCES += main.cpp \
+    runner.cpp
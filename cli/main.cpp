@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+
+#include <cstdio>
+
+#include "tickercore.h"
+#include "snapshot.h"
+#include "httpapi.h"
+#include "tickerservice.h"
+#include "historyexport.h"
+#include "replay.h"
+#include "trace.h"
+#include "shutdown.h"
+#include "runner.h"
+
+namespace {
+    // unix seconds or an utc date like 2014-12-03
+    uint parseTime(const QString &text, bool *ok)
+    {
+        uint seconds = text.toUInt(ok);
+        if (*ok)
+        {
+            return seconds;
+        }
+        QDateTime date = QDateTime::fromString(text, "yyyy-MM-dd");
+        date.setTimeSpec(Qt::UTC);
+        *ok = date.isValid();
+        return *ok ? date.toTime_t() : 0;
+    }
+
+    // --from and --to, the last 30 days by default
+    bool parseRange(const QCommandLineParser &parser, const QCommandLineOption &from, const QCommandLineOption &to,
+                    uint *start, uint *end)
+    {
+        bool ok = true;
+        *end = parser.isSet(to) ? parseTime(parser.value(to), &ok) : QDateTime::currentDateTime().toTime_t();
+        *start = *end - qMin(*end, 30 * 86400u);
+        if (ok && parser.isSet(from))
+        {
+            *start = parseTime(parser.value(from), &ok);
+        }
+        return ok && *start <= *end;
+    }
+
+    // pair:above:price, pair:below:price, pair:move:percent or
+    // pair:spread:percent:other
+    bool addAlert(AlertEngine *alerts, const QString &text)
+    {
+        QStringList parts = text.split(':');
+        bool ok = false;
+        int pair = parts.size() >= 3 ? Symbols::find(parts.at(0)) : int(Pair::Invalid);
+        double value = parts.size() >= 3 ? parts.at(2).toDouble(&ok) : 0.0;
+        if (pair == Pair::Invalid || !ok)
+        {
+            return false;
+        }
+        const QString &type = parts.at(1);
+        if ((type == "above" || type == "below") && parts.size() == 3)
+        {
+            alerts->addThreshold(pair, type == "above", Price::fromDouble(value, Symbols::info(pair).scale));
+        }
+        else if (type == "move" && parts.size() == 3)
+        {
+            alerts->addPercentMove(pair, value);
+        }
+        else if (type == "spread" && parts.size() == 4 && Symbols::find(parts.at(3)) != Pair::Invalid)
+        {
+            // only markets of the same base and quote
+            return alerts->addSpread(pair, Symbols::find(parts.at(3)), value) > 0;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    QByteArray replayReport(TickerCore *core, const QList<int> &pairs, const Replay::Result &result, Snapshot::Format format)
+    {
+        // fired alerts in virtual time, then the statistics at the end
+        QByteArray out;
+        char price[Price::MaxFormatted];
+        if (format == Snapshot::Csv)
+        {
+            out.append("time,pair,rule,price\n");
+        }
+        for (int i = 0; i < result.alerts.size(); i++)
+        {
+            const Replay::Alert &alert = result.alerts.at(i);
+            const PairInfo &info = Symbols::info(alert.pair);
+            QByteArray time = QByteArray::number(alert.time);
+            QByteArray rule = QByteArray::number(alert.rule);
+            int length = alert.price.format(price, info.precision);
+            if (format == Snapshot::Json)
+            {
+                out.append("{\"time\":").append(time).append(",\"pair\":");
+                Snapshot::appendString(out, info.name);
+                out.append(",\"rule\":").append(rule).append(",\"price\":").append(price, length).append("}\n");
+            }
+            else if (format == Snapshot::Csv)
+            {
+                out.append(time).append(',').append(info.name).append(',').append(rule).append(',').append(price, length).append('\n');
+            }
+            else
+            {
+                out.append(QDateTime::fromTime_t(alert.time).toUTC().toString(Qt::ISODate).toLatin1()).append("  ")
+                   .append(info.name).append("  rule ").append(rule).append(" at ").append(price, length).append('\n');
+            }
+        }
+
+        if (format == Snapshot::Csv)
+        {
+            out.append("pair,sma,ema,stddev,minimum,maximum,change\n");
+        }
+        for (int i = 0; i < pairs.size(); i++)
+        {
+            const PairInfo &info = Symbols::info(pairs.at(i));
+            if (!core->prices()->quote(pairs.at(i)).isValid())
+            {
+                continue;
+            }
+            PairStatistics *stats = core->statistics()->pair(pairs.at(i));
+            double values[] = { stats->sma(), stats->ema(), stats->stddev(), stats->minimum(), stats->maximum(), stats->change() };
+            const char *names[] = { "sma", "ema", "stddev", "minimum", "maximum", "change" };
+            if (format == Snapshot::Json)
+            {
+                out.append("{\"pair\":");
+                Snapshot::appendString(out, info.name);
+                for (int k = 0; k < 6; k++)
+                {
+                    out.append(",\"").append(names[k]).append("\":").append(QByteArray::number(values[k], 'g', 12));
+                }
+                out.append("}\n");
+            }
+            else
+            {
+                out.append(info.name);
+                for (int k = 0; k < 6; k++)
+                {
+                    if (format == Snapshot::Csv)
+                    {
+                        out.append(',');
+                    }
+                    else
+                    {
+                        out.append("  ").append(names[k]).append(' ');
+                    }
+                    out.append(QByteArray::number(values[k], 'g', 12));
+                }
+                out.append('\n');
+            }
+        }
+        return out;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // same data directory as the app, candles and portfolio are shared;
+    // while the app or the service writes it the tool only reads
+    app.setOrganizationName("harbour-drkjolla");
+    app.setApplicationName("harbour-drkjolla");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fetches crypto currency tickers and prints the current prices.");
+    parser.addHelpOption();
+    QCommandLineOption once("once", "Fetch a single time and exit (default).");
+    QCommandLineOption interval(QStringList() << "i" << "interval", "Refresh every <seconds> until interrupted.", "seconds", "0");
+    QCommandLineOption format(QStringList() << "f" << "format", "Output format: text, csv or json.", "format", "text");
+    QCommandLineOption output(QStringList() << "o" << "output", "Replace <file> with every snapshot instead of printing it.", "file");
+    QCommandLineOption pairs(QStringList() << "p" << "pairs", "Comma separated pair names, e.g. poloniexXmrBtc. All pairs by default.", "names");
+    QCommandLineOption listen(QStringList() << "l" << "listen", "Serve the quotes as JSON over HTTP on localhost:<port>.", "port");
+    QCommandLineOption dbus("dbus", "Run as the org.drkjolla.Ticker session bus service, polling every <interval> seconds (default 300).");
+    QCommandLineOption exportHistory(QStringList() << "e" << "export", "Stream the recorded history to <file> (- for stdout) as csv or json lines and exit.", "file");
+    QCommandLineOption backfill(QStringList() << "b" << "backfill", "Fill the history of the last <days> from the exchange chart api and exit.", "days");
+    QCommandLineOption backfillUrl("backfill-url", "Chart api base url, e.g. a local stand-in (default https://poloniex.com/public).", "url");
+    QCommandLineOption from("from", "Start of the exported range, unix time or yyyy-MM-dd (default: 30 days ago).", "time");
+    QCommandLineOption to("to", "End of the exported range, unix time or yyyy-MM-dd (default: now).", "time");
+    QCommandLineOption trades(QStringList() << "t" << "trades", "Print new trades of the Bitfinex and Poloniex pairs as csv or json lines instead of snapshots.");
+    QCommandLineOption exchanges("exchanges", "Load additional exchanges from <file> (default: exchanges.json in the data directory).", "file");
+    QCommandLineOption replay("replay", "Replay the recorded history between --from and --to through the alerts and statistics as fast as possible, print what fired and exit.");
+    QCommandLineOption alert(QStringList() << "a" << "alert", "Alert rule for --replay: pair:above:price, pair:below:price, pair:move:percent or pair:spread:percent:other. Repeatable.", "rule");
+    QCommandLineOption budget("budget", "Monthly mobile data budget in <MB>; near it refreshing slows down and pairs not given by --pairs are left out.", "MB");
+    QCommandLineOption memory(QStringList() << "m" << "memory", "Print live bytes and objects per subsystem to stderr after every refresh.");
+    QCommandLineOption trace("trace", "Record a timeline of requests, parsing and storing, written to <file> as Chrome trace-event JSON on exit.", "file");
+    parser.addOption(once);
+    parser.addOption(interval);
+    parser.addOption(format);
+    parser.addOption(output);
+    parser.addOption(pairs);
+    parser.addOption(listen);
+    parser.addOption(dbus);
+    parser.addOption(exportHistory);
+    parser.addOption(backfill);
+    parser.addOption(backfillUrl);
+    parser.addOption(from);
+    parser.addOption(to);
+    parser.addOption(trades);
+    parser.addOption(exchanges);
+    parser.addOption(replay);
+    parser.addOption(alert);
+    parser.addOption(budget);
+    parser.addOption(memory);
+    parser.addOption(trace);
+    parser.process(app);
+    Shutdown::install();
+
+    if (parser.isSet(trace))
+    {
+        Trace::start(parser.value(trace));
+    }
+
+    // configured pairs have to be known before --pairs is resolved
+    if (!ExchangeConfig::load(parser.value(exchanges)))
+    {
+        fprintf(stderr, "drkjolla-cli: %s\n", qPrintable(ExchangeConfig::errorString()));
+        return 2;
+    }
+
+    bool ok = false;
+    Snapshot::Format snapshotFormat = Snapshot::parseFormat(parser.value(format), &ok);
+    if (!ok)
+    {
+        fprintf(stderr, "drkjolla-cli: unknown format %s\n", qPrintable(parser.value(format)));
+        return 2;
+    }
+
+    int seconds = parser.isSet(once) ? 0 : parser.value(interval).toInt(&ok);
+    if (!ok || seconds < 0)
+    {
+        fprintf(stderr, "drkjolla-cli: invalid interval %s\n", qPrintable(parser.value(interval)));
+        return 2;
+    }
+
+    quint16 port = 0;
+    if (parser.isSet(listen))
+    {
+        port = parser.value(listen).toUShort(&ok);
+        if (!ok || port == 0)
+        {
+            fprintf(stderr, "drkjolla-cli: invalid port %s\n", qPrintable(parser.value(listen)));
+            return 2;
+        }
+        // a server keeps refreshing, once a minute unless told otherwise
+        if (seconds == 0)
+        {
+            seconds = 60;
+        }
+    }
+
+    QList<int> selected;
+    if (parser.isSet(pairs))
+    {
+        QStringList names = parser.value(pairs).split(',', QString::SkipEmptyParts);
+        for (int i = 0; i < names.size(); i++)
+        {
+            int pair = Symbols::find(names.at(i).trimmed());
+            if (pair == Pair::Invalid)
+            {
+                fprintf(stderr, "drkjolla-cli: unknown pair %s\n", qPrintable(names.at(i)));
+                return 2;
+            }
+            selected.append(pair);
+        }
+    }
+    else
+    {
+        for (int pair = 0; pair < Symbols::count(); pair++)
+        {
+            selected.append(pair);
+        }
+    }
+
+    TickerCore core;
+
+    if (parser.isSet(budget))
+    {
+        qint64 megabytes = parser.value(budget).toLongLong(&ok);
+        if (!ok || megabytes < 0)
+        {
+            fprintf(stderr, "drkjolla-cli: invalid budget %s\n", qPrintable(parser.value(budget)));
+            return 2;
+        }
+        core.usage()->setBudget(megabytes * 1048576);
+        for (int pair = 0; pair < Symbols::count(); pair++)
+        {
+            core.usage()->setLowPriority(pair, !selected.contains(pair));
+        }
+    }
+
+    if (parser.isSet(backfill))
+    {
+        int days = parser.value(backfill).toInt(&ok);
+        if (!ok || days <= 0)
+        {
+            fprintf(stderr, "drkjolla-cli: invalid backfill days %s\n", qPrintable(parser.value(backfill)));
+            return 2;
+        }
+        if (!core.isWriter())
+        {
+            fprintf(stderr, "drkjolla-cli: the app or the service is writing the history, backfill it from there\n");
+            return 1;
+        }
+        if (parser.isSet(backfillUrl))
+        {
+            core.backfill()->setBaseUrl(QUrl(parser.value(backfillUrl)));
+        }
+        QObject::connect(core.backfill(), SIGNAL(finished(bool,int)), &app, SLOT(quit()));
+        core.backfill()->start(days);
+        if (core.backfill()->isRunning())
+        {
+            app.exec();
+        }
+        core.ticks()->flush();
+        fprintf(stderr, "drkjolla-cli: backfill %s, %d prices added\n",
+                core.backfill()->isComplete() ? "complete" : "interrupted, run again to resume", core.backfill()->added());
+        return core.backfill()->isComplete() ? 0 : 1;
+    }
+
+    if (parser.isSet(exportHistory))
+    {
+        uint start = 0;
+        uint end = 0;
+        if (!parseRange(parser, from, to, &start, &end))
+        {
+            fprintf(stderr, "drkjolla-cli: invalid export range\n");
+            return 2;
+        }
+
+        HistoryExport job(core.ticks());
+        QObject::connect(&job, SIGNAL(finished()), &app, SLOT(quit()));
+        QString target = parser.value(exportHistory);
+        HistoryExport::Format exportFormat = snapshotFormat == Snapshot::Json ? HistoryExport::Json : HistoryExport::Csv;
+        if (target == "-")
+        {
+            job.exportTo(fileno(stdout), selected, start, end, exportFormat);
+        }
+        else
+        {
+            job.exportTo(target, selected, start, end, exportFormat);
+        }
+        app.exec();
+        if (!job.isOk())
+        {
+            fprintf(stderr, "drkjolla-cli: export failed: %s\n", qPrintable(job.errorString()));
+            return 1;
+        }
+        fprintf(stderr, "drkjolla-cli: exported %lld prices\n", job.rows());
+        return 0;
+    }
+
+    if (parser.isSet(replay))
+    {
+        uint start = 0;
+        uint end = 0;
+        if (!parseRange(parser, from, to, &start, &end))
+        {
+            fprintf(stderr, "drkjolla-cli: invalid replay range\n");
+            return 2;
+        }
+        QStringList rules = parser.values(alert);
+        for (int i = 0; i < rules.size(); i++)
+        {
+            if (!addAlert(core.alerts(), rules.at(i)))
+            {
+                fprintf(stderr, "drkjolla-cli: invalid alert %s\n", qPrintable(rules.at(i)));
+                return 2;
+            }
+        }
+
+        // ticks still buffered by a running app or service are not on disk yet
+        Replay engine(&core);
+        Replay::Result result = engine.run(selected, start, end);
+        QByteArray report = replayReport(&core, selected, result, snapshotFormat);
+        fwrite(report.constData(), 1, report.size(), stdout);
+        fprintf(stderr, "drkjolla-cli: replayed %lld ticks from %u to %u in %.3f s, %.0f ticks/s, %d alerts\n",
+                result.ticks, result.first, result.last, result.elapsed / 1e9, result.ticksPerSecond(), result.alerts.size());
+        return 0;
+    }
+
+    HttpApi api(&core);
+    if (port > 0 && !api.listen(port))
+    {
+        fprintf(stderr, "drkjolla-cli: cannot listen on port %d\n", int(port));
+        return 1;
+    }
+
+    if (parser.isSet(dbus))
+    {
+        // the service drives the refresh cycles, the ui follows its signals
+        TickerService service(&core);
+        if (!service.registerService())
+        {
+            fprintf(stderr, "drkjolla-cli: cannot register %s on the session bus\n", TickerBus::SERVICE);
+            return 1;
+        }
+        service.SetInterval(seconds > 0 ? qMax(1, seconds / 60) : 5);
+        service.Refresh();
+        return app.exec();
+    }
+
+    // trades keep coming, refresh once a minute unless told otherwise
+    if (parser.isSet(trades) && seconds == 0)
+    {
+        seconds = 60;
+    }
+
+    if (!core.isWriter())
+    {
+        fprintf(stderr, "drkjolla-cli: the app or the service is writing the history, nothing is recorded\n");
+    }
+
+    Runner runner(&core, selected, snapshotFormat, parser.value(output), seconds);
+    // a server only prints when asked to, the trades take stdout over
+    runner.setQuiet((port > 0 && !parser.isSet(output) && !parser.isSet(format))
+                    || (parser.isSet(trades) && !parser.isSet(output)));
+    runner.setTrades(parser.isSet(trades));
+    runner.setMemory(parser.isSet(memory));
+    QTimer::singleShot(0, &runner, SLOT(start()));
+    return app.exec();
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QSaveFile>
+
+#include <cstdio>
+
+#include "runner.h"
+#include "memoryreport.h"
+
+Runner::Runner(TickerCore *core, const QList<int> &pairs, Snapshot::Format format,
+               const QString &output, int interval, QObject *parent)
+    :   QObject(parent)
+    ,   m_core(core)
+    ,   m_pairs(pairs)
+    ,   m_format(format)
+    ,   m_output(output)
+    ,   m_interval(interval)
+    ,   m_quiet(false)
+    ,   m_memory(false)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), m_core, SLOT(fetch()));
+    connect(m_core, SIGNAL(fetched()), this, SLOT(onFetched()));
+}
+
+void Runner::setQuiet(bool quiet)
+{
+    m_quiet = quiet;
+}
+
+void Runner::setTrades(bool enabled)
+{
+    m_core->trades()->setEnabled(enabled);
+    if (enabled)
+    {
+        connect(m_core->trades(), SIGNAL(tradesAdded(int,QVector<Trade>)), this, SLOT(onTrades(int,QVector<Trade>)));
+    }
+}
+
+void Runner::setMemory(bool enabled)
+{
+    m_memory = enabled;
+}
+
+void Runner::start()
+{
+    m_core->fetch();
+}
+
+void Runner::onFetched()
+{
+    if (!m_quiet && !write(Snapshot::write(*m_core->prices(), m_pairs, m_format)))
+    {
+        QCoreApplication::exit(1);
+        return;
+    }
+
+    if (m_memory)
+    {
+        MemoryReport report;
+        m_core->measure(report);
+        QByteArray text = m_format == Snapshot::Json ? report.toJson() : report.toText();
+        fwrite(text.constData(), 1, text.size(), stderr);
+    }
+
+    if (m_interval <= 0)
+    {
+        QCoreApplication::quit();
+        return;
+    }
+    // the interval runs from the end of a cycle, slow replies never overlap;
+    // near the data budget it is stretched
+    m_timer.start(m_interval * 1000 * m_core->usage()->intervalFactor());
+}
+
+void Runner::onTrades(int pair, const QVector<Trade> &trades)
+{
+    if (!m_pairs.contains(pair))
+    {
+        return;
+    }
+
+    const PairInfo &info = Symbols::info(pair);
+    QByteArray out;
+    for (int i = 0; i < trades.size(); i++)
+    {
+        const Trade &trade = trades.at(i);
+        QByteArray id = QByteArray::number(trade.id);
+        QByteArray time = QByteArray::number(trade.time);
+        QByteArray price = trade.price.toString(info.precision).toLatin1();
+        QByteArray amount = QByteArray::number(trade.amount, 'f', 8);
+        const char *side = trade.buy ? "buy" : "sell";
+        if (m_format == Snapshot::Json)
+        {
+            out.append("{\"pair\":");
+            Snapshot::appendString(out, info.name);
+            out.append(",\"id\":").append(id)
+               .append(",\"time\":").append(time).append(",\"price\":").append(price)
+               .append(",\"amount\":").append(amount).append(",\"side\":\"").append(side).append("\"}\n");
+        }
+        else
+        {
+            out.append(info.name).append(',').append(id).append(',').append(time).append(',')
+               .append(price).append(',').append(amount).append(',').append(side).append('\n');
+        }
+    }
+    fwrite(out.constData(), 1, out.size(), stdout);
+    fflush(stdout);
+}
+
+bool Runner::write(const QByteArray &data)
+{
+    if (m_output.isEmpty())
+    {
+        fwrite(data.constData(), 1, data.size(), stdout);
+        fflush(stdout);
+        return true;
+    }
+
+    // readers of the file never see a half written snapshot
+    QSaveFile file(m_output);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    {
+        fprintf(stderr, "drkjolla-cli: cannot write %s: %s\n",
+                qPrintable(m_output), qPrintable(file.errorString()));
+        return false;
+    }
+    return true;
+}
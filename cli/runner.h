@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <QObject>
+#include <QList>
+#include <QTimer>
+
+#include "tickercore.h"
+#include "snapshot.h"
+
+/*
+ * Drives refresh cycles of the core from the command line. Each finished
+ * cycle writes one snapshot to stdout or replaces the output file; with an
+ * interval of zero the application quits after the first cycle. New trades
+ * are printed as csv or json lines as they come in. The memory report goes to
+ * stderr after every cycle if asked for.
+ */
+class Runner : public QObject
+{
+    Q_OBJECT
+
+public:
+    Runner(TickerCore *core, const QList<int> &pairs, Snapshot::Format format,
+           const QString &output, int interval, QObject *parent = 0);
+
+    void setQuiet(bool quiet);
+    void setTrades(bool enabled);
+    void setMemory(bool enabled);
+
+public slots:
+    void start();
+
+private slots:
+    void onFetched();
+    void onTrades(int pair, const QVector<Trade> &trades);
+
+private:
+    bool write(const QByteArray &data);
+
+    TickerCore *m_core;
+    QList<int> m_pairs;
+    Snapshot::Format m_format;
+    QString m_output;
+    int m_interval;
+    bool m_quiet;
+    bool m_memory;
+    QTimer m_timer;
+};
+
+#endif // RUNNER_H
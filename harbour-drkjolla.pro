@@ -14,17 +14,20 @@ TARGET = harbour-drkjolla
 
 CONFIG += sailfishapp
 
+include(src/core/core.pri)
+include(src/dbus/dbus.pri)
+
 HEADERS += \
     src/tickerhandler.h \
-    src/bitfinex.h \
-    src/cryptsy.h \
-    src/poloniex.h
+    src/pricechart.h
 
 SOURCES += src/drkjolla.cpp \
     src/tickerhandler.cpp \
-    src/bitfinex.cpp \
-    src/cryptsy.cpp \
-    src/poloniex.cpp
+    src/pricechart.cpp
+
+dbus_service.files = src/dbus/org.drkjolla.Ticker.service
+dbus_service.path = /usr/share/dbus-1/services
+INSTALLS += dbus_service
 
 OTHER_FILES += \
     qml/pages/first.qml \
@@ -36,4 +39,10 @@ OTHER_FILES += \
     drkjolla.desktop \
     drkjolla.png \
     qml/harbour-drkjolla.qml \
-    qml/pages/settings.qml
+    qml/pages/settings.qml \
+    qml/pages/portfolio.qml \
+    qml/pages/chart.qml \
+    qml/pages/depth.qml \
+    qml/pages/memory.qml \
+    qml/pages/alerts.qml \
+    tools/gensymbols.py
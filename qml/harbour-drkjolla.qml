@@ -28,6 +28,41 @@ ApplicationWindow
     property TickerHandler drkTicker: TickerHandler {
         id: drkTicker
     }
+    Connections {
+        target: drkTicker
+        onAlert: {
+            alertBanner.text = message
+            alertBannerTimer.restart()
+        }
+    }
+    Rectangle {
+        // the last fired alert on top of any page for a few seconds
+        id: alertBannerBackground
+        width: parent.width
+        height: alertBanner.height + 2 * Theme.paddingMedium
+        color: Theme.highlightDimmerColor
+        opacity: alertBannerTimer.running ? 0.9 : 0.0
+        visible: opacity > 0.0
+        z: 1000
+        Behavior on opacity { FadeAnimation {} }
+        Label {
+            id: alertBanner
+            x: Theme.paddingLarge
+            y: Theme.paddingMedium
+            width: parent.width - 2 * Theme.paddingLarge
+            color: Theme.highlightColor
+            font.pixelSize: Theme.fontSizeSmall
+            wrapMode: Text.WordWrap
+        }
+        MouseArea {
+            anchors.fill: parent
+            onClicked: alertBannerTimer.stop()
+        }
+        Timer {
+            id: alertBannerTimer
+            interval: 5000
+        }
+    }
 }
 
 
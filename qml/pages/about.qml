@@ -24,6 +24,12 @@ Page {
         id: aboutView
         anchors.fill: parent
         contentHeight: aboutColumn.height
+        PullDownMenu {
+            MenuItem {
+                text: qsTr("Memory")
+                onClicked: pageStack.push(Qt.resolvedUrl("memory.qml"))
+            }
+        }
         Column {
             id: aboutColumn
             anchors.centerIn: parent
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+
+Page {
+    id: alertsPage
+    property var types: ["above", "below", "move", "spread"]
+    property var rules: drkApp.drkTicker.alertRules()
+    function refresh() {
+        rules = drkApp.drkTicker.alertRules()
+    }
+    SilicaFlickable {
+        id: alertsView
+        anchors.fill: parent
+        contentHeight: alertsColumn.height
+        PullDownMenu {
+            MenuItem {
+                text: qsTr("Remove All")
+                enabled: rules.length > 0
+                onClicked: {
+                    drkApp.drkTicker.clearAlerts()
+                    alertsPage.refresh()
+                }
+            }
+        }
+        Column {
+            id: alertsColumn
+            x: Theme.paddingLarge
+            width: parent.width - 2 * Theme.paddingLarge
+            spacing: Theme.paddingMedium
+            PageHeader {
+                title: qsTr("Alerts")
+            }
+            ComboBox {
+                id: alertsPair
+                width: parent.width
+                label: qsTr("Market")
+                menu: ContextMenu {
+                    Repeater {
+                        model: drkApp.drkTicker.pairNames()
+                        MenuItem { text: modelData }
+                    }
+                }
+            }
+            ComboBox {
+                id: alertsType
+                width: parent.width
+                label: qsTr("When")
+                menu: ContextMenu {
+                    MenuItem { text: qsTr("rises above") }
+                    MenuItem { text: qsTr("falls below") }
+                    MenuItem { text: qsTr("moves by percent") }
+                    MenuItem { text: qsTr("spread exceeds percent") }
+                }
+            }
+            ComboBox {
+                id: alertsOther
+                width: parent.width
+                label: qsTr("Other market")
+                visible: alertsType.currentIndex === 3
+                menu: ContextMenu {
+                    Repeater {
+                        model: drkApp.drkTicker.pairNames()
+                        MenuItem { text: modelData }
+                    }
+                }
+            }
+            TextField {
+                id: alertsValue
+                width: parent.width * 0.9
+                horizontalAlignment: Text.AlignHCenter
+                label: alertsType.currentIndex < 2 ? qsTr("Price") : qsTr("Percent")
+                placeholderText: label
+                validator: DoubleValidator { bottom: 0 }
+                color: errorHighlight? "red" : Theme.primaryColor
+                inputMethodHints: Qt.ImhFormattedNumbersOnly | Qt.ImhNoPredictiveText
+            }
+            Button {
+                id: alertsAddButton
+                anchors.horizontalCenter: parent.horizontalCenter
+                text: qsTr("Add")
+                enabled: alertsValue.text !== "" && !alertsValue.errorHighlight
+                onClicked: {
+                    var id = drkApp.drkTicker.addAlert(alertsPair.value, alertsPage.types[alertsType.currentIndex],
+                                                       Number(alertsValue.text), alertsOther.value)
+                    alertsStatus.text = id > 0 ? "" : qsTr("A spread needs two markets of the same coins.")
+                    alertsPage.refresh()
+                }
+            }
+            Label {
+                id: alertsStatus
+                x: Theme.paddingMedium
+                text: ""
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                width: parent.width * 0.9
+            }
+            SectionHeader {
+                text: qsTr("Active")
+            }
+            Repeater {
+                model: alertsPage.rules
+                ListItem {
+                    id: alertsItem
+                    width: parent.width
+                    menu: ContextMenu {
+                        MenuItem {
+                            text: qsTr("Remove")
+                            onClicked: {
+                                drkApp.drkTicker.removeAlert(modelData.id)
+                                alertsPage.refresh()
+                            }
+                        }
+                    }
+                    Label {
+                        text: modelData.text
+                        anchors.verticalCenter: parent.verticalCenter
+                        width: parent.width
+                        color: alertsItem.highlighted ? Theme.highlightColor : Theme.primaryColor
+                        font.pixelSize: Theme.fontSizeSmall
+                        truncationMode: TruncationMode.Fade
+                    }
+                }
+            }
+            Label {
+                text: qsTr("Alerts are checked on every new price while the app is running and shown as a banner.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                wrapMode: Text.WordWrap
+                width: parent.width
+            }
+            VerticalScrollDecorator {
+                id: alertsScroll
+                flickable: alertsView
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+import harbour.drkjolla.priceChart 1.7
+
+Page {
+    id: chartPage
+    property var spans: [3600, 86400, 604800, 2592000, 31536000]
+    SilicaFlickable {
+        id: chartView
+        anchors.fill: parent
+        contentHeight: chartColumn.height
+        Column {
+            id: chartColumn
+            x: Theme.paddingLarge
+            width: parent.width - 2 * Theme.paddingLarge
+            spacing: Theme.paddingMedium
+            PageHeader {
+                title: qsTr("Chart")
+            }
+            ComboBox {
+                id: chartPair
+                width: parent.width
+                label: qsTr("Market")
+                menu: ContextMenu {
+                    Repeater {
+                        model: drkApp.drkTicker.pairNames()
+                        MenuItem { text: modelData }
+                    }
+                }
+            }
+            ComboBox {
+                id: chartSpan
+                width: parent.width
+                label: qsTr("Range")
+                currentIndex: 1
+                menu: ContextMenu {
+                    MenuItem { text: qsTr("1 hour") }
+                    MenuItem { text: qsTr("1 day") }
+                    MenuItem { text: qsTr("1 week") }
+                    MenuItem { text: qsTr("1 month") }
+                    MenuItem { text: qsTr("1 year") }
+                }
+                onCurrentIndexChanged: chart.offset = 0
+            }
+            Label {
+                id: chartMaximum
+                text: chart.maximum
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+            }
+            PriceChart {
+                id: chart
+                width: parent.width
+                height: chartPage.height / 2
+                ticker: drkApp.drkTicker
+                pair: chartPair.value
+                span: chartPage.spans[chartSpan.currentIndex]
+                color: Theme.highlightColor
+                MouseArea {
+                    // dragging to the right goes back in time
+                    property real startX: 0
+                    property int startOffset: 0
+                    anchors.fill: parent
+                    preventStealing: true
+                    onPressed: {
+                        startX = mouse.x
+                        startOffset = chart.offset
+                    }
+                    onPositionChanged: {
+                        chart.offset = startOffset + (mouse.x - startX) * chart.span / chart.width
+                    }
+                }
+            }
+            Label {
+                id: chartMinimum
+                text: chart.minimum
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+            }
+            Label {
+                id: chartInfo
+                x: Theme.paddingMedium
+                text: chart.offset > 0 ? qsTr("Drag to pan, %1 points, %2 h back").arg(chart.points).arg(Math.round(chart.offset / 3600)) : qsTr("Drag to pan, %1 points, live").arg(chart.points)
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                wrapMode: Text.WordWrap
+                width: parent.width * 0.9
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+
+Page {
+    id: depthPage
+    property bool active: status === PageStatus.Active
+    function refresh() {
+        depthResult.text = drkApp.drkTicker.fillEstimate(depthMarket.value, parseFloat(depthAmount.text), depthBuy.checked)
+    }
+    onActiveChanged: {
+        if (active) {
+            drkApp.drkTicker.fetchBooks(depthMarket.value)
+        }
+    }
+    Timer {
+        id: depthTimer
+        interval: 1000
+        running: active && Qt.application.active
+        repeat: true
+        onTriggered: depthPage.refresh()
+    }
+    SilicaFlickable {
+        id: depthView
+        anchors.fill: parent
+        contentHeight: depthColumn.height
+        PullDownMenu {
+            MenuItem {
+                text: qsTr("Fetch Order Books")
+                onClicked: drkApp.drkTicker.fetchBooks(depthMarket.value)
+            }
+        }
+        Column {
+            id: depthColumn
+            x: Theme.paddingLarge
+            width: parent.width - 2 * Theme.paddingLarge
+            spacing: Theme.paddingMedium
+            PageHeader {
+                title: qsTr("Order Books")
+            }
+            ComboBox {
+                id: depthMarket
+                width: parent.width
+                label: qsTr("Market")
+                menu: ContextMenu {
+                    Repeater {
+                        model: drkApp.drkTicker.consensusMarkets()
+                        MenuItem { text: modelData }
+                    }
+                }
+                onValueChanged: {
+                    drkApp.drkTicker.fetchBooks(value)
+                    depthPage.refresh()
+                }
+            }
+            TextField {
+                id: depthAmount
+                width: parent.width * 0.9
+                horizontalAlignment: Text.AlignHCenter
+                text: "1"
+                label: qsTr("Order size in the first currency.")
+                validator: RegExpValidator { regExp: /^[0-9]{1,9}([.][0-9]{0,8})?$/ }
+                inputMethodHints: Qt.ImhFormattedNumbersOnly | Qt.ImhNoPredictiveText
+                onTextChanged: depthPage.refresh()
+            }
+            TextSwitch {
+                id: depthBuy
+                text: qsTr("Buy")
+                checked: true
+                description: "Walks the asks when buying, the bids when selling."
+                onCheckedChanged: depthPage.refresh()
+            }
+            Label {
+                id: depthResult
+                x: Theme.paddingMedium
+                color: Theme.highlightColor
+                font.pixelSize: Theme.fontSizeSmall
+                wrapMode: Text.WordWrap
+                width: parent.width * 0.9
+            }
+            Label {
+                id: depthInfo
+                x: Theme.paddingMedium
+                text: qsTr("Average fill price and slippage against the best level. Bitfinex books are not fetched.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                wrapMode: Text.WordWrap
+                width: parent.width * 0.9
+            }
+        }
+    }
+}
@@ -30,8 +30,11 @@ Page {
     property bool cloakEnabled: drkApp.drkTicker.isCloakEnabled()
     property bool xmrEnabled: drkApp.drkTicker.isXmrEnabled()
     property bool xcEnabled: drkApp.drkTicker.isXcEnabled()
+    property var configuredPairs: drkApp.drkTicker.configuredPairs()
+    property int configuredRevision: 0
     function refresh() {
         if (active && Qt.application.active) {
+            drkApp.drkTicker.beginRefresh()
             updateInterval = drkApp.drkTicker.updateInterval()
             offlineMode = drkApp.drkTicker.isOfflineMode()
             btcEnabled = drkApp.drkTicker.isBtcEnabled()
@@ -44,6 +47,7 @@ Page {
             firstBitfinexBtcUsd.text = drkApp.drkTicker.bitfinexBtcUsd()
             firstCryptsyBtcUsd.text = drkApp.drkTicker.cryptsyBtcUsd()
             firstPoloniexBtcUsd.text = drkApp.drkTicker.poloniexBtcUsd()
+            firstConsensusBtcUsd.text = drkApp.drkTicker.consensus("BTC", "USD")
             firstBitfinexDrkUsd.text = drkApp.drkTicker.bitfinexDrkUsd()
             firstBitfinexDrkBtc.text = drkApp.drkTicker.bitfinexDrkBtc()
             firstCryptsyDrkUsd.text = drkApp.drkTicker.cryptsyDrkUsd()
@@ -51,6 +55,7 @@ Page {
             firstCryptsyDrkLtc.text = drkApp.drkTicker.cryptsyDrkLtc()
             firstPoloniexDrkBtc.text = drkApp.drkTicker.poloniexDrkBtc()
             firstPoloniexDrkXmr.text = drkApp.drkTicker.poloniexDrkXmr()
+            firstConsensusDrkBtc.text = drkApp.drkTicker.consensus("DRK", "BTC")
             firstPoloniexBtcdBtc.text = drkApp.drkTicker.poloniexBtcdBtc()
             firstPoloniexBtcdXmr.text = drkApp.drkTicker.poloniexBtcdXmr()
             firstCryptsyAncBtc.text = drkApp.drkTicker.cryptsyAncBtc()
@@ -63,9 +68,11 @@ Page {
             firstCryptsyXcBtc.text = drkApp.drkTicker.cryptsyXcBtc()
             firstCryptsyXcLtc.text = drkApp.drkTicker.cryptsyXcLtc()
             firstPoloniexXcBtc.text = drkApp.drkTicker.poloniexXcBtc()
+            configuredRevision++
             if (!offlineMode && active) {
                 drkApp.drkTicker.update()
             }
+            drkApp.drkTicker.endRefresh()
         }
     }
     Timer {
@@ -88,6 +95,22 @@ Page {
                 text: qsTr("Settings")
                 onClicked: pageStack.push(Qt.resolvedUrl("settings.qml"))
             }
+            MenuItem {
+                text: qsTr("Portfolio")
+                onClicked: pageStack.push(Qt.resolvedUrl("portfolio.qml"))
+            }
+            MenuItem {
+                text: qsTr("Alerts")
+                onClicked: pageStack.push(Qt.resolvedUrl("alerts.qml"))
+            }
+            MenuItem {
+                text: qsTr("Chart")
+                onClicked: pageStack.push(Qt.resolvedUrl("chart.qml"))
+            }
+            MenuItem {
+                text: qsTr("Order Books")
+                onClicked: pageStack.push(Qt.resolvedUrl("depth.qml"))
+            }
             MenuItem {
                 text: offlineMode ? qsTr("Go Online") : qsTr("Refresh")
                 onClicked: {
@@ -185,6 +208,24 @@ Page {
                 x: 3 * Theme.paddingLarge
                 visible: btcEnabled
             }
+            Label {
+                id: firstConsensusBtc
+                text: qsTr("Consensus")
+                width: parent.width
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeSmall
+                visible: btcEnabled
+            }
+            Label {
+                id: firstConsensusBtcUsd
+                text: drkApp.drkTicker.consensus("BTC", "USD")
+                width: parent.width
+                color: Theme.highlightColor
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeLarge
+                x: 3 * Theme.paddingLarge
+                visible: btcEnabled
+            }
             Label {
                 id: firstHeadingDrk
                 text: qsTr("<br />Darkcoin")
@@ -300,6 +341,24 @@ Page {
                 x: 3 * Theme.paddingLarge
                 visible: drkEnabled
             }
+            Label {
+                id: firstConsensusDrk
+                text: qsTr("Consensus")
+                width: parent.width
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeSmall
+                visible: drkEnabled
+            }
+            Label {
+                id: firstConsensusDrkBtc
+                text: drkApp.drkTicker.consensus("DRK", "BTC")
+                width: parent.width
+                color: Theme.highlightColor
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeLarge
+                x: 3 * Theme.paddingLarge
+                visible: drkEnabled
+            }
             Label {
                 id: firstHeadingAnc
                 text: qsTr("<br />Anoncoin")
@@ -581,6 +640,28 @@ Page {
                 x: 3 * Theme.paddingLarge
                 visible: cloakEnabled
             }
+            Label {
+                id: firstHeadingConfigured
+                text: qsTr("<br />More Markets")
+                width: parent.width
+                color: Theme.secondaryHighlightColor
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeExtraLarge
+                visible: configuredPairs.length > 0
+            }
+            Repeater {
+                id: firstConfigured
+                model: configuredPairs
+                Label {
+                    // rebound on every refresh through the revision counter
+                    text: configuredRevision >= 0 ? drkApp.drkTicker.price(modelData) : ""
+                    width: parent.width
+                    color: Theme.highlightColor
+                    horizontalAlignment: Text.AlignLeft
+                    font.pixelSize: Theme.fontSizeMedium
+                    x: Theme.paddingLarge
+                }
+            }
             Label {
                 id: firstWarning
                 text: qsTr("<br />Heads up!")
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+
+Page {
+    id: memoryPage
+    function refresh() {
+        memoryText.text = drkApp.drkTicker.memoryReport()
+    }
+    Component.onCompleted: refresh()
+    Timer {
+        interval: 2000
+        running: memoryPage.status === PageStatus.Active && Qt.application.active
+        repeat: true
+        onTriggered: memoryPage.refresh()
+    }
+    SilicaFlickable {
+        id: memoryView
+        anchors.fill: parent
+        contentHeight: memoryColumn.height
+        Column {
+            id: memoryColumn
+            x: Theme.paddingLarge
+            width: parent.width - 2 * Theme.paddingLarge
+            spacing: Theme.paddingMedium
+            PageHeader {
+                title: qsTr("Memory")
+            }
+            Label {
+                id: memoryText
+                font.family: "monospace"
+                font.pixelSize: Theme.fontSizeExtraSmall
+                color: Theme.primaryColor
+                width: parent.width
+            }
+            Label {
+                text: qsTr("Live heap bytes and objects per subsystem, containers by capacity. Resident and peak are the whole process.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                wrapMode: Text.WordWrap
+                width: parent.width
+            }
+            VerticalScrollDecorator {
+                id: memoryScroll
+                flickable: memoryView
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.0
+import Sailfish.Silica 1.0
+
+Dialog {
+    id: portfolioPage
+    property bool active: status === PageStatus.Active
+    function refresh() {
+        if (active && Qt.application.active) {
+            portfolioBtc.text = drkApp.drkTicker.portfolioBtc()
+            portfolioUsd.text = drkApp.drkTicker.portfolioUsd()
+        }
+    }
+    Timer {
+        id: portfolioTimer
+        interval: 1000
+        running: active && Qt.application.active
+        repeat: true
+        onTriggered: portfolioPage.refresh()
+    }
+    SilicaFlickable {
+        id: portfolioView
+        anchors.fill: parent
+        contentHeight: portfolioColumn.height
+        Column {
+            id: portfolioColumn
+            anchors.centerIn: parent
+            x: Theme.paddingLarge
+            y: Theme.paddingMedium
+            width: parent.width - 2 * Theme.paddingLarge
+            spacing: Theme.paddingMedium
+            PageHeader {
+                title: qsTr("Portfolio")
+            }
+            Label {
+                id: portfolioTotal
+                x: Theme.paddingMedium
+                text: qsTr("Total Value")
+                color: Theme.highlightColor
+                font.pixelSize: Theme.fontSizeLarge
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            Label {
+                id: portfolioBtc
+                text: drkApp.drkTicker.portfolioBtc()
+                width: parent.width
+                color: Theme.highlightColor
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeLarge
+                x: 3 * Theme.paddingLarge
+            }
+            Label {
+                id: portfolioUsd
+                text: drkApp.drkTicker.portfolioUsd()
+                width: parent.width
+                color: Theme.highlightColor
+                horizontalAlignment: Text.AlignLeft
+                font.pixelSize: Theme.fontSizeLarge
+                x: 3 * Theme.paddingLarge
+            }
+            Label {
+                id: portfolioHoldings
+                x: Theme.paddingMedium
+                text: qsTr("Holdings")
+                color: Theme.highlightColor
+                font.pixelSize: Theme.fontSizeLarge
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            Label {
+                id: portfolioHoldingsText
+                x: Theme.paddingMedium
+                text: qsTr("Enter the amount of coins you own. Values are computed from the tickers already fetched.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            Repeater {
+                id: portfolioAssets
+                model: drkApp.drkTicker.portfolioAssets()
+                TextField {
+                    width: parent.width * 0.9
+                    horizontalAlignment: Text.AlignHCenter
+                    text: drkApp.drkTicker.holding(modelData)
+                    label: modelData
+                    validator: DoubleValidator { bottom: 0 }
+                    color: errorHighlight? "red" : Theme.primaryColor
+                    inputMethodHints: Qt.ImhFormattedNumbersOnly | Qt.ImhNoPredictiveText
+                }
+            }
+            VerticalScrollDecorator {
+                id: portfolioScroll
+                flickable: portfolioView
+            }
+        }
+    }
+    onDone: {
+          if (result === DialogResult.Accepted) {
+              for (var i = 0; i < portfolioAssets.count; i++) {
+                  var field = portfolioAssets.itemAt(i)
+                  drkApp.drkTicker.setHolding(field.label, Number(field.text))
+              }
+          }
+    }
+}
@@ -133,6 +133,72 @@ Dialog {
                 color: errorHighlight? "red" : Theme.primaryColor
                 inputMethodHints: Qt.ImhDigitsOnly | Qt.ImhNoPredictiveText
             }
+            Label {
+                id: settingsCellularText
+                x: Theme.paddingMedium
+                text: qsTr("Optionally use a larger interval on metered mobile data connections. Set to 0 to use the same interval as on WLAN.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            TextField {
+                id: settingsCellularTextField
+                width: parent.width * 0.9
+                horizontalAlignment: Text.AlignHCenter
+                text: drkApp.drkTicker.cellularInterval();
+                label: qsTr("Mobile data interval in minutes.")
+                validator: RegExpValidator { regExp: /^[0-9]{1,2}$/ }
+                color: errorHighlight? "red" : Theme.primaryColor
+                inputMethodHints: Qt.ImhDigitsOnly | Qt.ImhNoPredictiveText
+            }
+            Label {
+                id: settingsBudget
+                x: Theme.paddingMedium
+                text: qsTr("Data Budget")
+                color: Theme.highlightColor
+                font.pixelSize: Theme.fontSizeLarge
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            Label {
+                id: settingsBudgetText
+                x: Theme.paddingMedium
+                text: qsTr("Monthly mobile data budget in MB. From 75% of it the tickers refresh less often and disabled coins are no longer fetched, history is only loaded on WLAN. Set to 0 to disable.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            TextField {
+                id: settingsBudgetTextField
+                width: parent.width * 0.9
+                horizontalAlignment: Text.AlignHCenter
+                text: drkApp.drkTicker.dataBudget();
+                label: qsTr("Mobile data budget in MB.")
+                validator: RegExpValidator { regExp: /^[0-9]{1,5}$/ }
+                color: errorHighlight? "red" : Theme.primaryColor
+                inputMethodHints: Qt.ImhDigitsOnly | Qt.ImhNoPredictiveText
+            }
+            Repeater {
+                id: settingsBudgetUsage
+                model: drkApp.drkTicker.dataUsage()
+                Label {
+                    x: Theme.paddingMedium
+                    text: modelData
+                    color: Theme.secondaryColor
+                    font.pixelSize: Theme.fontSizeTiny
+                    horizontalAlignment: Text.AlignHLeft
+                    wrapMode: Text.WordWrap
+                    width: parent.width * 0.9
+                }
+            }
             Label {
                 id: settingsMode
                 x: Theme.paddingMedium
@@ -147,7 +213,7 @@ Dialog {
             Label {
                 id: settingsModeText
                 x: Theme.paddingMedium
-                text: qsTr("Toggle offline mode. During offline mode no tickers are refreshed. This saves bandwith and battery.")
+                text: qsTr("Refreshing pauses automatically while your device has no network connection. During offline mode no tickers are refreshed at all. This saves bandwith and battery.")
                 color: Theme.secondaryColor
                 font.pixelSize: Theme.fontSizeTiny
                 horizontalAlignment: Text.AlignHLeft
@@ -161,6 +227,99 @@ Dialog {
                 checked: drkApp.drkTicker.isOfflineMode()
                 description: "Enables the offline mode."
             }
+            Label {
+                id: settingsApi
+                x: Theme.paddingMedium
+                text: qsTr("Local API")
+                color: Theme.highlightColor
+                font.pixelSize: Theme.fontSizeLarge
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            Label {
+                id: settingsApiText
+                x: Theme.paddingMedium
+                text: qsTr("Serves the cached tickers as JSON to other apps on this device at http://localhost:<port>/snapshot. Set to 0 to disable.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            TextField {
+                id: settingsApiTextField
+                width: parent.width * 0.9
+                horizontalAlignment: Text.AlignHCenter
+                text: drkApp.drkTicker.apiPort();
+                label: qsTr("Port of the local API.")
+                validator: RegExpValidator { regExp: /^[0-9]{1,5}$/ }
+                color: errorHighlight? "red" : Theme.primaryColor
+                inputMethodHints: Qt.ImhDigitsOnly | Qt.ImhNoPredictiveText
+            }
+            Label {
+                id: settingsExport
+                x: Theme.paddingMedium
+                text: qsTr("Export History")
+                color: Theme.highlightColor
+                font.pixelSize: Theme.fontSizeLarge
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            Label {
+                id: settingsExportText
+                x: Theme.paddingMedium
+                text: qsTr("Writes all recorded prices of the last days to a file in your Documents folder. The export runs in the background.")
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                elide: Text.ElideMiddle
+                width: parent.width * 0.9
+            }
+            TextField {
+                id: settingsExportTextField
+                width: parent.width * 0.9
+                horizontalAlignment: Text.AlignHCenter
+                text: "30"
+                label: qsTr("Days to export.")
+                validator: RegExpValidator { regExp: /^[0-9]{1,4}$/ }
+                color: errorHighlight? "red" : Theme.primaryColor
+                inputMethodHints: Qt.ImhDigitsOnly | Qt.ImhNoPredictiveText
+            }
+            TextSwitch {
+                id: settingsExportJson
+                text: qsTr("JSON")
+                checked: false
+                description: "Exports newline-delimited JSON instead of CSV."
+            }
+            Button {
+                id: settingsExportButton
+                anchors.horizontalCenter: parent.horizontalCenter
+                text: qsTr("Export")
+                onClicked: {
+                    var file = drkApp.drkTicker.exportHistory(settingsExportTextField.text, settingsExportJson.checked);
+                    settingsExportStatus.text = file === "" ? qsTr("An export is already running.") : qsTr("Exporting to ") + file;
+                }
+            }
+            Label {
+                id: settingsExportStatus
+                x: Theme.paddingMedium
+                text: ""
+                color: Theme.secondaryColor
+                font.pixelSize: Theme.fontSizeTiny
+                horizontalAlignment: Text.AlignHLeft
+                wrapMode: Text.WordWrap
+                width: parent.width * 0.9
+            }
+            Connections {
+                target: drkApp.drkTicker
+                onExportFinished: settingsExportStatus.text = message
+            }
             VerticalScrollDecorator {
                 id: settingsScroll
                 flickable: settingsView
@@ -177,7 +336,10 @@ Dialog {
               drkApp.drkTicker.setXmrEnabled(settingsCoinsXmr.checked);
               drkApp.drkTicker.setXcEnabled(settingsCoinsXc.checked);
               drkApp.drkTicker.setUpdateInterval(settingsUpdateTextField.text);
+              drkApp.drkTicker.setCellularInterval(settingsCellularTextField.text);
+              drkApp.drkTicker.setDataBudget(settingsBudgetTextField.text);
               drkApp.drkTicker.setOfflineMode(settingsModeSwitch.checked);
+              drkApp.drkTicker.setApiPort(settingsApiTextField.text);
           }
     }
 }
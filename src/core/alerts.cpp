@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include "alerts.h"
+#include "symbols.h"
+#include "memoryreport.h"
+
+AlertEngine::AlertEngine(QObject *parent)
+    :   QObject(parent)
+    ,   m_nextId(1)
+    ,   m_index(Symbols::count())
+{
+}
+
+AlertEngine::~AlertEngine()
+{
+}
+
+int AlertEngine::addThreshold(int pair, bool above, const Price &threshold)
+{
+    Rule rule;
+    rule.type = above ? Above : Below;
+    rule.pair = pair;
+    rule.other = pair;
+    rule.threshold = threshold.rescaled(Symbols::info(pair).scale);
+    return insert(rule);
+}
+
+int AlertEngine::addPercentMove(int pair, double percent)
+{
+    Rule rule;
+    rule.type = PercentMove;
+    rule.pair = pair;
+    rule.other = pair;
+    rule.percent = fabs(percent);
+    rule.reference = m_index.at(pair).last;
+    return insert(rule);
+}
+
+int AlertEngine::addSpread(int pair, int other, double percent)
+{
+    // a spread between different assets means nothing
+    const PairInfo &first = Symbols::info(pair);
+    const PairInfo &second = Symbols::info(other);
+    if (pair == other || qstrcmp(first.base, second.base) != 0 || qstrcmp(first.quote, second.quote) != 0)
+    {
+        return 0;
+    }
+
+    Rule rule;
+    rule.type = Spread;
+    rule.pair = pair;
+    rule.other = other;
+    rule.percent = fabs(percent);
+    return insert(rule);
+}
+
+void AlertEngine::remove(int id)
+{
+    if (!m_rules.contains(id))
+    {
+        return;
+    }
+
+    Rule rule = m_rules.take(id);
+    PairIndex &index = m_index[rule.pair];
+    switch (rule.type)
+    {
+    case Above:
+        index.above.remove(rule.threshold.mantissa(), id);
+        break;
+    case Below:
+        index.below.remove(rule.threshold.mantissa(), id);
+        break;
+    case PercentMove:
+        index.moves.removeAll(id);
+        break;
+    case Spread:
+        index.spreads.removeAll(id);
+        m_index[rule.other].spreads.removeAll(id);
+        break;
+    }
+}
+
+void AlertEngine::clear()
+{
+    m_rules.clear();
+    for (int i = 0; i < m_index.size(); i++)
+    {
+        PairIndex &index = m_index[i];
+        index.above.clear();
+        index.below.clear();
+        index.moves.clear();
+        index.spreads.clear();
+    }
+}
+
+AlertEngine::Rule AlertEngine::rule(int id) const
+{
+    return m_rules.value(id);
+}
+
+QList<AlertEngine::Rule> AlertEngine::rules() const
+{
+    return m_rules.values();
+}
+
+int AlertEngine::count() const
+{
+    return m_rules.size();
+}
+
+void AlertEngine::add(int pair, const Price &price)
+{
+    PairIndex &index = m_index[pair];
+    qint64 current = price.mantissa();
+    QVector<Fired> fired;
+
+    if (index.hasLast)
+    {
+        qint64 previous = index.last.mantissa();
+        if (current > previous)
+        {
+            // rising: above rules with previous < threshold <= current
+            QMultiMap<qint64, int>::const_iterator it = index.above.upperBound(previous);
+            QMultiMap<qint64, int>::const_iterator end = index.above.upperBound(current);
+            for (; it != end; ++it)
+            {
+                Fired entry = { it.value(), pair, price };
+                fired.append(entry);
+            }
+        }
+        else if (current < previous)
+        {
+            // falling: below rules with current <= threshold < previous
+            QMultiMap<qint64, int>::const_iterator it = index.below.lowerBound(current);
+            QMultiMap<qint64, int>::const_iterator end = index.below.lowerBound(previous);
+            for (; it != end; ++it)
+            {
+                Fired entry = { it.value(), pair, price };
+                fired.append(entry);
+            }
+        }
+    }
+    index.last = price;
+    index.hasLast = true;
+
+    for (int i = 0; i < index.moves.size(); i++)
+    {
+        Rule &rule = m_rules[index.moves.at(i)];
+        if (!rule.reference.isValid())
+        {
+            rule.reference = price;
+            continue;
+        }
+        double reference = rule.reference.toDouble();
+        if (fabs(price.toDouble() - reference) / reference * 100.0 >= rule.percent)
+        {
+            rule.reference = price;
+            Fired entry = { rule.id, pair, price };
+            fired.append(entry);
+        }
+    }
+
+    for (int i = 0; i < index.spreads.size(); i++)
+    {
+        Rule &rule = m_rules[index.spreads.at(i)];
+        if (checkSpread(rule))
+        {
+            Fired entry = { rule.id, rule.pair, m_index.at(rule.pair).last };
+            fired.append(entry);
+        }
+    }
+
+    // receivers may change the rules, skip those removed meanwhile
+    for (int i = 0; i < fired.size(); i++)
+    {
+        if (m_rules.contains(fired.at(i).rule))
+        {
+            emit triggered(fired.at(i).rule, fired.at(i).pair, fired.at(i).price);
+        }
+    }
+}
+
+int AlertEngine::insert(Rule rule)
+{
+    rule.id = m_nextId++;
+    m_rules.insert(rule.id, rule);
+
+    PairIndex &index = m_index[rule.pair];
+    switch (rule.type)
+    {
+    case Above:
+        index.above.insert(rule.threshold.mantissa(), rule.id);
+        break;
+    case Below:
+        index.below.insert(rule.threshold.mantissa(), rule.id);
+        break;
+    case PercentMove:
+        index.moves.append(rule.id);
+        break;
+    case Spread:
+        index.spreads.append(rule.id);
+        m_index[rule.other].spreads.append(rule.id);
+        break;
+    }
+    return rule.id;
+}
+
+bool AlertEngine::checkSpread(Rule &rule)
+{
+    // true if the rule fires
+    const PairIndex &first = m_index.at(rule.pair);
+    const PairIndex &second = m_index.at(rule.other);
+    if (!first.hasLast || !second.hasLast || !first.last.isValid() || !second.last.isValid())
+    {
+        return false;
+    }
+
+    double a = first.last.toDouble();
+    double b = second.last.toDouble();
+    double spread = fabs(a - b) / qMin(a, b) * 100.0;
+    if (spread >= rule.percent)
+    {
+        if (rule.armed)
+        {
+            rule.armed = false;
+            return true;
+        }
+    }
+    else
+    {
+        rule.armed = true;
+    }
+    return false;
+}
+
+void AlertEngine::measure(MemoryReport &report) const
+{
+    // hash and map nodes hold their entry and a few links
+    report.add(MemoryReport::Prices, qint64(m_rules.size()) * (sizeof(int) + sizeof(Rule) + 2 * sizeof(void *)),
+               m_rules.size());
+    report.add(MemoryReport::Prices, m_index);
+    for (int pair = 0; pair < m_index.size(); pair++)
+    {
+        const PairIndex &index = m_index.at(pair);
+        int nodes = index.above.size() + index.below.size();
+        if (nodes > 0)
+        {
+            report.add(MemoryReport::Prices, qint64(nodes) * (sizeof(qint64) + sizeof(int) + 3 * sizeof(void *)), nodes);
+        }
+        int entries = index.moves.size() + index.spreads.size();
+        if (entries > 0)
+        {
+            report.add(MemoryReport::Prices, qint64(entries) * sizeof(void *));
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALERTS_H
+#define ALERTS_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QVector>
+
+#include "price.h"
+
+class MemoryReport;
+
+/*
+ * Price alerts evaluated incrementally on every quote. Rules are indexed by
+ * pair id, so a quote only looks at the rules of its own pair. Threshold
+ * rules sit in maps sorted by price, a crossing between the previous and the
+ * current quote is found with two binary searches regardless of how many
+ * rules exist.
+ *
+ * Fired rules are collected while the indexes are walked and only signalled
+ * afterwards, so a receiver may add or remove rules. Spread rules compare
+ * the same base and quote on two markets.
+ */
+class AlertEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Type {
+        Above,
+        Below,
+        PercentMove,
+        Spread
+    };
+
+    struct Rule
+    {
+        Rule()
+            :   id(0)
+            ,   type(Above)
+            ,   pair(0)
+            ,   other(0)
+            ,   percent(0.0)
+            ,   armed(true)
+        {
+        }
+
+        int id;
+        Type type;
+        int pair;
+        int other;          // second pair of spread rules
+        Price threshold;    // above and below rules
+        double percent;     // percent move and spread rules
+        Price reference;    // percent move rules
+        bool armed;         // spread rules fire once per excursion
+    };
+
+    explicit AlertEngine(QObject *parent = 0);
+    ~AlertEngine();
+
+    int addThreshold(int pair, bool above, const Price &threshold);
+    int addPercentMove(int pair, double percent);
+    int addSpread(int pair, int other, double percent);
+    void remove(int id);
+    void clear();
+
+    Rule rule(int id) const;
+    QList<Rule> rules() const;
+    int count() const;
+
+    void add(int pair, const Price &price);
+    void measure(MemoryReport &report) const;
+
+signals:
+    void triggered(int rule, int pair, const Price &price);
+
+private:
+    struct PairIndex
+    {
+        PairIndex()
+            :   hasLast(false)
+        {
+        }
+
+        QMultiMap<qint64, int> above;
+        QMultiMap<qint64, int> below;
+        QList<int> moves;
+        QList<int> spreads;
+        Price last;
+        bool hasLast;
+    };
+
+    struct Fired
+    {
+        int rule;
+        int pair;
+        Price price;
+    };
+
+    int insert(Rule rule);
+    bool checkSpread(Rule &rule);
+
+    int m_nextId;
+    QHash<int, Rule> m_rules;
+    QVector<PairIndex> m_index;
+};
+
+#endif // ALERTS_H
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QNetworkRequest>
+#include <QUrlQuery>
+#include <QtEndian>
+
+#include "backfill.h"
+#include "jsonscanner.h"
+#include "price.h"
+#include "symbols.h"
+#include "memoryreport.h"
+
+namespace {
+    static const char CHART[] = "https://poloniex.com/public";
+}
+
+Backfill::Backfill(TickLog *log, DataUsage *usage, QObject *parent)
+    :   QObject(parent)
+    ,   m_log(log)
+    ,   m_usage(usage)
+    ,   m_manager(this)
+    ,   m_baseUrl(QString(CHART))
+    ,   m_timer(this)
+    ,   m_completed(Symbols::count(), 0)
+    ,   m_progress(QString("backfill.dat"), RecordSize)
+    ,   m_running(false)
+    ,   m_complete(false)
+    ,   m_added(0)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(RequestInterval);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(next()));
+    connect(&m_manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onResult(QNetworkReply*)));
+    load();
+}
+
+Backfill::~Backfill()
+{
+}
+
+void Backfill::setBaseUrl(const QUrl &url)
+{
+    m_baseUrl = url;
+}
+
+QUrl Backfill::baseUrl() const
+{
+    return m_baseUrl;
+}
+
+bool Backfill::isRunning() const
+{
+    return m_running;
+}
+
+bool Backfill::isComplete() const
+{
+    return m_complete;
+}
+
+int Backfill::added() const
+{
+    return m_added;
+}
+
+uint Backfill::completed(int pair) const
+{
+    return m_completed.at(pair);
+}
+
+void Backfill::start(int days)
+{
+    run(days, false);
+}
+
+void Backfill::closeGaps()
+{
+    run(Days, true);
+}
+
+void Backfill::run(int days, bool live)
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    // only what is neither backfilled yet nor older than the horizon, up to
+    // where the live ticks of the pair take over
+    uint now = QDateTime::currentDateTime().toTime_t();
+    uint horizon = now - qMin(now, uint(qMax(days, 1)) * 86400u);
+    m_pages.clear();
+    for (int pair = Symbols::first(Exchange::Poloniex); pair <= Symbols::last(Exchange::Poloniex); pair++)
+    {
+        // pairs that are not polled are only filled when asked for
+        if (live && m_log->liveSince(pair) == 0)
+        {
+            continue;
+        }
+        uint until = m_log->liveSince(pair) > 0 ? m_log->liveSince(pair) : now;
+        uint start = qMax(qMax(horizon, m_completed.at(pair)), m_log->gapSince(pair));
+        for (uint from = start; from + MinGap < until; from += PageSeconds)
+        {
+            Page page;
+            page.pair = pair;
+            page.from = from;
+            page.to = qMin(from + uint(PageSeconds), until);
+            m_pages.append(page);
+        }
+    }
+
+    // nothing to fill, which is the usual case once a run went through
+    m_added = 0;
+    if (m_pages.isEmpty())
+    {
+        m_complete = true;
+        return;
+    }
+    m_running = true;
+    next();
+}
+
+void Backfill::cancel()
+{
+    // a running request finishes the run when its reply arrives
+    m_pages.clear();
+    if (m_timer.isActive())
+    {
+        m_timer.stop();
+        finish(false);
+    }
+}
+
+void Backfill::next()
+{
+    if (m_pages.isEmpty())
+    {
+        finish(true);
+        return;
+    }
+    if (m_usage->level() != DataUsage::Normal)
+    {
+        // history can wait for wifi or the next month, the next run resumes
+        m_pages.clear();
+        finish(false);
+        return;
+    }
+
+    const Page &page = m_pages.first();
+    QUrlQuery query;
+    query.addQueryItem("command", "returnChartData");
+    query.addQueryItem("currencyPair", QString(Symbols::info(page.pair).market));
+    query.addQueryItem("start", QString::number(page.from));
+    query.addQueryItem("end", QString::number(page.to));
+    query.addQueryItem("period", QString::number(int(Period)));
+    QUrl url(m_baseUrl);
+    url.setQuery(query);
+
+    QNetworkRequest request(url);
+    m_manager.get(request);
+}
+
+void Backfill::onResult(QNetworkReply *reply)
+{
+    m_usage->add(Exchange::Poloniex, reply);
+    reply->deleteLater();
+    if (m_pages.isEmpty())
+    {
+        // cancelled while the request was running
+        finish(false);
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError)
+    {
+        // the next run resumes with this page
+        m_pages.clear();
+        finish(false);
+        return;
+    }
+
+    Page page = m_pages.takeFirst();
+    int scale = Symbols::info(page.pair).scale;
+    QByteArray data = reply->readAll();
+    JsonScanner scanner(data.constData(), data.size());
+    JsonScanner::Token token;
+    QVector<Tick> ticks;
+    Tick tick;
+    tick.timestamp = 0;
+    tick.mantissa = 0;
+    while ((token = scanner.next()) != JsonScanner::End)
+    {
+        if (token == JsonScanner::BeginObject)
+        {
+            tick.timestamp = 0;
+            tick.mantissa = 0;
+        }
+        else if (token == JsonScanner::EndObject && scanner.depth() == 1)
+        {
+            // an empty range is answered with a single candle at date 0
+            if (tick.timestamp > 0 && tick.mantissa > 0)
+            {
+                ticks.append(tick);
+            }
+        }
+        else if (token == JsonScanner::Key && scanner.depth() == 2)
+        {
+            if (scanner.equals("date"))
+            {
+                scanner.next();
+                tick.timestamp = uint(Price::parse(scanner.begin(), scanner.end(), 0).mantissa());
+            }
+            else if (scanner.equals("close"))
+            {
+                scanner.next();
+                tick.mantissa = Price::parse(scanner.begin(), scanner.end(), scale).mantissa();
+            }
+            else
+            {
+                scanner.skipValue();
+            }
+        }
+    }
+
+    int added = m_log->merge(page.pair, ticks, Period / 2);
+    m_added += added;
+    store(page.pair, page.to);
+    emit progress(page.pair, page.to, added);
+
+    // stay well below the request limit of the exchange
+    m_timer.start();
+}
+
+void Backfill::load()
+{
+    // append-only progress log, the last record of a pair counts
+    char record[RecordSize];
+    for (qint64 i = 0; i < m_progress.count(); i++)
+    {
+        if (m_progress.read(i, record))
+        {
+            const uchar *data = reinterpret_cast<const uchar *>(record);
+            int pair = qFromLittleEndian<qint32>(data);
+            if (pair >= 0 && pair < Symbols::count())
+            {
+                m_completed[pair] = qFromLittleEndian<quint32>(data + 4);
+            }
+        }
+    }
+}
+
+void Backfill::store(int pair, uint until)
+{
+    uchar record[RecordSize];
+    qToLittleEndian<qint32>(pair, record);
+    qToLittleEndian<quint32>(until, record + 4);
+    m_progress.append(reinterpret_cast<const char *>(record));
+    m_completed[pair] = until;
+}
+
+void Backfill::finish(bool ok)
+{
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+    m_complete = ok;
+    emit finished(ok, m_added);
+}
+
+void Backfill::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Network, m_manager);
+    // pages are too large for a list slot, each is a node of its own
+    if (!m_pages.isEmpty())
+    {
+        report.add(MemoryReport::History, qint64(m_pages.size()) * (sizeof(Page) + sizeof(void *)), m_pages.size());
+    }
+    report.add(MemoryReport::History, m_completed);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKFILL_H
+#define BACKFILL_H
+
+#include <QObject>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+
+#include "datausage.h"
+#include "recordfile.h"
+#include "ticklog.h"
+
+class MemoryReport;
+
+/*
+ * Fills gaps in the tick log from the chart endpoint of the exchanges,
+ * currently Poloniex returnChartData for all PoloniEx pairs. The range is
+ * requested in pages of PageSeconds, one request per RequestInterval ms.
+ * The close of every candle is merged into the log as a tick, skipping
+ * candles next to an already known tick.
+ *
+ * Only the time before the live stretch of a pair (see TickLog::liveSince)
+ * is requested. closeGaps() covers just the polled pairs and finds nothing
+ * to do until a pause in polling leaves a new gap, so the core of the
+ * history writer calls it after every fetch cycle.
+ *
+ * Progress is stored per pair after every merged page, so an interrupted
+ * run resumes where it stopped. The base url can point to a local stand-in
+ * serving recorded responses (see tools/chartstub.py).
+ */
+class Backfill : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum {
+        Period = 300,
+        PageSeconds = 7 * 86400,
+        RequestInterval = 1000,
+        MinGap = 3600,
+        Days = 30,
+        RecordSize = 8
+    };
+
+    Backfill(TickLog *log, DataUsage *usage, QObject *parent = 0);
+    ~Backfill();
+
+    void setBaseUrl(const QUrl &url);
+    QUrl baseUrl() const;
+    bool isRunning() const;
+    bool isComplete() const;
+    int added() const;
+    uint completed(int pair) const;
+    void measure(MemoryReport &report) const;
+
+public slots:
+    void start(int days = Days);
+    void closeGaps();
+    void cancel();
+
+signals:
+    void progress(int pair, uint until, int added);
+    void finished(bool ok, int added);
+
+private slots:
+    void next();
+    void onResult(QNetworkReply *reply);
+
+private:
+    struct Page
+    {
+        int pair;
+        uint from;
+        uint to;
+    };
+
+    void run(int days, bool live);
+    void load();
+    void store(int pair, uint until);
+    void finish(bool ok);
+
+    TickLog *m_log;
+    DataUsage *m_usage;
+    QNetworkAccessManager m_manager;
+    QUrl m_baseUrl;
+    QTimer m_timer;
+    QList<Page> m_pages;
+    QVector<uint> m_completed;
+    RecordFile m_progress;
+    bool m_running;
+    bool m_complete;
+    int m_added;
+};
+
+#endif // BACKFILL_H
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QByteArray>
+#include <QUrl>
+#include <QDateTime>
+
+#include "bitfinex.h"
+#include "jsonscanner.h"
+#include "trace.h"
+#include "memoryreport.h"
+
+namespace {
+    static const QString PUBTICKER = "https://api.bitfinex.com/v1/pubticker/";
+
+    struct FieldKey
+    {
+        const char *key;
+        PriceTable::Field field;
+    };
+
+    static const FieldKey FIELDS[] = {
+        { "ask", PriceTable::Ask },
+        { "last_price", PriceTable::Last },
+        { "high", PriceTable::High },
+        { "low", PriceTable::Low },
+        { "volume", PriceTable::Volume }
+    };
+
+    static const int FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+}
+
+BitFinex::BitFinex(PriceTable *prices, DataUsage *usage, QObject *parent)
+    :   QObject(parent)
+    ,   m_prices(prices)
+    ,   m_usage(usage)
+    ,   m_manager(this)
+{
+    connect(&m_manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onResult(QNetworkReply*)));
+}
+
+BitFinex::~BitFinex()
+{
+}
+
+bool BitFinex::fetch()
+{
+    if (!m_breaker.allowRequest(QDateTime::currentDateTime().toTime_t()))
+    {
+        return false;
+    }
+
+    // a half-open breaker only lets a single probe through
+    int first = Symbols::first(Exchange::Bitfinex);
+    int last = Symbols::last(Exchange::Bitfinex);
+    if (m_breaker.state() == CircuitBreaker::HalfOpen)
+    {
+        last = first;
+    }
+
+    // near the data budget low-priority pairs wait, a probe always goes out
+    bool probe = m_breaker.state() == CircuitBreaker::HalfOpen;
+    int sent = 0;
+    for (int pair = first; pair <= last; pair++)
+    {
+        if (!probe && m_usage->skips(pair))
+        {
+            continue;
+        }
+        QNetworkRequest request;
+        request.setUrl(QUrl(QString(PUBTICKER).append(Symbols::info(pair).market)));
+        request.setAttribute(QNetworkRequest::User, pair);
+        Trace::stamp(request);
+        m_manager.get(request);
+        m_breaker.requestStarted();
+        sent++;
+    }
+    return sent > 0;
+}
+
+void BitFinex::onResult(QNetworkReply* reply)
+{
+    int pair = reply->request().attribute(QNetworkRequest::User).toInt();
+    Trace::finished(reply, "bitfinex", "request");
+    m_usage->add(Exchange::Bitfinex, reply);
+
+    Price tmp;
+    Price fields[PriceTable::FieldCount];
+    bool found[PriceTable::FieldCount] = { false };
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        TRACE_SCOPE("bitfinex", "parse");
+        QByteArray data = reply->readAll();
+        JsonScanner scanner(data.constData(), data.size());
+        JsonScanner::Token token;
+        while ((token = scanner.next()) != JsonScanner::End)
+        {
+            if (token != JsonScanner::Key || scanner.depth() != 1)
+            {
+                continue;
+            }
+            if (scanner.equals("bid"))
+            {
+                scanner.next();
+                tmp = Price::parse(scanner.begin(), scanner.end(), Symbols::info(pair).scale);
+                continue;
+            }
+            for (int i = 0; i < FIELD_COUNT; i++)
+            {
+                if (scanner.equals(FIELDS[i].key))
+                {
+                    PriceTable::Field field = FIELDS[i].field;
+                    scanner.next();
+                    fields[field] = Price::parse(scanner.begin(), scanner.end(),
+                                                 PriceTable::scale(pair, field), &found[field]);
+                    break;
+                }
+            }
+        }
+    }
+    reply->deleteLater();
+
+    TRACE_SCOPE("bitfinex", "store");
+    uint now = QDateTime::currentDateTime().toTime_t();
+    if (tmp.isValid())
+    {
+        for (int field = PriceTable::Ask; field < PriceTable::FieldCount; field++)
+        {
+            if (found[field])
+            {
+                m_prices->setField(pair, PriceTable::Field(field), fields[field]);
+            }
+        }
+        m_prices->quote(pair).update(tmp, now);
+        emit quoteUpdated(pair);
+    }
+    else
+    {
+        m_prices->quote(pair).fail();
+    }
+    m_breaker.requestFinished(tmp.isValid(), now);
+    if (m_breaker.pending() == 0)
+    {
+        emit fetched();
+    }
+}
+
+void BitFinex::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Network, m_manager);
+}
@@ -15,38 +15,43 @@
  * this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef BITFINEX_H
+#define BITFINEX_H
+
 #include <QObject>
 #include <QNetworkAccessManager>
 
+#include "pricetable.h"
+#include "circuitbreaker.h"
+#include "datausage.h"
+
+class MemoryReport;
+
 class BitFinex : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit BitFinex(QObject *parent = 0);
+    BitFinex(PriceTable *prices, DataUsage *usage, QObject *parent = 0);
     ~BitFinex();
 
-    double getBtcUsd();
-    double getDrkUsd();
-    double getDrkBtc();
+    bool fetch();
+    void measure(MemoryReport &report) const;
 
-    void fetch();
+signals:
+    void quoteUpdated(int pair);
+    void fetched();
 
 public slots:
-    void onBtcUsdResult(QNetworkReply* reply);
-    void onDrkUsdResult(QNetworkReply* reply);
-    void onDrkBtcResult(QNetworkReply* reply);
-
-protected:
-    double updatePair(QNetworkReply* reply);
+    void onResult(QNetworkReply* reply);
 
 private:
-    double m_pairBtcUsd;
-    double m_pairDrkUsd;
-    double m_pairDrkBtc;
+    PriceTable *m_prices;
+    DataUsage *m_usage;
+    CircuitBreaker m_breaker;
 
-    QNetworkAccessManager m_btcUsdManager;
-    QNetworkAccessManager m_drkUsdManager;
-    QNetworkAccessManager m_drkBtcManager;
+    QNetworkAccessManager m_manager;
 
 };
+
+#endif // BITFINEX_H
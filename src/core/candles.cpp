@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDir>
+#include <QtEndian>
+
+#include "candles.h"
+#include "symbols.h"
+#include "memoryreport.h"
+
+namespace {
+    static const uint SECONDS[CandleAggregator::ResolutionCount] = {
+        60,
+        15 * 60,
+        60 * 60,
+        24 * 60 * 60
+    };
+
+    static const char *NAMES[CandleAggregator::ResolutionCount] = {
+        "minute",
+        "quarter",
+        "hour",
+        "day"
+    };
+
+    // record layout, little endian, the file names pair and resolution:
+    // start (4), open, high, low, close (8 each)
+    void encode(uchar *record, const Candle &candle)
+    {
+        qToLittleEndian<quint32>(candle.start, record);
+        qToLittleEndian<qint64>(candle.open, record + 4);
+        qToLittleEndian<qint64>(candle.high, record + 12);
+        qToLittleEndian<qint64>(candle.low, record + 20);
+        qToLittleEndian<qint64>(candle.close, record + 28);
+    }
+
+    void decode(const uchar *record, Candle &candle)
+    {
+        candle.start = qFromLittleEndian<quint32>(record);
+        candle.open = qFromLittleEndian<qint64>(record + 4);
+        candle.high = qFromLittleEndian<qint64>(record + 12);
+        candle.low = qFromLittleEndian<qint64>(record + 20);
+        candle.close = qFromLittleEndian<qint64>(record + 28);
+    }
+}
+
+CandleAggregator::CandleAggregator(const QString &directory)
+    :   m_directory(directory)
+    ,   m_current(Symbols::count() * ResolutionCount)
+    ,   m_files(Symbols::count() * ResolutionCount, 0)
+{
+    QDir().mkpath(RecordFile::dataPath(directory));
+}
+
+CandleAggregator::~CandleAggregator()
+{
+    flush();
+    qDeleteAll(m_files);
+}
+
+void CandleAggregator::add(int pair, const Price &price, uint timestamp)
+{
+    qint64 value = price.mantissa();
+    Candle *candles = m_current.data() + pair * ResolutionCount;
+    for (int resolution = 0; resolution < ResolutionCount; resolution++)
+    {
+        Candle &candle = candles[resolution];
+        uint start = timestamp - timestamp % SECONDS[resolution];
+        if (start < candle.start)
+        {
+            // late tick of an already finished candle
+            continue;
+        }
+        if (start > candle.start)
+        {
+            if (candle.start > 0)
+            {
+                store(pair, resolution, candle);
+            }
+            candle.start = start;
+            candle.open = candle.high = candle.low = candle.close = value;
+            continue;
+        }
+        candle.high = qMax(candle.high, value);
+        candle.low = qMin(candle.low, value);
+        candle.close = value;
+    }
+}
+
+void CandleAggregator::flush()
+{
+    for (int i = 0; i < m_current.size(); i++)
+    {
+        if (m_current.at(i).start > 0)
+        {
+            store(i / ResolutionCount, i % ResolutionCount, m_current.at(i));
+            m_current[i] = Candle();
+        }
+    }
+}
+
+const Candle &CandleAggregator::current(int pair, int resolution) const
+{
+    return m_current.at(pair * ResolutionCount + resolution);
+}
+
+QVector<Candle> CandleAggregator::history(int pair, int resolution, uint from, uint to)
+{
+    // the newest MaxHistory candles of the range at most
+    QVector<Candle> candles;
+    uint span = (MaxHistory - 1) * SECONDS[resolution];
+    from = qMax(from, to - qMin(to, span));
+    if (from > to)
+    {
+        return candles;
+    }
+
+    RecordFile *records = file(pair, resolution);
+    uchar record[RecordSize];
+    Candle candle;
+
+    // first record starting at from or later
+    qint64 low = 0;
+    qint64 high = records->count();
+    while (low < high)
+    {
+        qint64 middle = low + (high - low) / 2;
+        if (!records->read(middle, reinterpret_cast<char *>(record)))
+        {
+            return candles;
+        }
+        decode(record, candle);
+        if (candle.start < from)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    qint64 count = records->count();
+    for (qint64 i = low; i < count; i++)
+    {
+        if (!records->read(i, reinterpret_cast<char *>(record)))
+        {
+            break;
+        }
+        decode(record, candle);
+        if (candle.start > to)
+        {
+            break;
+        }
+        if (!candles.isEmpty() && candles.last().start == candle.start)
+        {
+            // the rest of a candle flushed while it was open
+            Candle &merged = candles.last();
+            merged.high = qMax(merged.high, candle.high);
+            merged.low = qMin(merged.low, candle.low);
+            merged.close = candle.close;
+            continue;
+        }
+        candles.append(candle);
+    }
+    return candles;
+}
+
+uint CandleAggregator::seconds(int resolution)
+{
+    return SECONDS[resolution];
+}
+
+RecordFile *CandleAggregator::file(int pair, int resolution)
+{
+    RecordFile *&records = m_files[pair * ResolutionCount + resolution];
+    if (!records)
+    {
+        QString name = QString("%1/%2-%3.dat").arg(m_directory).arg(Symbols::info(pair).name).arg(NAMES[resolution]);
+        records = new RecordFile(name, RecordSize);
+    }
+    return records;
+}
+
+void CandleAggregator::store(int pair, int resolution, const Candle &candle)
+{
+    uchar record[RecordSize];
+    encode(record, candle);
+    file(pair, resolution)->append(reinterpret_cast<const char *>(record));
+}
+
+void CandleAggregator::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::History, m_current);
+    report.add(MemoryReport::History, m_files);
+    for (int i = 0; i < m_files.size(); i++)
+    {
+        if (m_files.at(i))
+        {
+            report.add(MemoryReport::History, sizeof(RecordFile));
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CANDLES_H
+#define CANDLES_H
+
+#include <QString>
+#include <QVector>
+
+#include "price.h"
+#include "recordfile.h"
+
+class MemoryReport;
+
+struct Candle
+{
+    Candle()
+        :   start(0)
+        ,   open(0)
+        ,   high(0)
+        ,   low(0)
+        ,   close(0)
+    {
+    }
+
+    // prices are mantissas in the scale of the pair
+    uint start;
+    qint64 open;
+    qint64 high;
+    qint64 low;
+    qint64 close;
+};
+
+/*
+ * Folds every new quote into open/high/low/close candles of several
+ * resolutions. Open candles live in a preallocated table indexed by pair and
+ * resolution, so a tick costs O(1). Finished candles are appended to a
+ * compact record file per pair and resolution in candles/, which keeps its
+ * records in time order; history() finds the start of a range by bisection
+ * and returns at most MaxHistory candles.
+ *
+ * flush() also appends the open candles, e.g. at shutdown, and starts them
+ * over. A candle may so be stored in parts; history() merges the records of
+ * the same start, the first one keeping its open and the last its close.
+ */
+class CandleAggregator
+{
+public:
+    enum Resolution {
+        Minute,
+        Quarter,
+        Hour,
+        Day,
+        ResolutionCount
+    };
+
+    enum {
+        RecordSize = 36,
+        MaxHistory = 1000
+    };
+
+    explicit CandleAggregator(const QString &directory = QString("candles"));
+    ~CandleAggregator();
+
+    void add(int pair, const Price &price, uint timestamp);
+    void flush();
+    const Candle &current(int pair, int resolution) const;
+    QVector<Candle> history(int pair, int resolution, uint from, uint to);
+    void measure(MemoryReport &report) const;
+
+    static uint seconds(int resolution);
+
+private:
+    RecordFile *file(int pair, int resolution);
+    void store(int pair, int resolution, const Candle &candle);
+
+    QString m_directory;
+    QVector<Candle> m_current;
+    QVector<RecordFile *> m_files;      // opened on first use
+};
+
+#endif // CANDLES_H
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <qmath.h>
+
+#include "chartcache.h"
+#include "price.h"
+#include "symbols.h"
+#include "memoryreport.h"
+
+ChartCache::ChartCache(const TickLog *log, int maxTiles)
+    :   m_log(log)
+    ,   m_tiles(maxTiles)
+    ,   m_recent(Symbols::count(), Ring<Tick>(RecentTicks))
+{
+}
+
+void ChartCache::add(int pair, qint64 mantissa, uint timestamp)
+{
+    Ring<Tick> &recent = m_recent[pair];
+    if (recent.size() == RecentTicks)
+    {
+        recent.removeFirst();
+    }
+    Tick tick;
+    tick.timestamp = timestamp;
+    tick.mantissa = mantissa;
+    recent.append(tick);
+}
+
+QVector<ChartPoint> ChartCache::series(int pair, uint from, uint to, int width)
+{
+    QVector<ChartPoint> points;
+    if (to <= from || width <= 0)
+    {
+        return points;
+    }
+
+    int zoom = level(from, to, width);
+    quint64 span = quint64(TileBuckets) * (quint64(BaseBucket) << zoom);
+    points.reserve(width + 2 * TileBuckets);
+    for (quint64 index = from / span; index <= to / span; index++)
+    {
+        QVector<ChartPoint> part = tile(pair, zoom, index);
+        for (int i = 0; i < part.size(); i++)
+        {
+            if (part.at(i).time >= from && part.at(i).time <= to)
+            {
+                points.append(part.at(i));
+            }
+        }
+    }
+    return points;
+}
+
+void ChartCache::clear()
+{
+    m_tiles.clear();
+}
+
+int ChartCache::level(uint from, uint to, int width)
+{
+    // coarsest bucket still finer than a pixel
+    quint64 perPixel = (quint64(to - from) + width - 1) / width;
+    int zoom = 0;
+    while (zoom < Levels - 1 && (quint64(BaseBucket) << (zoom + 1)) <= perPixel)
+    {
+        zoom++;
+    }
+    return zoom;
+}
+
+QVector<ChartPoint> ChartCache::lttb(const QVector<ChartPoint> &points, int threshold)
+{
+    int count = points.size();
+    if (threshold >= count || threshold < 3)
+    {
+        return points;
+    }
+
+    QVector<ChartPoint> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points.first());
+
+    // x relative to the first point keeps the areas precise
+    double origin = points.first().time;
+    double every = double(count - 2) / double(threshold - 2);
+    int a = 0;
+    for (int i = 0; i < threshold - 2; i++)
+    {
+        int averageStart = int(qFloor((i + 1) * every)) + 1;
+        int averageEnd = qMin(int(qFloor((i + 2) * every)) + 1, count);
+        double averageX = 0.0;
+        double averageY = 0.0;
+        for (int j = averageStart; j < averageEnd; j++)
+        {
+            averageX += points.at(j).time - origin;
+            averageY += points.at(j).value;
+        }
+        int averageLength = qMax(averageEnd - averageStart, 1);
+        averageX /= averageLength;
+        averageY /= averageLength;
+
+        int rangeStart = int(qFloor(i * every)) + 1;
+        int rangeEnd = int(qFloor((i + 1) * every)) + 1;
+        double ax = points.at(a).time - origin;
+        double ay = points.at(a).value;
+        double maxArea = -1.0;
+        int next = rangeStart;
+        for (int j = rangeStart; j < rangeEnd; j++)
+        {
+            double area = qAbs((ax - averageX) * (points.at(j).value - ay)
+                               - (ax - (points.at(j).time - origin)) * (averageY - ay));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                next = j;
+            }
+        }
+        sampled.append(points.at(next));
+        a = next;
+    }
+
+    sampled.append(points.last());
+    return sampled;
+}
+
+QVector<ChartPoint> ChartCache::tile(int pair, int level, quint64 index)
+{
+    quint64 key = (quint64(pair) << 56) | (quint64(level) << 48) | index;
+    if (QVector<ChartPoint> *cached = m_tiles.object(key))
+    {
+        return *cached;
+    }
+
+    quint64 span = quint64(TileBuckets) * (quint64(BaseBucket) << level);
+    quint64 last = qMin(index * span + span - 1, quint64(0xffffffffu));
+    uint from = uint(qMin(index * span, last));
+    uint to = uint(last);
+    uint current = now(pair);
+    if (from > current)
+    {
+        return QVector<ChartPoint>();
+    }
+
+    // a tile is final once the log surely holds all of its ticks, it is
+    // read once; the live edge is merged from the finer tiles below it
+    bool sealed = current > to && current - to > uint(TickLog::FlushInterval);
+    QVector<ChartPoint> points;
+    if (sealed || level == 0)
+    {
+        points = read(pair, from, to);
+    }
+    else
+    {
+        points = tile(pair, level - 1, index * 2);
+        points += tile(pair, level - 1, index * 2 + 1);
+    }
+
+    QVector<ChartPoint> sampled = lttb(points, TileBuckets);
+    if (sealed)
+    {
+        m_tiles.insert(key, new QVector<ChartPoint>(sampled));
+    }
+    return sampled;
+}
+
+QVector<ChartPoint> ChartCache::read(int pair, uint from, uint to) const
+{
+    int scale = Symbols::info(pair).scale;
+    QVector<ChartPoint> points;
+    ChartPoint point;
+    uint logged = 0;
+    TickCursor cursor(m_log, pair, from, to);
+    Tick tick;
+    while (cursor.next(tick))
+    {
+        point.time = tick.timestamp;
+        point.value = Price(tick.mantissa, scale).toDouble();
+        points.append(point);
+        logged = qMax(logged, tick.timestamp);
+    }
+
+    // ticks not in the log yet
+    const Ring<Tick> &recent = m_recent.at(pair);
+    for (int i = 0; i < recent.size(); i++)
+    {
+        const Tick &current = recent.at(i);
+        if (current.timestamp > logged && current.timestamp >= from && current.timestamp <= to)
+        {
+            point.time = current.timestamp;
+            point.value = Price(current.mantissa, scale).toDouble();
+            points.append(point);
+        }
+    }
+    return points;
+}
+
+uint ChartCache::now(int pair) const
+{
+    uint now = QDateTime::currentDateTime().toTime_t();
+    const Ring<Tick> &recent = m_recent.at(pair);
+    if (!recent.isEmpty())
+    {
+        now = qMax(now, recent.last().timestamp);
+    }
+    return now;
+}
+
+void ChartCache::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::History, m_recent);
+    for (int pair = 0; pair < m_recent.size(); pair++)
+    {
+        report.add(MemoryReport::History, m_recent.at(pair));
+    }
+    // looking a tile up refreshes its place in the cache, only a debugging
+    // aid is allowed to do that to all of them
+    QList<quint64> keys = m_tiles.keys();
+    for (int i = 0; i < keys.size(); i++)
+    {
+        const QVector<ChartPoint> *tile = m_tiles.object(keys.at(i));
+        report.add(MemoryReport::History, sizeof(QVector<ChartPoint>));
+        report.add(MemoryReport::History, *tile);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHARTCACHE_H
+#define CHARTCACHE_H
+
+#include <QCache>
+#include <QVector>
+
+#include "ring.h"
+#include "ticklog.h"
+
+class MemoryReport;
+
+struct ChartPoint
+{
+    uint time;
+    double value;
+};
+
+/*
+ * Downsampled price series for charts. A view of any range is mapped to a
+ * zoom level whose bucket covers about one pixel, and every level is split
+ * into tiles of TileBuckets buckets. A tile is built once from the tick log
+ * with Largest-Triangle-Three-Buckets and kept in an LRU cache, so zooming
+ * back and panning only read the ticks of tiles not seen before.
+ *
+ * The newest ticks of every pair are also kept in memory: they fill the
+ * tiles at the live edge, which are never cached while the log may still be
+ * missing some of their ticks. A live tile above level 0 is merged from its
+ * two finer tiles instead, the older of which is usually sealed and cached,
+ * so a new quote only rebuilds one small tile per level.
+ */
+class ChartCache
+{
+public:
+    enum {
+        BaseBucket = 60,
+        TileBuckets = 256,
+        Levels = 16,
+        RecentTicks = 1024
+    };
+
+    explicit ChartCache(const TickLog *log, int maxTiles = 128);
+
+    void add(int pair, qint64 mantissa, uint timestamp);
+    QVector<ChartPoint> series(int pair, uint from, uint to, int width);
+    void clear();
+    void measure(MemoryReport &report) const;
+
+    static int level(uint from, uint to, int width);
+    static QVector<ChartPoint> lttb(const QVector<ChartPoint> &points, int threshold);
+
+private:
+    QVector<ChartPoint> tile(int pair, int level, quint64 index);
+    QVector<ChartPoint> read(int pair, uint from, uint to) const;
+    uint now(int pair) const;
+
+    const TickLog *m_log;
+    QCache<quint64, QVector<ChartPoint> > m_tiles;
+    QVector<Ring<Tick> > m_recent;
+};
+
+#endif // CHARTCACHE_H
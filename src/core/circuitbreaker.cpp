@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "circuitbreaker.h"
+
+CircuitBreaker::CircuitBreaker(int threshold, uint cooldown, uint maxCooldown)
+    :   m_state(Closed)
+    ,   m_threshold(threshold)
+    ,   m_failures(0)
+    ,   m_pending(0)
+    ,   m_cycleSuccess(false)
+    ,   m_cooldown(cooldown)
+    ,   m_baseCooldown(cooldown)
+    ,   m_maxCooldown(maxCooldown)
+    ,   m_openedAt(0)
+{
+}
+
+bool CircuitBreaker::allowRequest(uint now)
+{
+    switch (m_state)
+    {
+    case Closed:
+        return true;
+    case Open:
+        if (now >= m_openedAt + m_cooldown)
+        {
+            m_state = HalfOpen;
+            return true;
+        }
+        return false;
+    case HalfOpen:
+        // only one probe at a time
+        return m_pending == 0;
+    }
+    return false;
+}
+
+void CircuitBreaker::requestStarted()
+{
+    if (m_pending == 0)
+    {
+        m_cycleSuccess = false;
+    }
+    m_pending++;
+}
+
+void CircuitBreaker::requestFinished(bool success, uint now)
+{
+    if (success)
+    {
+        m_cycleSuccess = true;
+    }
+    if (m_pending > 0)
+    {
+        m_pending--;
+    }
+    if (m_pending == 0)
+    {
+        cycleFinished(m_cycleSuccess, now);
+    }
+}
+
+CircuitBreaker::State CircuitBreaker::state() const
+{
+    return m_state;
+}
+
+int CircuitBreaker::pending() const
+{
+    return m_pending;
+}
+
+void CircuitBreaker::cycleFinished(bool success, uint now)
+{
+    if (success)
+    {
+        m_state = Closed;
+        m_failures = 0;
+        m_cooldown = m_baseCooldown;
+        return;
+    }
+
+    if (m_state == HalfOpen)
+    {
+        m_cooldown = qMin(m_cooldown * 2, m_maxCooldown);
+        m_state = Open;
+        m_openedAt = now;
+        return;
+    }
+
+    m_failures++;
+    if (m_failures >= m_threshold)
+    {
+        m_state = Open;
+        m_openedAt = now;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#include <QtGlobal>
+
+/*
+ * Per-exchange circuit breaker. A fetch cycle (all requests sent by one call
+ * to fetch()) fails if none of its replies carried a usable rate. After a
+ * number of failed cycles the breaker opens and the exchange is not polled
+ * anymore until the cooldown expired. Then a single half-open probe request
+ * is let through; success closes the breaker, failure opens it again with a
+ * doubled cooldown.
+ */
+class CircuitBreaker
+{
+public:
+    enum State {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    explicit CircuitBreaker(int threshold = 3, uint cooldown = 120, uint maxCooldown = 3600);
+
+    bool allowRequest(uint now);
+    void requestStarted();
+    void requestFinished(bool success, uint now);
+
+    State state() const;
+    int pending() const;
+
+private:
+    void cycleFinished(bool success, uint now);
+
+    State m_state;
+    int m_threshold;
+    int m_failures;
+    int m_pending;
+    bool m_cycleSuccess;
+    uint m_cooldown;
+    uint m_baseCooldown;
+    uint m_maxCooldown;
+    uint m_openedAt;
+};
+
+#endif // CIRCUITBREAKER_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QByteArray>
+#include <QUrl>
+#include <QDateTime>
+
+#include "configexchange.h"
+#include "trace.h"
+#include "memoryreport.h"
+
+namespace {
+    static const char MARKET[] = "{market}";
+}
+
+ConfigExchange::ConfigExchange(const ExchangeConfig::Definition &definition, PriceTable *prices, DataUsage *usage, QObject *parent)
+    :   QObject(parent)
+    ,   m_definition(definition)
+    ,   m_prices(prices)
+    ,   m_usage(usage)
+    ,   m_manager(this)
+{
+    // per-market replies use the field as value slot, shared replies
+    // market * FieldCount + field
+    bool shared = !m_definition.perMarket();
+    int markets = shared ? m_definition.markets.size() : 1;
+    for (int market = 0; market < markets; market++)
+    {
+        for (int field = 0; field < PriceTable::FieldCount; field++)
+        {
+            QByteArray path = m_definition.paths[field];
+            if (path.isEmpty())
+            {
+                continue;
+            }
+            if (shared)
+            {
+                path.replace(MARKET, m_definition.markets.at(market).key);
+            }
+            m_matcher.add(path, market * PriceTable::FieldCount + field);
+        }
+    }
+    // every market reads all of its slots, not only the configured ones
+    m_values.resize(markets * PriceTable::FieldCount);
+
+    connect(&m_manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onResult(QNetworkReply*)));
+}
+
+ConfigExchange::~ConfigExchange()
+{
+}
+
+bool ConfigExchange::fetch()
+{
+    if (m_definition.markets.isEmpty() || !m_breaker.allowRequest(QDateTime::currentDateTime().toTime_t()))
+    {
+        return false;
+    }
+
+    if (!m_definition.perMarket())
+    {
+        QNetworkRequest request;
+        request.setUrl(QUrl(m_definition.url));
+        request.setAttribute(QNetworkRequest::User, -1);
+        Trace::stamp(request);
+        m_manager.get(request);
+        m_breaker.requestStarted();
+        return true;
+    }
+
+    // a half-open breaker only lets a single probe through, near the data
+    // budget low-priority markets wait
+    bool probe = m_breaker.state() == CircuitBreaker::HalfOpen;
+    int last = probe ? 0 : m_definition.markets.size() - 1;
+    int sent = 0;
+    for (int market = 0; market <= last; market++)
+    {
+        if (!probe && m_usage->skips(m_definition.markets.at(market).pair))
+        {
+            continue;
+        }
+        QString url = m_definition.url;
+        url.replace(MARKET, QString::fromLatin1(m_definition.markets.at(market).key));
+        QNetworkRequest request;
+        request.setUrl(QUrl(url));
+        request.setAttribute(QNetworkRequest::User, market);
+        Trace::stamp(request);
+        m_manager.get(request);
+        m_breaker.requestStarted();
+        sent++;
+    }
+    return sent > 0;
+}
+
+void ConfigExchange::onResult(QNetworkReply* reply)
+{
+    int market = reply->request().attribute(QNetworkRequest::User).toInt();
+    Trace::finished(reply, "config", "request");
+    m_usage->add(m_definition.exchange, reply);
+
+    // a failed reply matches nothing, which fails every market it covers;
+    // match() only resets the configured slots
+    JsonMatcher::Value *values = m_values.data();
+    for (int i = 0; i < m_values.size(); i++)
+    {
+        values[i].begin = 0;
+        values[i].end = 0;
+    }
+    QByteArray data;
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        data = reply->readAll();
+    }
+    {
+        TRACE_SCOPE("config", "parse");
+        m_matcher.match(data.constData(), data.size(), values);
+    }
+    reply->deleteLater();
+
+    TRACE_SCOPE("config", "store");
+    uint now = QDateTime::currentDateTime().toTime_t();
+    bool success = false;
+    if (market >= 0)
+    {
+        success = apply(m_definition.markets.at(market).pair, values, now);
+    }
+    else
+    {
+        for (int i = 0; i < m_definition.markets.size(); i++)
+        {
+            success |= apply(m_definition.markets.at(i).pair, values + i * PriceTable::FieldCount, now);
+        }
+    }
+    m_breaker.requestFinished(success, now);
+    if (m_breaker.pending() == 0)
+    {
+        emit fetched();
+    }
+}
+
+bool ConfigExchange::apply(int pair, const JsonMatcher::Value *values, uint now)
+{
+    Price fields[PriceTable::FieldCount];
+    bool found[PriceTable::FieldCount] = { false };
+    for (int field = 0; field < PriceTable::FieldCount; field++)
+    {
+        if (values[field].begin)
+        {
+            fields[field] = Price::parse(values[field].begin, values[field].end,
+                                         PriceTable::scale(pair, PriceTable::Field(field)), &found[field]);
+        }
+    }
+
+    if (!fields[PriceTable::Bid].isValid())
+    {
+        m_prices->quote(pair).fail();
+        return false;
+    }
+    for (int field = PriceTable::Ask; field < PriceTable::FieldCount; field++)
+    {
+        if (found[field])
+        {
+            m_prices->setField(pair, PriceTable::Field(field), fields[field]);
+        }
+    }
+    m_prices->quote(pair).update(fields[PriceTable::Bid], now);
+    emit quoteUpdated(pair);
+    return true;
+}
+
+void ConfigExchange::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Network, m_manager);
+    m_matcher.measure(report);
+    report.add(MemoryReport::Parsers, m_values);
+    report.add(MemoryReport::Parsers, m_definition.markets);
+    for (int i = 0; i < m_definition.markets.size(); i++)
+    {
+        report.add(MemoryReport::Parsers, m_definition.markets.at(i).key);
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFIGEXCHANGE_H
+#define CONFIGEXCHANGE_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QVector>
+
+#include "pricetable.h"
+#include "circuitbreaker.h"
+#include "datausage.h"
+#include "exchangeconfig.h"
+#include "jsonmatcher.h"
+
+class MemoryReport;
+
+/*
+ * Exchange driven by a definition from the exchange config. The extraction
+ * paths are compiled into a matcher when the exchange is built; a per-market
+ * url shares one matcher for all markets, a shared reply gets one path per
+ * market and field.
+ */
+class ConfigExchange : public QObject
+{
+    Q_OBJECT
+
+public:
+    ConfigExchange(const ExchangeConfig::Definition &definition, PriceTable *prices, DataUsage *usage, QObject *parent = 0);
+    ~ConfigExchange();
+
+    bool fetch();
+    void measure(MemoryReport &report) const;
+
+signals:
+    void quoteUpdated(int pair);
+    void fetched();
+
+public slots:
+    void onResult(QNetworkReply* reply);
+
+private:
+    bool apply(int pair, const JsonMatcher::Value *values, uint now);
+
+    ExchangeConfig::Definition m_definition;
+    PriceTable *m_prices;
+    DataUsage *m_usage;
+    CircuitBreaker m_breaker;
+    JsonMatcher m_matcher;
+    QVector<JsonMatcher::Value> m_values;
+
+    QNetworkAccessManager m_manager;
+
+};
+
+#endif // CONFIGEXCHANGE_H
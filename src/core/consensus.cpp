@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "consensus.h"
+#include "memoryreport.h"
+
+namespace {
+    // 1.4826 scales the median absolute deviation to a standard deviation
+    static const double CUTOFF = 3.0 * 1.4826;
+
+    // never reject quotes within half a percent of the median, otherwise two
+    // venues that agree exactly would turn every other venue into an outlier
+    static const double MIN_DEVIATION = 0.005;
+
+    qint64 median(qint64 *values, int count)
+    {
+        std::sort(values, values + count);
+        if (count % 2 == 1)
+        {
+            return values[count / 2];
+        }
+        qint64 low = values[count / 2 - 1];
+        return low + (values[count / 2] - low) / 2;
+    }
+}
+
+Consensus::Consensus(const PriceTable *prices, QObject *parent)
+    :   QObject(parent)
+    ,   m_prices(prices)
+    ,   m_marketOf(Symbols::count(), -1)
+{
+    // group the pairs by asset pair, markets of a single venue are dropped
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        const PairInfo &info = Symbols::info(pair);
+        int index = find(info.base, info.quote);
+        if (index < 0)
+        {
+            m_markets.append(Market());
+            index = m_markets.size() - 1;
+        }
+        m_markets[index].pairs.append(pair);
+    }
+    for (int index = m_markets.size() - 1; index >= 0; index--)
+    {
+        if (m_markets.at(index).pairs.size() < 2)
+        {
+            m_markets.remove(index);
+        }
+    }
+    for (int index = 0; index < m_markets.size(); index++)
+    {
+        const QVector<int> &pairs = m_markets.at(index).pairs;
+        int scale = 0;
+        for (int i = 0; i < pairs.size(); i++)
+        {
+            m_marketOf[pairs.at(i)] = index;
+            scale = qMax(scale, Symbols::info(pairs.at(i)).scale);
+        }
+        m_markets[index].scale = scale;
+    }
+}
+
+Consensus::~Consensus()
+{
+}
+
+int Consensus::count() const
+{
+    return m_markets.size();
+}
+
+int Consensus::find(const QString &base, const QString &quote) const
+{
+    for (int index = 0; index < m_markets.size(); index++)
+    {
+        const PairInfo &info = Symbols::info(m_markets.at(index).pairs.first());
+        if (base == info.base && quote == info.quote)
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+int Consensus::market(int pair) const
+{
+    return (pair >= 0 && pair < m_marketOf.size()) ? m_marketOf.at(pair) : -1;
+}
+
+QVector<int> Consensus::pairs(int market) const
+{
+    return m_markets.at(market).pairs;
+}
+
+const char *Consensus::base(int market) const
+{
+    return Symbols::info(m_markets.at(market).pairs.first()).base;
+}
+
+const char *Consensus::quote(int market) const
+{
+    return Symbols::info(m_markets.at(market).pairs.first()).quote;
+}
+
+const Consensus::Book &Consensus::book(int market) const
+{
+    return m_markets.at(market).book;
+}
+
+void Consensus::add(int pair)
+{
+    int index = market(pair);
+    if (index < 0)
+    {
+        return;
+    }
+
+    // configured venues may use another scale than the built-in ones, every
+    // rate is brought to the finest scale of the market and the figures are
+    // computed on mantissas
+    const QVector<int> &pairs = m_markets.at(index).pairs;
+    int scale = m_markets.at(index).scale;
+    uint newest = 0;
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        const Quote &quote = m_prices->quote(pairs.at(i));
+        if (quote.isValid())
+        {
+            newest = qMax(newest, quote.updated);
+        }
+    }
+
+    int venues[MaxVenues];
+    qint64 values[MaxVenues];
+    int count = 0;
+    for (int i = 0; i < pairs.size() && count < MaxVenues; i++)
+    {
+        int venue = pairs.at(i);
+        const Quote &quote = m_prices->quote(venue);
+        if (!quote.isValid() || quote.updated + StaleAge < newest)
+        {
+            continue;
+        }
+        qint64 bid = quote.value.rescaled(scale).mantissa();
+        qint64 ask = m_prices->field(venue, PriceTable::Ask).rescaled(scale).mantissa();
+        bool hasAsk = m_prices->has(venue, PriceTable::Ask) && ask >= bid;
+        venues[count] = venue;
+        values[count] = hasAsk ? bid + (ask - bid) / 2 : bid;
+        count++;
+    }
+
+    Book book;
+    book.updated = newest;
+    if (count >= 3)
+    {
+        qint64 sorted[MaxVenues];
+        qint64 deviations[MaxVenues];
+        std::copy(values, values + count, sorted);
+        qint64 center = median(sorted, count);
+        for (int i = 0; i < count; i++)
+        {
+            deviations[i] = qAbs(values[i] - center);
+        }
+        qint64 mad = median(deviations, count);
+        double limit = qMax(CUTOFF * double(mad), MIN_DEVIATION * double(center));
+
+        int kept = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (double(qAbs(values[i] - center)) <= limit)
+            {
+                venues[kept] = venues[i];
+                values[kept] = values[i];
+                kept++;
+            }
+        }
+        book.rejected = count - kept;
+        count = kept;
+    }
+
+    if (count > 0)
+    {
+        qint64 bestBid = 0;
+        qint64 bestAsk = 0;
+        for (int i = 0; i < count; i++)
+        {
+            int venue = venues[i];
+            qint64 bid = m_prices->quote(venue).value.rescaled(scale).mantissa();
+            if (book.bestBid == Pair::Invalid || bid > bestBid)
+            {
+                bestBid = bid;
+                book.bestBid = venue;
+            }
+            if (m_prices->has(venue, PriceTable::Ask))
+            {
+                qint64 ask = m_prices->field(venue, PriceTable::Ask).rescaled(scale).mantissa();
+                if (book.bestAsk == Pair::Invalid || ask < bestAsk)
+                {
+                    bestAsk = ask;
+                    book.bestAsk = venue;
+                }
+            }
+        }
+        book.venues = count;
+        book.median = Price(median(values, count), scale);
+        book.bid = Price(bestBid, scale);
+        if (book.bestAsk != Pair::Invalid)
+        {
+            book.ask = Price(bestAsk, scale);
+        }
+    }
+
+    Book &current = m_markets[index].book;
+    bool differs = current.median != book.median || current.bid != book.bid || current.ask != book.ask
+            || current.venues != book.venues || current.rejected != book.rejected;
+    current = book;
+    if (differs)
+    {
+        emit changed(index);
+    }
+}
+
+void Consensus::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Prices, m_markets);
+    for (int i = 0; i < m_markets.size(); i++)
+    {
+        report.add(MemoryReport::Prices, m_markets.at(i).pairs);
+    }
+    report.add(MemoryReport::Prices, m_marketOf);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONSENSUS_H
+#define CONSENSUS_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "pricetable.h"
+
+class MemoryReport;
+
+/*
+ * Consolidated quote of every asset pair traded on more than one exchange:
+ * the best bid and ask and the median price across venues. Each venue
+ * contributes its mid, or its bid without an ask. With three or more venues
+ * a quote further than Cutoff scaled median absolute deviations from the
+ * median is rejected, so one broken feed cannot drag the figure. Stale venues
+ * are left out, and a quote only recomputes its own market.
+ */
+class Consensus : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum {
+        StaleAge = 900,     // seconds behind the freshest venue
+        MaxVenues = Exchange::Max + 1
+    };
+
+    struct Book
+    {
+        Book()
+            :   venues(0)
+            ,   rejected(0)
+            ,   bestBid(Pair::Invalid)
+            ,   bestAsk(Pair::Invalid)
+            ,   updated(0)
+        {
+        }
+
+        bool isValid() const
+        {
+            return median.isValid();
+        }
+
+        Price bid;
+        Price ask;
+        Price median;
+        int venues;         // quotes that made it into the figures
+        int rejected;       // outliers dropped by the deviation filter
+        int bestBid;        // pair with the best bid
+        int bestAsk;
+        uint updated;
+    };
+
+    explicit Consensus(const PriceTable *prices, QObject *parent = 0);
+    ~Consensus();
+
+    int count() const;
+    int find(const QString &base, const QString &quote) const;
+    int market(int pair) const;
+    QVector<int> pairs(int market) const;
+    const char *base(int market) const;
+    const char *quote(int market) const;
+    const Book &book(int market) const;
+
+    void add(int pair);
+    void measure(MemoryReport &report) const;
+
+signals:
+    void changed(int market);
+
+private:
+    struct Market
+    {
+        QVector<int> pairs;
+        int scale;          // finest scale of its venues
+        Book book;
+    };
+
+    const PriceTable *m_prices;
+    QVector<Market> m_markets;
+    QVector<int> m_marketOf;
+};
+
+#endif // CONSENSUS_H
@@ -0,0 +1,78 @@
+# Headless ticker core: exchanges, price table and the derived data. Only
+# needs QtCore and QtNetwork, shared by the app, the command line tool and
+# the benchmarks.
+
+QT += network
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+HEADERS += \
+    $$PWD/tickercore.h \
+    $$PWD/snapshot.h \
+    $$PWD/httpapi.h \
+    $$PWD/bitfinex.h \
+    $$PWD/cryptsy.h \
+    $$PWD/poloniex.h \
+    $$PWD/configexchange.h \
+    $$PWD/exchangeconfig.h \
+    $$PWD/quote.h \
+    $$PWD/circuitbreaker.h \
+    $$PWD/networkmonitor.h \
+    $$PWD/datausage.h \
+    $$PWD/price.h \
+    $$PWD/jsonscanner.h \
+    $$PWD/jsonmatcher.h \
+    $$PWD/symbols.h \
+    $$PWD/pricetable.h \
+    $$PWD/consensus.h \
+    $$PWD/orderbook.h \
+    $$PWD/trades.h \
+    $$PWD/recordfile.h \
+    $$PWD/candles.h \
+    $$PWD/ticklog.h \
+    $$PWD/historyexport.h \
+    $$PWD/replay.h \
+    $$PWD/chartcache.h \
+    $$PWD/backfill.h \
+    $$PWD/ring.h \
+    $$PWD/trace.h \
+    $$PWD/shutdown.h \
+    $$PWD/memoryreport.h \
+    $$PWD/statistics.h \
+    $$PWD/alerts.h \
+    $$PWD/portfolio.h
+
+SOURCES += \
+    $$PWD/tickercore.cpp \
+    $$PWD/snapshot.cpp \
+    $$PWD/httpapi.cpp \
+    $$PWD/bitfinex.cpp \
+    $$PWD/cryptsy.cpp \
+    $$PWD/poloniex.cpp \
+    $$PWD/configexchange.cpp \
+    $$PWD/exchangeconfig.cpp \
+    $$PWD/circuitbreaker.cpp \
+    $$PWD/networkmonitor.cpp \
+    $$PWD/datausage.cpp \
+    $$PWD/price.cpp \
+    $$PWD/jsonscanner.cpp \
+    $$PWD/jsonmatcher.cpp \
+    $$PWD/symbols.cpp \
+    $$PWD/pricetable.cpp \
+    $$PWD/consensus.cpp \
+    $$PWD/orderbook.cpp \
+    $$PWD/trades.cpp \
+    $$PWD/recordfile.cpp \
+    $$PWD/trace.cpp \
+    $$PWD/shutdown.cpp \
+    $$PWD/memoryreport.cpp \
+    $$PWD/candles.cpp \
+    $$PWD/ticklog.cpp \
+    $$PWD/historyexport.cpp \
+    $$PWD/replay.cpp \
+    $$PWD/chartcache.cpp \
+    $$PWD/backfill.cpp \
+    $$PWD/statistics.cpp \
+    $$PWD/alerts.cpp \
+    $$PWD/portfolio.cpp
@@ -0,0 +1,11 @@
+# Static library build of the headless core, for linking it into other
+# desktop tools without recompiling the sources.
+#   qmake && make
+
+TARGET = drkjollacore
+TEMPLATE = lib
+
+QT = core
+CONFIG += staticlib
+
+include(core.pri)
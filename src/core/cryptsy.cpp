@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QByteArray>
+#include <QUrl>
+#include <QDateTime>
+
+#include "cryptsy.h"
+#include "jsonscanner.h"
+#include "trace.h"
+#include "memoryreport.h"
+
+namespace {
+    static const QString SINGLEORDERDATA = "http://pubapi.cryptsy.com/api.php?method=singleorderdata&marketid=";
+}
+
+Cryptsy::Cryptsy(PriceTable *prices, OrderBooks *books, DataUsage *usage, QObject *parent)
+    :   QObject(parent)
+    ,   m_prices(prices)
+    ,   m_books(books)
+    ,   m_usage(usage)
+    ,   m_manager(this)
+    ,   m_bookManager(this)
+{
+    connect(&m_manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onResult(QNetworkReply*)));
+    connect(&m_bookManager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onBookResult(QNetworkReply*)));
+}
+
+Cryptsy::~Cryptsy()
+{
+}
+
+bool Cryptsy::fetch()
+{
+    if (!m_breaker.allowRequest(QDateTime::currentDateTime().toTime_t()))
+    {
+        return false;
+    }
+
+    // a half-open breaker only lets a single probe through
+    int first = Symbols::first(Exchange::Cryptsy);
+    int last = Symbols::last(Exchange::Cryptsy);
+    if (m_breaker.state() == CircuitBreaker::HalfOpen)
+    {
+        last = first;
+    }
+
+    // near the data budget low-priority pairs wait, a probe always goes out
+    bool probe = m_breaker.state() == CircuitBreaker::HalfOpen;
+    int sent = 0;
+    for (int pair = first; pair <= last; pair++)
+    {
+        if (!probe && m_usage->skips(pair))
+        {
+            continue;
+        }
+        QNetworkRequest request;
+        request.setUrl(QUrl(QString(SINGLEORDERDATA).append(Symbols::info(pair).market)));
+        request.setAttribute(QNetworkRequest::User, pair);
+        Trace::stamp(request);
+        m_manager.get(request);
+        m_breaker.requestStarted();
+        sent++;
+    }
+    return sent > 0;
+}
+
+bool Cryptsy::fetchBook(int pair)
+{
+    // the polling cycle refreshes the books as well, this is for the odd
+    // request in between and for processes that do not poll themselves
+    if (pair < Symbols::first(Exchange::Cryptsy) || pair > Symbols::last(Exchange::Cryptsy)
+            || m_breaker.state() != CircuitBreaker::Closed)
+    {
+        return false;
+    }
+
+    QNetworkRequest request;
+    request.setUrl(QUrl(QString(SINGLEORDERDATA).append(Symbols::info(pair).market)));
+    request.setAttribute(QNetworkRequest::User, pair);
+    m_bookManager.get(request);
+    return true;
+}
+
+void Cryptsy::onResult(QNetworkReply* reply)
+{
+    int pair = reply->request().attribute(QNetworkRequest::User).toInt();
+    Trace::finished(reply, "cryptsy", "request");
+    m_usage->add(Exchange::Cryptsy, reply);
+
+    OrderBook book;
+    book.clear(Symbols::info(pair).scale);
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        TRACE_SCOPE("cryptsy", "parse");
+        parseOrders(reply->readAll(), pair, book);
+    }
+    reply->deleteLater();
+
+    TRACE_SCOPE("cryptsy", "store");
+    uint now = QDateTime::currentDateTime().toTime_t();
+    Price tmp = book.best(OrderBook::Bids);
+    if (tmp.isValid())
+    {
+        Price ask = book.best(OrderBook::Asks);
+        if (ask.isValid())
+        {
+            m_prices->setField(pair, PriceTable::Ask, ask);
+        }
+        book.updated = now;
+        m_books->book(pair) = book;
+        m_prices->quote(pair).update(tmp, now);
+        emit quoteUpdated(pair);
+        emit bookUpdated(pair);
+    }
+    else
+    {
+        m_prices->quote(pair).fail();
+    }
+    m_breaker.requestFinished(tmp.isValid(), now);
+    if (m_breaker.pending() == 0)
+    {
+        emit fetched();
+    }
+}
+
+void Cryptsy::onBookResult(QNetworkReply* reply)
+{
+    int pair = reply->request().attribute(QNetworkRequest::User).toInt();
+    m_usage->add(Exchange::Cryptsy, reply);
+
+    OrderBook book;
+    book.clear(Symbols::info(pair).scale);
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        parseOrders(reply->readAll(), pair, book);
+    }
+    reply->deleteLater();
+
+    if (!book.isEmpty(OrderBook::Bids) || !book.isEmpty(OrderBook::Asks))
+    {
+        book.updated = QDateTime::currentDateTime().toTime_t();
+        m_books->book(pair) = book;
+        emit bookUpdated(pair);
+    }
+}
+
+void Cryptsy::parseOrders(const QByteArray &data, int pair, OrderBook &book)
+{
+    // cryptsy json is not always valid, the lenient scanner pairs up the
+    // price and quantity keys of the orders in the buyorders and sellorders
+    // lists; their first entries are the top of the book
+    JsonScanner scanner(data.constData(), data.size());
+    JsonScanner::Token token;
+    int side = -1;
+    Price price;
+    double quantity = 0.0;
+    while ((token = scanner.next()) != JsonScanner::End)
+    {
+        if (token != JsonScanner::Key)
+        {
+            continue;
+        }
+        if (scanner.equals("buyorders") || scanner.equals("sellorders"))
+        {
+            side = scanner.equals("buyorders") ? OrderBook::Bids : OrderBook::Asks;
+            price = Price();
+            quantity = 0.0;
+        }
+        else if (side >= 0 && (scanner.equals("price") || scanner.equals("quantity")))
+        {
+            bool isPrice = scanner.equals("price");
+            scanner.next();
+            if (isPrice)
+            {
+                price = Price::parse(scanner.begin(), scanner.end(), Symbols::info(pair).scale);
+            }
+            else
+            {
+                quantity = Price::parse(scanner.begin(), scanner.end()).toDouble();
+            }
+            if (price.isValid() && quantity > 0.0)
+            {
+                book.add(OrderBook::Side(side), price, quantity);
+                price = Price();
+                quantity = 0.0;
+            }
+        }
+    }
+}
+
+void Cryptsy::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Network, m_manager);
+    report.add(MemoryReport::Network, m_bookManager);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CRYPTSY_H
+#define CRYPTSY_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+
+#include "pricetable.h"
+#include "orderbook.h"
+#include "circuitbreaker.h"
+#include "datausage.h"
+
+class MemoryReport;
+
+class Cryptsy : public QObject
+{
+    Q_OBJECT
+
+public:
+    Cryptsy(PriceTable *prices, OrderBooks *books, DataUsage *usage, QObject *parent = 0);
+    ~Cryptsy();
+
+    bool fetch();
+    void measure(MemoryReport &report) const;
+    bool fetchBook(int pair);
+
+signals:
+    void quoteUpdated(int pair);
+    void bookUpdated(int pair);
+    void fetched();
+
+public slots:
+    void onResult(QNetworkReply* reply);
+    void onBookResult(QNetworkReply* reply);
+
+private:
+    static void parseOrders(const QByteArray &data, int pair, OrderBook &book);
+
+    PriceTable *m_prices;
+    OrderBooks *m_books;
+    DataUsage *m_usage;
+    CircuitBreaker m_breaker;
+
+    QNetworkAccessManager m_manager;
+    QNetworkAccessManager m_bookManager;
+
+};
+
+#endif // CRYPTSY_H
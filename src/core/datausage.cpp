@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QtEndian>
+
+#include <string.h>
+
+#include "datausage.h"
+
+namespace {
+    // request line, host header and the blank lines around the headers
+    static const int REQUEST_OVERHEAD = 32;
+    // status line without the reason phrase
+    static const int STATUS_OVERHEAD = 17;
+
+    uint currentMonth()
+    {
+        QDate today = QDateTime::currentDateTimeUtc().date();
+        return uint(today.year() * 100 + today.month());
+    }
+}
+
+DataUsage::DataUsage(QObject *parent)
+    :   QObject(parent)
+    ,   m_lowPriority(Symbols::count(), 0)
+    ,   m_month(0)
+    ,   m_budget(0)
+    ,   m_isMetered(false)
+    ,   m_counting(true)
+    ,   m_level(Normal)
+{
+    reload();
+}
+
+DataUsage::~DataUsage()
+{
+    save();
+}
+
+void DataUsage::add(int exchange, const QNetworkReply *reply)
+{
+    add(exchange, replyBytes(reply));
+}
+
+void DataUsage::add(int exchange, qint64 bytes)
+{
+    if (!m_counting || exchange < 0 || exchange > Exchange::Max || bytes <= 0)
+    {
+        return;
+    }
+    if (currentMonth() != m_month)
+    {
+        rollOver();
+    }
+
+    m_bytes[exchange] += bytes;
+    if (m_isMetered)
+    {
+        m_metered[exchange] += bytes;
+    }
+    m_unsaved[exchange] += bytes;
+    if (m_unsaved[exchange] >= SaveStep)
+    {
+        append(exchange);
+    }
+    updateLevel();
+}
+
+qint64 DataUsage::bytes(int exchange) const
+{
+    return exchange >= 0 && exchange <= Exchange::Max ? m_bytes[exchange] : 0;
+}
+
+qint64 DataUsage::meteredBytes(int exchange) const
+{
+    return exchange >= 0 && exchange <= Exchange::Max ? m_metered[exchange] : 0;
+}
+
+qint64 DataUsage::total() const
+{
+    qint64 total = 0;
+    for (int exchange = 0; exchange <= Exchange::Max; exchange++)
+    {
+        total += m_bytes[exchange];
+    }
+    return total;
+}
+
+qint64 DataUsage::meteredTotal() const
+{
+    qint64 total = 0;
+    for (int exchange = 0; exchange <= Exchange::Max; exchange++)
+    {
+        total += m_metered[exchange];
+    }
+    return total;
+}
+
+qint64 DataUsage::budget() const
+{
+    return m_budget;
+}
+
+void DataUsage::setBudget(qint64 bytes)
+{
+    // 0 turns the budget off
+    m_budget = qMax(Q_INT64_C(0), bytes);
+    updateLevel();
+}
+
+DataUsage::Level DataUsage::level() const
+{
+    return m_level;
+}
+
+int DataUsage::intervalFactor() const
+{
+    return 1 << int(m_level);
+}
+
+bool DataUsage::isLowPriority(int pair) const
+{
+    return pair >= 0 && pair < m_lowPriority.size() && m_lowPriority.at(pair);
+}
+
+void DataUsage::setLowPriority(int pair, bool low)
+{
+    if (pair >= 0 && pair < m_lowPriority.size())
+    {
+        m_lowPriority[pair] = low ? 1 : 0;
+    }
+}
+
+bool DataUsage::skips(int pair) const
+{
+    return m_level != Normal && isLowPriority(pair);
+}
+
+bool DataUsage::isCounting() const
+{
+    return m_counting;
+}
+
+void DataUsage::setCounting(bool counting)
+{
+    if (counting == m_counting)
+    {
+        return;
+    }
+    // the other process counted meanwhile, continue from its totals
+    save();
+    m_counting = counting;
+    reload();
+}
+
+void DataUsage::reload()
+{
+    m_month = currentMonth();
+    m_file.reset(new RecordFile(QString("usage-%1.dat").arg(m_month), RecordSize));
+    for (int exchange = 0; exchange <= Exchange::Max; exchange++)
+    {
+        m_bytes[exchange] = 0;
+        m_metered[exchange] = 0;
+        m_unsaved[exchange] = 0;
+    }
+
+    // names instead of ids, configured exchanges may come in another order
+    uchar record[RecordSize];
+    for (qint64 i = 0; i < m_file->count(); i++)
+    {
+        if (!m_file->read(i, reinterpret_cast<char *>(record)))
+        {
+            break;
+        }
+        QByteArray name(reinterpret_cast<const char *>(record), qstrnlen(reinterpret_cast<const char *>(record), NameSize));
+        for (int exchange = 0; exchange < Symbols::exchangeCount(); exchange++)
+        {
+            // names are stored cut to NameSize bytes
+            if (name == QByteArray(Symbols::exchangeName(Exchange::Id(exchange))).left(NameSize))
+            {
+                m_bytes[exchange] = qFromLittleEndian<qint64>(record + NameSize);
+                m_metered[exchange] = qFromLittleEndian<qint64>(record + NameSize + 8);
+                break;
+            }
+        }
+    }
+    updateLevel();
+}
+
+qint64 DataUsage::replyBytes(const QNetworkReply *reply)
+{
+    // what the http layer shows, tls and tcp overhead is not visible here
+    QNetworkRequest request = reply->request();
+    qint64 bytes = REQUEST_OVERHEAD + request.url().toEncoded().size();
+    QList<QByteArray> names = request.rawHeaderList();
+    for (int i = 0; i < names.size(); i++)
+    {
+        bytes += names.at(i).size() + request.rawHeader(names.at(i)).size() + 4;
+    }
+
+    bytes += STATUS_OVERHEAD + reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray().size();
+    const QList<QNetworkReply::RawHeaderPair> &headers = reply->rawHeaderPairs();
+    for (int i = 0; i < headers.size(); i++)
+    {
+        bytes += headers.at(i).first.size() + headers.at(i).second.size() + 4;
+    }
+
+    // the body as sent, compressed bodies are inflated by the manager
+    bool ok = false;
+    qint64 length = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong(&ok);
+    return bytes + (ok && length >= 0 ? length : reply->bytesAvailable());
+}
+
+void DataUsage::setMetered(bool metered)
+{
+    m_isMetered = metered;
+    updateLevel();
+}
+
+void DataUsage::save()
+{
+    if (!m_counting)
+    {
+        return;
+    }
+    for (int exchange = 0; exchange <= Exchange::Max; exchange++)
+    {
+        if (m_unsaved[exchange] > 0)
+        {
+            append(exchange);
+        }
+    }
+}
+
+void DataUsage::rollOver()
+{
+    save();
+    reload();
+}
+
+void DataUsage::append(int exchange)
+{
+    uchar record[RecordSize];
+    memset(record, 0, RecordSize);
+    QByteArray name = QByteArray(Symbols::exchangeName(Exchange::Id(exchange))).left(NameSize);
+    memcpy(record, name.constData(), name.size());
+    qToLittleEndian<qint64>(m_bytes[exchange], record + NameSize);
+    qToLittleEndian<qint64>(m_metered[exchange], record + NameSize + 8);
+    m_file->append(reinterpret_cast<const char *>(record));
+    m_unsaved[exchange] = 0;
+}
+
+void DataUsage::updateLevel()
+{
+    Level level = Normal;
+    if (m_isMetered && m_budget > 0)
+    {
+        qint64 used = meteredTotal();
+        if (used >= m_budget)
+        {
+            level = Exhausted;
+        }
+        else if (used * 10 >= m_budget * 9)
+        {
+            level = Critical;
+        }
+        else if (used * 4 >= m_budget * 3)
+        {
+            level = Saving;
+        }
+    }
+    if (level != m_level)
+    {
+        m_level = level;
+        emit levelChanged(level);
+    }
+}
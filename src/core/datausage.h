@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATAUSAGE_H
+#define DATAUSAGE_H
+
+#include <QObject>
+#include <QScopedPointer>
+#include <QVector>
+
+#include "recordfile.h"
+#include "symbols.h"
+
+class QNetworkReply;
+
+/*
+ * Bytes transferred per exchange in the current calendar month (UTC),
+ * headers and bodies of requests and replies, together with the share that
+ * went over a metered connection. The monthly budget applies to that share.
+ * While on a metered connection, nearing the budget raises the level: the
+ * poll interval is stretched by intervalFactor() and exchanges skip the
+ * pairs marked low priority. On wifi the level stays Normal.
+ *
+ * Totals go to usage-YYYYMM.dat as cumulative records, the last record of
+ * an exchange wins. A record is written every SaveStep bytes per exchange
+ * and on save(), so a crash loses little. Only one process counts at a
+ * time; a mirror core stops counting and reloads what the service stored.
+ */
+class DataUsage : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Level {
+        Normal,
+        Saving,         // from 75% of the budget
+        Critical,       // from 90%
+        Exhausted
+    };
+
+    enum {
+        SaveStep = 65536,
+        NameSize = 16,
+        RecordSize = 32
+    };
+
+    explicit DataUsage(QObject *parent = 0);
+    ~DataUsage();
+
+    void add(int exchange, const QNetworkReply *reply);
+    void add(int exchange, qint64 bytes);
+
+    qint64 bytes(int exchange) const;
+    qint64 meteredBytes(int exchange) const;
+    qint64 total() const;
+    qint64 meteredTotal() const;
+
+    qint64 budget() const;
+    void setBudget(qint64 bytes);
+    Level level() const;
+    int intervalFactor() const;
+
+    bool isLowPriority(int pair) const;
+    void setLowPriority(int pair, bool low);
+    bool skips(int pair) const;
+
+    bool isCounting() const;
+    void setCounting(bool counting);
+    void reload();
+
+    static qint64 replyBytes(const QNetworkReply *reply);
+
+public slots:
+    void setMetered(bool metered);
+    void save();
+
+signals:
+    void levelChanged(int level);
+
+private:
+    void rollOver();
+    void append(int exchange);
+    void updateLevel();
+
+    qint64 m_bytes[Exchange::Max + 1];
+    qint64 m_metered[Exchange::Max + 1];
+    qint64 m_unsaved[Exchange::Max + 1];
+    QVector<quint8> m_lowPriority;
+    QScopedPointer<RecordFile> m_file;
+    uint m_month;
+    qint64 m_budget;
+    bool m_isMetered;
+    bool m_counting;
+    Level m_level;
+};
+
+#endif // DATAUSAGE_H
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "exchangeconfig.h"
+#include "jsonmatcher.h"
+#include "recordfile.h"
+
+namespace {
+    static const char MARKET[] = "{market}";
+
+    struct State
+    {
+        State()
+            :   loaded(false)
+            ,   ok(true)
+        {
+        }
+
+        bool loaded;
+        bool ok;
+        QString error;
+        QList<ExchangeConfig::Definition> definitions;
+    };
+
+    State &state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    bool fail(const QString &error)
+    {
+        if (state().ok)
+        {
+            state().ok = false;
+            state().error = error;
+        }
+        return false;
+    }
+
+    bool parse(const QJsonObject &object)
+    {
+        QByteArray name = object.value("name").toString().toLatin1();
+        QString url = object.value("url").toString();
+        QJsonObject fields = object.value("fields").toObject();
+        QJsonArray markets = object.value("markets").toArray();
+        if (name.isEmpty() || url.isEmpty() || markets.isEmpty())
+        {
+            return fail(QString("exchange %1: name, url and markets are required").arg(QString(name)));
+        }
+
+        ExchangeConfig::Definition definition;
+        definition.url = url;
+        for (int field = 0; field < PriceTable::FieldCount; field++)
+        {
+            definition.paths[field] = fields.value(PriceTable::fieldName(PriceTable::Field(field))).toString().toLatin1();
+        }
+        if (definition.paths[PriceTable::Bid].isEmpty())
+        {
+            return fail(QString("exchange %1: no path to the bid").arg(QString(name)));
+        }
+
+        // check the markets and compile every path before registering anything
+        QList<QJsonObject> entries;
+        for (int i = 0; i < markets.size(); i++)
+        {
+            QJsonObject market = markets.at(i).toObject();
+            QByteArray key = market.value("market").toString().toLatin1();
+            if (key.isEmpty() || market.value("base").toString().isEmpty() || market.value("quote").toString().isEmpty())
+            {
+                return fail(QString("exchange %1: market %2 needs market, base and quote").arg(QString(name)).arg(i));
+            }
+            JsonMatcher matcher;
+            for (int field = 0; field < PriceTable::FieldCount; field++)
+            {
+                QByteArray path = definition.paths[field];
+                if (!path.isEmpty() && !matcher.add(path.replace(MARKET, key), field))
+                {
+                    return fail(QString("exchange %1: invalid path %2").arg(QString(name)).arg(QString(definition.paths[field])));
+                }
+            }
+            entries.append(market);
+        }
+
+        definition.exchange = Symbols::addExchange(name);
+        if (definition.exchange < 0)
+        {
+            return fail(QString("exchange %1: name taken or too many exchanges").arg(QString(name)));
+        }
+        for (int i = 0; i < entries.size(); i++)
+        {
+            const QJsonObject &market = entries.at(i);
+            int scale = market.value("scale").toInt(Price::DefaultScale);
+            ExchangeConfig::Market entry;
+            entry.key = market.value("market").toString().toLatin1();
+            entry.pair = Symbols::addPair(definition.exchange, entry.key,
+                                          market.value("base").toString().toLatin1(),
+                                          market.value("quote").toString().toLatin1(),
+                                          scale, market.value("precision").toInt(qMin(5, scale)));
+            if (entry.pair == Pair::Invalid)
+            {
+                fail(QString("exchange %1: duplicate market %2").arg(QString(name)).arg(QString(entry.key)));
+                continue;
+            }
+            definition.markets.append(entry);
+        }
+        state().definitions.append(definition);
+        return true;
+    }
+}
+
+bool ExchangeConfig::Definition::perMarket() const
+{
+    return url.contains(MARKET);
+}
+
+ExchangeConfig::ExchangeConfig()
+{
+    load();
+}
+
+bool ExchangeConfig::load(const QString &path)
+{
+    // only the first call reads a file, tables sized by Symbols::count()
+    // must not see the set of pairs change
+    State &current = state();
+    if (current.loaded)
+    {
+        return current.ok;
+    }
+    current.loaded = true;
+
+    QFile file(path.isEmpty() ? defaultPath() : path);
+    if (!file.exists() && path.isEmpty())
+    {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return fail(QString("%1: %2").arg(file.fileName()).arg(file.errorString()));
+    }
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (!document.isObject())
+    {
+        return fail(QString("%1: %2").arg(file.fileName()).arg(error.errorString()));
+    }
+
+    QJsonArray exchanges = document.object().value("exchanges").toArray();
+    for (int i = 0; i < exchanges.size(); i++)
+    {
+        parse(exchanges.at(i).toObject());
+    }
+    return current.ok;
+}
+
+QString ExchangeConfig::defaultPath()
+{
+    return RecordFile::dataPath("exchanges.json");
+}
+
+QString ExchangeConfig::errorString()
+{
+    return state().error;
+}
+
+const QList<ExchangeConfig::Definition> &ExchangeConfig::definitions()
+{
+    return state().definitions;
+}
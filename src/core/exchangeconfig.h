@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXCHANGECONFIG_H
+#define EXCHANGECONFIG_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include "pricetable.h"
+
+/*
+ * Exchanges defined in a JSON file instead of code (see README). The file is
+ * read once per process, before the first price table is sized, and its
+ * markets are registered with Symbols behind the built-in ones. A broken
+ * exchange definition is dropped as a whole.
+ *
+ * An instance only makes sure the default file was loaded; TickerCore holds
+ * one ahead of its tables.
+ */
+class ExchangeConfig
+{
+public:
+    struct Market
+    {
+        int pair;
+        QByteArray key;
+    };
+
+    struct Definition
+    {
+        int exchange;
+        QString url;                                // {market} means one request per market
+        QByteArray paths[PriceTable::FieldCount];   // empty if not extracted
+        QVector<Market> markets;
+
+        bool perMarket() const;
+    };
+
+    ExchangeConfig();
+
+    static bool load(const QString &path = QString());
+    static QString defaultPath();
+    static QString errorString();
+    static const QList<Definition> &definitions();
+};
+
+#endif // EXCHANGECONFIG_H
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+
+#include "historyexport.h"
+#include "snapshot.h"
+#include "symbols.h"
+#include "price.h"
+#include "trace.h"
+
+HistoryExport::HistoryExport(const TickLog *log, QObject *parent)
+    :   QThread(parent)
+    ,   m_log(log)
+    ,   m_descriptor(-1)
+    ,   m_from(0)
+    ,   m_to(0)
+    ,   m_format(Csv)
+    ,   m_cancel(0)
+    ,   m_ok(false)
+    ,   m_rows(0)
+{
+}
+
+HistoryExport::~HistoryExport()
+{
+    cancel();
+    wait();
+}
+
+bool HistoryExport::exportTo(const QString &fileName, const QList<int> &pairs, uint from, uint to, Format format)
+{
+    if (!prepare(pairs, from, to, format))
+    {
+        return false;
+    }
+    m_fileName = fileName;
+    m_descriptor = -1;
+    start(QThread::LowPriority);
+    return true;
+}
+
+bool HistoryExport::exportTo(int descriptor, const QList<int> &pairs, uint from, uint to, Format format)
+{
+    if (!prepare(pairs, from, to, format))
+    {
+        return false;
+    }
+    m_fileName.clear();
+    m_descriptor = descriptor;
+    start(QThread::LowPriority);
+    return true;
+}
+
+void HistoryExport::cancel()
+{
+    m_cancel.fetchAndStoreOrdered(1);
+}
+
+bool HistoryExport::isOk() const
+{
+    return m_ok;
+}
+
+qint64 HistoryExport::rows() const
+{
+    return m_rows;
+}
+
+QString HistoryExport::errorString() const
+{
+    return m_error;
+}
+
+bool HistoryExport::prepare(const QList<int> &pairs, uint from, uint to, Format format)
+{
+    // one export at a time, the parameters are read by the worker
+    if (isRunning())
+    {
+        return false;
+    }
+    m_pairs = pairs;
+    m_pending.clear();
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        m_pending.append(m_log->pending(pairs.at(i)));
+    }
+    m_from = from;
+    m_to = to;
+    m_format = format;
+    m_cancel.fetchAndStoreOrdered(0);
+    m_ok = false;
+    m_rows = 0;
+    m_error.clear();
+    return true;
+}
+
+void HistoryExport::finish(bool ok, const QString &error)
+{
+    m_ok = ok;
+    m_error = error;
+    emit done(ok, m_rows, error);
+}
+
+void HistoryExport::run()
+{
+    TRACE_SCOPE("export", "run");
+    QFile file;
+    bool opened;
+    if (m_descriptor >= 0)
+    {
+        opened = file.open(m_descriptor, QIODevice::WriteOnly);
+    }
+    else
+    {
+        file.setFileName(m_fileName);
+        opened = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened)
+    {
+        finish(false, file.errorString());
+        return;
+    }
+
+    QByteArray chunk;
+    chunk.reserve(ChunkSize + 256);
+    if (m_format == Csv)
+    {
+        chunk.append("timestamp,pair,price\n");
+    }
+
+    char price[Price::MaxFormatted];
+    for (int i = 0; i < m_pairs.size(); i++)
+    {
+        const PairInfo &info = Symbols::info(m_pairs.at(i));
+        TickCursor cursor(m_log, m_pairs.at(i), m_from, m_to);
+        const QVector<Tick> &pending = m_pending.at(i);
+        int next = 0;
+        uint logged = 0;
+        bool reading = true;
+        Tick tick;
+        while (true)
+        {
+            if (reading && cursor.next(tick))
+            {
+                logged = tick.timestamp;
+            }
+            else
+            {
+                // then the buffered ticks the log does not hold yet
+                reading = false;
+                while (next < pending.size() && (pending.at(next).timestamp <= logged
+                        || pending.at(next).timestamp < m_from || pending.at(next).timestamp > m_to))
+                {
+                    next++;
+                }
+                if (next == pending.size())
+                {
+                    break;
+                }
+                tick = pending.at(next++);
+            }
+
+            int length = Price(tick.mantissa, info.scale).format(price, info.scale);
+            if (m_format == Csv)
+            {
+                chunk.append(QByteArray::number(tick.timestamp)).append(',')
+                     .append(info.name).append(',').append(price, length).append('\n');
+            }
+            else
+            {
+                chunk.append("{\"timestamp\":").append(QByteArray::number(tick.timestamp)).append(",\"pair\":");
+                Snapshot::appendString(chunk, info.name);
+                chunk.append(",\"price\":").append(price, length).append("}\n");
+            }
+            m_rows++;
+
+            if (chunk.size() >= ChunkSize)
+            {
+                if (file.write(chunk) != chunk.size())
+                {
+                    finish(false, file.errorString());
+                    return;
+                }
+                chunk.resize(0);
+                emit progress(m_rows);
+                if (m_cancel.load())
+                {
+                    finish(false, QString("cancelled"));
+                    return;
+                }
+            }
+        }
+    }
+
+    if (file.write(chunk) != chunk.size() || !file.flush())
+    {
+        finish(false, file.errorString());
+        return;
+    }
+    finish(true, QString());
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HISTORYEXPORT_H
+#define HISTORYEXPORT_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include "ticklog.h"
+
+/*
+ * Streams the tick history of a set of pairs to CSV or newline-delimited
+ * JSON on a worker thread. Ticks are read block by block through a
+ * TickCursor and written in chunks of ChunkSize bytes, so memory use does not
+ * depend on the length of the range. Pairs are written one after another,
+ * each in time order.
+ *
+ * Ticks the log still buffers are copied when the export starts and written
+ * after the logged ones, so the log does not have to be flushed first.
+ */
+class HistoryExport : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        Csv,
+        Json
+    };
+
+    enum {
+        ChunkSize = 65536
+    };
+
+    explicit HistoryExport(const TickLog *log, QObject *parent = 0);
+    ~HistoryExport();
+
+    bool exportTo(const QString &fileName, const QList<int> &pairs, uint from, uint to, Format format);
+    bool exportTo(int descriptor, const QList<int> &pairs, uint from, uint to, Format format);
+    void cancel();
+
+    bool isOk() const;
+    qint64 rows() const;
+    QString errorString() const;
+
+signals:
+    void progress(qint64 rows);
+    void done(bool ok, qint64 rows, const QString &error);
+
+protected:
+    void run();
+
+private:
+    bool prepare(const QList<int> &pairs, uint from, uint to, Format format);
+    void finish(bool ok, const QString &error);
+
+    const TickLog *m_log;
+    QString m_fileName;
+    int m_descriptor;
+    QList<int> m_pairs;
+    QVector<QVector<Tick> > m_pending;
+    uint m_from;
+    uint m_to;
+    Format m_format;
+    QAtomicInt m_cancel;
+
+    bool m_ok;
+    qint64 m_rows;
+    QString m_error;
+};
+
+#endif // HISTORYEXPORT_H
@@ -0,0 +1,417 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QUrlQuery>
+#include <qnumeric.h>
+
+#include "httpapi.h"
+#include "snapshot.h"
+#include "tickercore.h"
+#include "memoryreport.h"
+
+namespace {
+    void appendNumber(QByteArray &out, double value)
+    {
+        if (qIsFinite(value))
+        {
+            out.append(QByteArray::number(value, 'g', 12));
+        }
+        else
+        {
+            out.append("null");
+        }
+    }
+
+    void appendMantissa(QByteArray &out, qint64 mantissa, const PairInfo &info)
+    {
+        char buffer[Price::MaxFormatted];
+        out.append(buffer, Price(mantissa, info.scale).format(buffer, info.precision));
+    }
+
+    const char *reason(int status)
+    {
+        switch (status)
+        {
+        case 200:
+            return "OK";
+        case 304:
+            return "Not Modified";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 431:
+            return "Request Header Fields Too Large";
+        default:
+            return "Unknown";
+        }
+    }
+}
+
+HttpApi::HttpApi(TickerCore *core, QObject *parent)
+    :   QObject(parent)
+    ,   m_core(core)
+    ,   m_server(this)
+    ,   m_expiry(this)
+    ,   m_version(0)
+{
+    m_clock.start();
+    m_expiry.setInterval(1000);
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    connect(&m_expiry, SIGNAL(timeout()), this, SLOT(onExpire()));
+    connect(m_core, SIGNAL(fetched()), this, SLOT(publish()));
+}
+
+HttpApi::~HttpApi()
+{
+}
+
+bool HttpApi::listen(quint16 port, const QHostAddress &address)
+{
+    close();
+    if (!m_server.listen(address, port))
+    {
+        return false;
+    }
+    publish();
+    return true;
+}
+
+void HttpApi::close()
+{
+    m_server.close();
+    QList<Waiter> waiting = m_waiting;
+    m_waiting.clear();
+    m_expiry.stop();
+    for (int i = 0; i < waiting.size(); i++)
+    {
+        waiting.at(i).socket->abort();
+    }
+}
+
+bool HttpApi::isListening() const
+{
+    return m_server.isListening();
+}
+
+quint16 HttpApi::port() const
+{
+    return m_server.serverPort();
+}
+
+quint64 HttpApi::version() const
+{
+    return m_version;
+}
+
+void HttpApi::publish()
+{
+    if (!m_server.isListening())
+    {
+        return;
+    }
+
+    QList<int> pairs;
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        pairs.append(pair);
+    }
+    m_version++;
+    m_snapshot = response(200, Snapshot::write(*m_core->prices(), pairs, Snapshot::Json), m_version);
+    m_statistics = response(200, statistics(Pair::Invalid), m_version);
+
+    // wake up all long-polling clients with the same rendered response
+    QList<Waiter> waiting = m_waiting;
+    m_waiting.clear();
+    m_expiry.stop();
+    for (int i = 0; i < waiting.size(); i++)
+    {
+        respond(waiting.at(i).socket, m_snapshot);
+    }
+}
+
+void HttpApi::onNewConnection()
+{
+    while (m_server.hasPendingConnections())
+    {
+        QTcpSocket *socket = m_server.nextPendingConnection();
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    }
+}
+
+void HttpApi::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket || !m_buffers.contains(socket))
+    {
+        return;
+    }
+
+    QByteArray &buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+    int end = buffer.indexOf("\r\n\r\n");
+    if (end < 0)
+    {
+        if (buffer.size() > MaxRequestSize)
+        {
+            // answered once, what still arrives is left unread
+            m_buffers.remove(socket);
+            disconnect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+            respond(socket, response(431, "{\"error\":\"request too large\"}\n"));
+        }
+        return;
+    }
+
+    // only the request line matters, bodies are never expected
+    QByteArray request = buffer.left(buffer.indexOf("\r\n"));
+    m_buffers.remove(socket);
+    disconnect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    handle(socket, request);
+}
+
+void HttpApi::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket)
+    {
+        return;
+    }
+    m_buffers.remove(socket);
+    for (int i = 0; i < m_waiting.size(); i++)
+    {
+        if (m_waiting.at(i).socket == socket)
+        {
+            m_waiting.removeAt(i);
+            break;
+        }
+    }
+    socket->deleteLater();
+}
+
+void HttpApi::onExpire()
+{
+    qint64 now = m_clock.elapsed();
+    for (int i = m_waiting.size() - 1; i >= 0; i--)
+    {
+        if (m_waiting.at(i).deadline <= now)
+        {
+            QTcpSocket *socket = m_waiting.takeAt(i).socket;
+            respond(socket, response(304, QByteArray(), m_version));
+        }
+    }
+    if (m_waiting.isEmpty())
+    {
+        m_expiry.stop();
+    }
+}
+
+void HttpApi::handle(QTcpSocket *socket, const QByteArray &request)
+{
+    QList<QByteArray> parts = request.split(' ');
+    if (parts.size() != 3 || !parts.at(2).startsWith("HTTP/"))
+    {
+        respond(socket, response(400, "{\"error\":\"malformed request\"}\n"));
+        return;
+    }
+    if (parts.at(0) != "GET")
+    {
+        respond(socket, response(405, "{\"error\":\"only GET is supported\"}\n"));
+        return;
+    }
+
+    QUrl url(QString::fromLatin1(parts.at(1)));
+    QUrlQuery query(url);
+    QString path = url.path();
+
+    if (path == "/snapshot")
+    {
+        bool ok = false;
+        quint64 since = query.queryItemValue("since").toULongLong(&ok);
+        if (!ok || since < m_version)
+        {
+            respond(socket, m_snapshot);
+            return;
+        }
+
+        int wait = query.hasQueryItem("wait") ? query.queryItemValue("wait").toInt() : int(DefaultWait);
+        Waiter waiter;
+        waiter.socket = socket;
+        waiter.deadline = m_clock.elapsed() + qBound(0, wait, int(MaxWait)) * 1000;
+        m_waiting.append(waiter);
+        if (!m_expiry.isActive())
+        {
+            m_expiry.start();
+        }
+        return;
+    }
+
+    if (path == "/statistics")
+    {
+        if (!query.hasQueryItem("pair"))
+        {
+            respond(socket, m_statistics);
+            return;
+        }
+        int pair = Symbols::find(query.queryItemValue("pair"));
+        if (pair == Pair::Invalid)
+        {
+            respond(socket, response(404, "{\"error\":\"unknown pair\"}\n"));
+            return;
+        }
+        respond(socket, response(200, statistics(pair), m_version));
+        return;
+    }
+
+    if (path == "/history")
+    {
+        int pair = Symbols::find(query.queryItemValue("pair"));
+        if (pair == Pair::Invalid)
+        {
+            respond(socket, response(404, "{\"error\":\"unknown pair\"}\n"));
+            return;
+        }
+
+        static const char *names[] = { "minute", "quarter", "hour", "day" };
+        QString name = query.hasQueryItem("resolution") ? query.queryItemValue("resolution") : QString("hour");
+        int resolution = CandleAggregator::ResolutionCount;
+        for (int i = 0; i < CandleAggregator::ResolutionCount; i++)
+        {
+            if (name == names[i])
+            {
+                resolution = i;
+            }
+        }
+        if (resolution == CandleAggregator::ResolutionCount)
+        {
+            respond(socket, response(400, "{\"error\":\"unknown resolution\"}\n"));
+            return;
+        }
+
+        uint to = query.hasQueryItem("to") ? query.queryItemValue("to").toUInt() : QDateTime::currentDateTime().toTime_t();
+        uint from = query.hasQueryItem("from") ? query.queryItemValue("from").toUInt() : to - qMin(to, 86400u);
+        respond(socket, response(200, history(pair, resolution, from, to), m_version));
+        return;
+    }
+
+    respond(socket, response(404, "{\"error\":\"not found\"}\n"));
+}
+
+QByteArray HttpApi::statistics(int pair)
+{
+    int first = pair == Pair::Invalid ? 0 : pair;
+    int last = pair == Pair::Invalid ? Symbols::count() - 1 : pair;
+
+    QByteArray out;
+    out.append('[');
+    for (int i = first; i <= last; i++)
+    {
+        PairStatistics *stats = m_core->statistics()->pair(i);
+        if (i > first)
+        {
+            out.append(',');
+        }
+        out.append("{\"pair\":");
+        Snapshot::appendString(out, Symbols::info(i).name);
+        out.append(",\"samples\":").append(QByteArray::number(stats->samples()));
+        out.append(",\"sma\":");
+        appendNumber(out, stats->sma());
+        out.append(",\"ema\":");
+        appendNumber(out, stats->ema());
+        out.append(",\"stddev\":");
+        appendNumber(out, stats->stddev());
+        out.append(",\"change\":");
+        appendNumber(out, stats->change());
+        out.append(",\"minimum\":");
+        appendNumber(out, stats->minimum());
+        out.append(",\"maximum\":");
+        appendNumber(out, stats->maximum());
+        out.append(",\"vwap\":");
+        appendNumber(out, stats->vwap());
+        out.append('}');
+    }
+    out.append("]\n");
+    return out;
+}
+
+QByteArray HttpApi::history(int pair, int resolution, uint from, uint to)
+{
+    const PairInfo &info = Symbols::info(pair);
+    QVector<Candle> candles = m_core->candles()->history(pair, resolution, from, to);
+
+    QByteArray out;
+    out.reserve(96 * (candles.size() + 1));
+    out.append('[');
+    for (int i = 0; i < candles.size(); i++)
+    {
+        const Candle &candle = candles.at(i);
+        if (i > 0)
+        {
+            out.append(',');
+        }
+        out.append("{\"start\":").append(QByteArray::number(candle.start)).append(",\"open\":");
+        appendMantissa(out, candle.open, info);
+        out.append(",\"high\":");
+        appendMantissa(out, candle.high, info);
+        out.append(",\"low\":");
+        appendMantissa(out, candle.low, info);
+        out.append(",\"close\":");
+        appendMantissa(out, candle.close, info);
+        out.append('}');
+    }
+    out.append("]\n");
+    return out;
+}
+
+void HttpApi::respond(QTcpSocket *socket, const QByteArray &response)
+{
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+QByteArray HttpApi::response(int status, const QByteArray &body, quint64 version)
+{
+    QByteArray out;
+    out.reserve(160 + body.size());
+    out.append("HTTP/1.1 ").append(QByteArray::number(status)).append(' ').append(reason(status))
+       .append("\r\nContent-Type: application/json\r\nContent-Length: ").append(QByteArray::number(body.size()))
+       .append("\r\nCache-Control: no-cache\r\nConnection: close\r\n");
+    if (version > 0)
+    {
+        out.append("ETag: \"").append(QByteArray::number(version)).append("\"\r\n");
+    }
+    out.append("\r\n").append(body);
+    return out;
+}
+
+void HttpApi::measure(MemoryReport &report) const
+{
+    QHash<QTcpSocket *, QByteArray>::const_iterator it;
+    for (it = m_buffers.constBegin(); it != m_buffers.constEnd(); ++it)
+    {
+        report.add(MemoryReport::Network, sizeof(QTcpSocket));
+        report.add(MemoryReport::Network, it.value());
+    }
+    report.add(MemoryReport::Network, m_snapshot);
+    report.add(MemoryReport::Network, m_statistics);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HTTPAPI_H
+#define HTTPAPI_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QTcpServer>
+#include <QTimer>
+
+class QTcpSocket;
+class TickerCore;
+class MemoryReport;
+
+/*
+ * Minimal HTTP/1.1 server exposing the quotes of a ticker core as JSON to
+ * other local processes:
+ *
+ *   GET /snapshot[?since=VERSION&wait=SECONDS]
+ *   GET /statistics[?pair=NAME]
+ *   GET /history?pair=NAME[&resolution=minute|quarter|hour|day][&from=TS][&to=TS]
+ *
+ * The snapshot and statistics responses are rendered once after every
+ * refresh cycle and then only copied to the sockets. The version of the data
+ * is sent as ETag; a snapshot request with a version not older than the
+ * current one is parked until the next cycle or until the wait time runs out
+ * (304). Every connection serves one request.
+ */
+class HttpApi : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HttpApi(TickerCore *core, QObject *parent = 0);
+    ~HttpApi();
+
+    bool listen(quint16 port, const QHostAddress &address = QHostAddress::LocalHost);
+    void close();
+    bool isListening() const;
+    quint16 port() const;
+    quint64 version() const;
+    void measure(MemoryReport &report) const;
+
+public slots:
+    void publish();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void onExpire();
+
+private:
+    enum {
+        MaxRequestSize = 8192,
+        DefaultWait = 30,
+        MaxWait = 300
+    };
+
+    struct Waiter
+    {
+        QTcpSocket *socket;
+        qint64 deadline;
+    };
+
+    void handle(QTcpSocket *socket, const QByteArray &request);
+    QByteArray statistics(int pair);
+    QByteArray history(int pair, int resolution, uint from, uint to);
+    void respond(QTcpSocket *socket, const QByteArray &response);
+    static QByteArray response(int status, const QByteArray &body, quint64 version = 0);
+
+    TickerCore *m_core;
+    QTcpServer m_server;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QList<Waiter> m_waiting;
+    QElapsedTimer m_clock;
+    QTimer m_expiry;
+
+    quint64 m_version;
+    QByteArray m_snapshot;
+    QByteArray m_statistics;
+};
+
+#endif // HTTPAPI_H
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonmatcher.h"
+#include "memoryreport.h"
+
+JsonMatcher::JsonMatcher()
+    :   m_targets(0)
+    ,   m_paths(0)
+{
+    Node root;
+    root.index = -1;
+    root.target = -1;
+    root.child = -1;
+    root.sibling = -1;
+    m_nodes.append(root);
+}
+
+bool JsonMatcher::add(const QByteArray &path, int target)
+{
+    // keys separated by dots, array elements as [n]
+    int node = 0;
+    int pos = 0;
+    int size = path.size();
+    while (pos < size)
+    {
+        if (path.at(pos) == '[')
+        {
+            int close = path.indexOf(']', pos);
+            bool ok = false;
+            int index = close > pos + 1 ? path.mid(pos + 1, close - pos - 1).toInt(&ok) : -1;
+            if (!ok || index < 0)
+            {
+                return false;
+            }
+            node = child(node, QByteArray(), index);
+            pos = close + 1;
+        }
+        else
+        {
+            int end = pos;
+            while (end < size && path.at(end) != '.' && path.at(end) != '[')
+            {
+                end++;
+            }
+            if (end == pos)
+            {
+                return false;
+            }
+            node = child(node, path.mid(pos, end - pos), -1);
+            pos = end;
+        }
+        if (pos < size && path.at(pos) == '.')
+        {
+            pos++;
+            if (pos == size)
+            {
+                return false;
+            }
+        }
+    }
+    if (node == 0 || m_nodes.at(node).target >= 0 || target < 0)
+    {
+        return false;
+    }
+
+    m_nodes[node].target = target;
+    m_targets = qMax(m_targets, target + 1);
+    m_paths++;
+    return true;
+}
+
+int JsonMatcher::targets() const
+{
+    return m_targets;
+}
+
+int JsonMatcher::match(const char *data, int size, Value *values) const
+{
+    for (int i = 0; i < m_targets; i++)
+    {
+        values[i].begin = 0;
+        values[i].end = 0;
+    }
+
+    JsonScanner scanner(data, size);
+    int found = 0;
+    value(scanner, scanner.next(), 0, values, found);
+    return found;
+}
+
+int JsonMatcher::child(int parent, const QByteArray &key, int index)
+{
+    int last = -1;
+    for (int node = m_nodes.at(parent).child; node >= 0; node = m_nodes.at(node).sibling)
+    {
+        if (m_nodes.at(node).index == index && m_nodes.at(node).key == key)
+        {
+            return node;
+        }
+        last = node;
+    }
+
+    Node node;
+    node.key = key;
+    node.index = index;
+    node.target = -1;
+    node.child = -1;
+    node.sibling = -1;
+    m_nodes.append(node);
+    int created = m_nodes.size() - 1;
+    if (last < 0)
+    {
+        m_nodes[parent].child = created;
+    }
+    else
+    {
+        m_nodes[last].sibling = created;
+    }
+    return created;
+}
+
+bool JsonMatcher::value(JsonScanner &scanner, JsonScanner::Token token, int node, Value *values, int &found) const
+{
+    // returns true once every path is matched, the caller stops right away
+    const Node &current = m_nodes.at(node);
+    if (current.target >= 0 && token != JsonScanner::BeginObject && token != JsonScanner::BeginArray)
+    {
+        values[current.target].begin = scanner.begin();
+        values[current.target].end = scanner.end();
+        return ++found == m_paths;
+    }
+
+    if (token == JsonScanner::BeginObject)
+    {
+        while ((token = scanner.next()) != JsonScanner::End && token != JsonScanner::EndObject)
+        {
+            if (token != JsonScanner::Key)
+            {
+                continue;
+            }
+            int next = current.child;
+            while (next >= 0 && (m_nodes.at(next).index >= 0 || !scanner.equals(m_nodes.at(next).key.constData(), m_nodes.at(next).key.size())))
+            {
+                next = m_nodes.at(next).sibling;
+            }
+            if (next < 0)
+            {
+                scanner.skipValue();
+            }
+            else if (value(scanner, scanner.next(), next, values, found))
+            {
+                return true;
+            }
+        }
+    }
+    else if (token == JsonScanner::BeginArray)
+    {
+        int index = 0;
+        while ((token = scanner.next()) != JsonScanner::End && token != JsonScanner::EndArray)
+        {
+            int next = current.child;
+            while (next >= 0 && m_nodes.at(next).index != index)
+            {
+                next = m_nodes.at(next).sibling;
+            }
+            if (next < 0)
+            {
+                skip(scanner, token);
+            }
+            else if (value(scanner, token, next, values, found))
+            {
+                return true;
+            }
+            index++;
+        }
+    }
+    return false;
+}
+
+void JsonMatcher::skip(JsonScanner &scanner, JsonScanner::Token token)
+{
+    // skips the rest of a container whose opening token was already read
+    if (token != JsonScanner::BeginObject && token != JsonScanner::BeginArray)
+    {
+        return;
+    }
+    int depth = scanner.depth() - 1;
+    while (scanner.depth() > depth && scanner.next() != JsonScanner::End)
+    {
+    }
+}
+
+void JsonMatcher::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Parsers, m_nodes);
+    for (int i = 0; i < m_nodes.size(); i++)
+    {
+        report.add(MemoryReport::Parsers, m_nodes.at(i).key);
+    }
+}
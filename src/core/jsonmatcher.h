@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONMATCHER_H
+#define JSONMATCHER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "jsonscanner.h"
+
+class MemoryReport;
+
+/*
+ * A set of JSON paths like "result.Bid" or "data[0].price", compiled into a
+ * trie once. Matching a reply walks the trie along with the scanner: keys
+ * and array elements without a node are skipped unseen, and the scan stops
+ * as soon as every path has its value, so a reply costs about what the
+ * hand-written extraction in the exchange classes costs.
+ */
+class JsonMatcher
+{
+public:
+    struct Value
+    {
+        const char *begin;
+        const char *end;
+    };
+
+    JsonMatcher();
+
+    bool add(const QByteArray &path, int target);
+    int targets() const;
+
+    // values needs targets() entries, unmatched ones get a null begin;
+    // returns the number of paths matched
+    int match(const char *data, int size, Value *values) const;
+    void measure(MemoryReport &report) const;
+
+private:
+    struct Node
+    {
+        QByteArray key;
+        int index;      // array element, -1 for object keys
+        int target;     // value slot of a path ending here, -1 otherwise
+        int child;
+        int sibling;
+    };
+
+    int child(int parent, const QByteArray &key, int index);
+    bool value(JsonScanner &scanner, JsonScanner::Token token, int node, Value *values, int &found) const;
+    static void skip(JsonScanner &scanner, JsonScanner::Token token);
+
+    QVector<Node> m_nodes;
+    int m_targets;
+    int m_paths;
+};
+
+#endif // JSONMATCHER_H
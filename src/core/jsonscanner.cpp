@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "jsonscanner.h"
+
+JsonScanner::JsonScanner(const char *data, int size)
+    :   m_pos(data)
+    ,   m_end(data + size)
+    ,   m_tokenBegin(data)
+    ,   m_tokenEnd(data)
+    ,   m_depth(0)
+{
+}
+
+JsonScanner::Token JsonScanner::next()
+{
+    while (m_pos < m_end)
+    {
+        char c = *m_pos;
+        m_tokenBegin = m_pos;
+        m_tokenEnd = ++m_pos;
+
+        switch (c)
+        {
+        case '{':
+            m_depth++;
+            return BeginObject;
+        case '}':
+            if (m_depth > 0)
+            {
+                m_depth--;
+            }
+            return EndObject;
+        case '[':
+            m_depth++;
+            return BeginArray;
+        case ']':
+            if (m_depth > 0)
+            {
+                m_depth--;
+            }
+            return EndArray;
+        case '"':
+        {
+            m_tokenBegin = m_pos;
+            while (m_pos < m_end && *m_pos != '"')
+            {
+                if (*m_pos == '\\' && m_pos + 1 < m_end)
+                {
+                    m_pos++;
+                }
+                m_pos++;
+            }
+            m_tokenEnd = m_pos;
+            if (m_pos < m_end)
+            {
+                m_pos++;
+            }
+            // a string followed by a colon is an object key
+            const char *p = m_pos;
+            while (p < m_end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+            {
+                p++;
+            }
+            if (p < m_end && *p == ':')
+            {
+                m_pos = p + 1;
+                return Key;
+            }
+            return String;
+        }
+        default:
+            if (c == '-' || (c >= '0' && c <= '9'))
+            {
+                while (m_pos < m_end && ((*m_pos >= '0' && *m_pos <= '9') || *m_pos == '.'
+                        || *m_pos == 'e' || *m_pos == 'E' || *m_pos == '+' || *m_pos == '-'))
+                {
+                    m_pos++;
+                }
+                m_tokenEnd = m_pos;
+                return Number;
+            }
+            if (c >= 'a' && c <= 'z')
+            {
+                while (m_pos < m_end && *m_pos >= 'a' && *m_pos <= 'z')
+                {
+                    m_pos++;
+                }
+                m_tokenEnd = m_pos;
+                return Literal;
+            }
+            // whitespace, separators and garbage
+            break;
+        }
+    }
+    m_tokenBegin = m_tokenEnd = m_end;
+    return End;
+}
+
+void JsonScanner::skipValue()
+{
+    // skips the value following a key, including nested containers
+    int depth = m_depth;
+    Token token = next();
+    if (token != BeginObject && token != BeginArray)
+    {
+        return;
+    }
+    while (m_depth > depth && token != End)
+    {
+        token = next();
+    }
+}
+
+const char *JsonScanner::begin() const
+{
+    return m_tokenBegin;
+}
+
+const char *JsonScanner::end() const
+{
+    return m_tokenEnd;
+}
+
+int JsonScanner::size() const
+{
+    return int(m_tokenEnd - m_tokenBegin);
+}
+
+int JsonScanner::depth() const
+{
+    return m_depth;
+}
+
+bool JsonScanner::equals(const char *str, int size) const
+{
+    return size == this->size() && memcmp(m_tokenBegin, str, size) == 0;
+}
+
+bool JsonScanner::equals(const char *str) const
+{
+    return equals(str, int(strlen(str)));
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONSCANNER_H
+#define JSONSCANNER_H
+
+#include <QtGlobal>
+
+/*
+ * Forward-only, allocation-free JSON tokenizer working directly on the bytes
+ * of a reply. Tokens point into the original buffer, strings are returned
+ * without their quotes and without unescaping. The scanner is lenient on
+ * purpose: bytes it does not understand are skipped, which keeps it usable on
+ * the not-quite-valid replies some exchanges send.
+ */
+class JsonScanner
+{
+public:
+    enum Token {
+        End,
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Key,
+        String,
+        Number,
+        Literal
+    };
+
+    JsonScanner(const char *data, int size);
+
+    Token next();
+    void skipValue();
+
+    const char *begin() const;
+    const char *end() const;
+    int size() const;
+    int depth() const;
+
+    bool equals(const char *str, int size) const;
+    bool equals(const char *str) const;
+
+private:
+    const char *m_pos;
+    const char *m_end;
+    const char *m_tokenBegin;
+    const char *m_tokenEnd;
+    int m_depth;
+};
+
+#endif // JSONSCANNER_H
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+#include "memoryreport.h"
+
+namespace {
+    static const char *NAMES[MemoryReport::SubsystemCount] = {
+        "network",
+        "parsers",
+        "prices",
+        "history",
+        "ui"
+    };
+
+    // a "VmRSS:    1234 kB" line of /proc/self/status, in bytes
+    qint64 statusField(const QByteArray &status, const char *field)
+    {
+        int pos = status.indexOf(field);
+        if (pos < 0)
+        {
+            return 0;
+        }
+        int end = status.indexOf('\n', pos);
+        QByteArray value = status.mid(pos + qstrlen(field), end < 0 ? -1 : end - pos - qstrlen(field));
+        return value.replace("kB", "").trimmed().toLongLong() * 1024;
+    }
+}
+
+MemoryReport::MemoryReport()
+    :   m_resident(0)
+    ,   m_peak(0)
+{
+    // not available outside linux, the figures stay zero
+    QFile file("/proc/self/status");
+    if (file.open(QIODevice::ReadOnly))
+    {
+        QByteArray status = file.readAll();
+        m_resident = statusField(status, "VmRSS:");
+        m_peak = statusField(status, "VmHWM:");
+    }
+}
+
+void MemoryReport::add(Subsystem subsystem, qint64 bytes, qint64 objects)
+{
+    m_usage[subsystem].bytes += bytes;
+    m_usage[subsystem].objects += objects;
+}
+
+void MemoryReport::add(Subsystem subsystem, const QByteArray &data)
+{
+    if (data.capacity() > 0)
+    {
+        add(subsystem, data.capacity());
+    }
+}
+
+void MemoryReport::add(Subsystem subsystem, const QString &text)
+{
+    if (text.capacity() > 0)
+    {
+        add(subsystem, qint64(text.capacity()) * sizeof(QChar));
+    }
+}
+
+void MemoryReport::add(Subsystem subsystem, const QNetworkAccessManager &manager)
+{
+    // replies are children of their manager until they are deleted
+    add(subsystem, sizeof(QNetworkAccessManager));
+    QList<QNetworkReply *> replies = manager.findChildren<QNetworkReply *>();
+    for (int i = 0; i < replies.size(); i++)
+    {
+        add(subsystem, sizeof(QNetworkReply) + replies.at(i)->bytesAvailable());
+    }
+}
+
+const MemoryUsage &MemoryReport::usage(Subsystem subsystem) const
+{
+    return m_usage[subsystem];
+}
+
+MemoryUsage MemoryReport::total() const
+{
+    MemoryUsage total;
+    for (int i = 0; i < SubsystemCount; i++)
+    {
+        total.bytes += m_usage[i].bytes;
+        total.objects += m_usage[i].objects;
+    }
+    return total;
+}
+
+qint64 MemoryReport::resident() const
+{
+    return m_resident;
+}
+
+qint64 MemoryReport::peak() const
+{
+    return m_peak;
+}
+
+QByteArray MemoryReport::toText() const
+{
+    QByteArray text;
+    for (int i = 0; i <= SubsystemCount; i++)
+    {
+        MemoryUsage usage = i < SubsystemCount ? m_usage[i] : total();
+        QByteArray label = i < SubsystemCount ? QByteArray(NAMES[i]) : QByteArray("total");
+        text.append(label.leftJustified(10, ' '))
+            .append(QByteArray::number(usage.bytes / 1024.0, 'f', 1).rightJustified(10, ' ')).append(" kB")
+            .append(QByteArray::number(usage.objects).rightJustified(8, ' ')).append(" objects\n");
+    }
+    text.append(QByteArray("resident").leftJustified(10, ' '))
+        .append(QByteArray::number(m_resident / 1024.0, 'f', 1).rightJustified(10, ' ')).append(" kB, peak ")
+        .append(QByteArray::number(m_peak / 1024.0, 'f', 1)).append(" kB\n");
+    return text;
+}
+
+QByteArray MemoryReport::toJson() const
+{
+    QByteArray json("{");
+    for (int i = 0; i < SubsystemCount; i++)
+    {
+        json.append('"').append(NAMES[i]).append("\":{\"bytes\":").append(QByteArray::number(m_usage[i].bytes))
+            .append(",\"objects\":").append(QByteArray::number(m_usage[i].objects)).append("},");
+    }
+    json.append("\"resident\":").append(QByteArray::number(m_resident))
+        .append(",\"peak\":").append(QByteArray::number(m_peak)).append("}\n");
+    return json;
+}
+
+const char *MemoryReport::name(Subsystem subsystem)
+{
+    return NAMES[subsystem];
+}
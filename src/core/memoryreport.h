@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "ring.h"
+
+class QNetworkAccessManager;
+
+struct MemoryUsage
+{
+    MemoryUsage()
+        :   bytes(0)
+        ,   objects(0)
+    {
+    }
+
+    qint64 bytes;
+    qint64 objects;
+};
+
+/*
+ * Live heap bytes and object counts per subsystem, filled in by the
+ * measure() methods of the parts of the core. Containers count with their
+ * capacity, hash and map nodes with the size of their entries, so the
+ * figures are a lower bound of what the allocator sees. Network counts the
+ * replies a manager still holds, deleted later or not, with their buffered
+ * bytes. The resident and peak set sizes of the process are sampled when
+ * the report is created.
+ */
+class MemoryReport
+{
+public:
+    enum Subsystem {
+        Network,
+        Parsers,
+        Prices,
+        History,
+        Ui,
+        SubsystemCount
+    };
+
+    MemoryReport();
+
+    void add(Subsystem subsystem, qint64 bytes, qint64 objects = 1);
+    void add(Subsystem subsystem, const QByteArray &data);
+    void add(Subsystem subsystem, const QString &text);
+    void add(Subsystem subsystem, const QNetworkAccessManager &manager);
+
+    template <typename T>
+    void add(Subsystem subsystem, const QVector<T> &vector)
+    {
+        if (vector.capacity() > 0)
+        {
+            add(subsystem, qint64(vector.capacity()) * sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void add(Subsystem subsystem, const Ring<T> &ring)
+    {
+        add(subsystem, qint64(ring.capacity()) * sizeof(T));
+    }
+
+    const MemoryUsage &usage(Subsystem subsystem) const;
+    MemoryUsage total() const;
+    qint64 resident() const;
+    qint64 peak() const;
+
+    QByteArray toText() const;
+    QByteArray toJson() const;
+
+    static const char *name(Subsystem subsystem);
+
+private:
+    MemoryUsage m_usage[SubsystemCount];
+    qint64 m_resident;
+    qint64 m_peak;
+};
+
+#endif // MEMORYREPORT_H
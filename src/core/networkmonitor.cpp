@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QList>
+#include <QNetworkConfiguration>
+
+#include "networkmonitor.h"
+
+NetworkMonitor::NetworkMonitor(QObject *parent)
+    :   QObject(parent)
+    ,   m_manager(this)
+{
+    m_online = m_manager.isOnline();
+    m_metered = detectMetered();
+    connect(&m_manager, SIGNAL(onlineStateChanged(bool)), this, SLOT(onOnlineStateChanged(bool)));
+    connect(&m_manager, SIGNAL(configurationChanged(QNetworkConfiguration)), this, SLOT(onConfigurationChanged(QNetworkConfiguration)));
+}
+
+NetworkMonitor::~NetworkMonitor()
+{
+}
+
+bool NetworkMonitor::isOnline()
+{
+    return m_online;
+}
+
+bool NetworkMonitor::isMetered()
+{
+    return m_metered;
+}
+
+void NetworkMonitor::onOnlineStateChanged(bool online)
+{
+    // the bearer first, a poll on reconnect already sees the right one
+    updateMetered();
+    if (online != m_online)
+    {
+        m_online = online;
+        emit onlineChanged(online);
+    }
+}
+
+void NetworkMonitor::onConfigurationChanged(const QNetworkConfiguration &config)
+{
+    Q_UNUSED(config);
+    updateMetered();
+}
+
+void NetworkMonitor::updateMetered()
+{
+    bool metered = detectMetered();
+    if (metered != m_metered)
+    {
+        m_metered = metered;
+        emit meteredChanged(metered);
+    }
+}
+
+bool NetworkMonitor::detectMetered()
+{
+    // any active wlan or ethernet connection is considered unmetered,
+    // everything else carrying traffic is a cellular bearer
+    QList<QNetworkConfiguration> active = m_manager.allConfigurations(QNetworkConfiguration::Active);
+    bool cellular = false;
+    for (int i = 0; i < active.size(); i++)
+    {
+        switch (active.at(i).bearerType())
+        {
+        case QNetworkConfiguration::BearerWLAN:
+        case QNetworkConfiguration::BearerEthernet:
+            return false;
+        case QNetworkConfiguration::BearerUnknown:
+        case QNetworkConfiguration::BearerBluetooth:
+            break;
+        default:
+            cellular = true;
+            break;
+        }
+    }
+    return cellular;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETWORKMONITOR_H
+#define NETWORKMONITOR_H
+
+#include <QObject>
+#include <QNetworkConfigurationManager>
+
+/*
+ * Watches the reachability and bearer type of the device so the ticker
+ * handler can pause polling while offline and poll less often on metered
+ * cellular connections.
+ */
+class NetworkMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NetworkMonitor(QObject *parent = 0);
+    ~NetworkMonitor();
+
+    bool isOnline();
+    bool isMetered();
+
+signals:
+    void onlineChanged(bool online);
+    void meteredChanged(bool metered);
+
+private slots:
+    void onOnlineStateChanged(bool online);
+    void onConfigurationChanged(const QNetworkConfiguration &config);
+
+private:
+    void updateMetered();
+    bool detectMetered();
+
+    bool m_online;
+    bool m_metered;
+
+    QNetworkConfigurationManager m_manager;
+};
+
+#endif // NETWORKMONITOR_H
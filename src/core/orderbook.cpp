@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+
+#include "orderbook.h"
+#include "memoryreport.h"
+
+namespace {
+    static const double POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+    };
+}
+
+OrderBook::OrderBook()
+    :   updated(0)
+    ,   m_scale(Price::DefaultScale)
+{
+}
+
+void OrderBook::clear(int scale)
+{
+    for (int side = Bids; side <= Asks; side++)
+    {
+        m_sides[side].prices.clear();
+        m_sides[side].quantity.clear();
+        m_sides[side].cost.clear();
+    }
+    m_scale = scale;
+}
+
+bool OrderBook::add(Side side, const Price &price, double quantity)
+{
+    // levels have to arrive best first, equal prices are merged and anything
+    // out of order is dropped so the binary searches stay valid
+    Levels &levels = m_sides[side];
+    qint64 mantissa = price.rescaled(m_scale).mantissa();
+    if (mantissa <= 0 || !(quantity > 0.0))
+    {
+        return false;
+    }
+
+    double cost = quantity * toDouble(mantissa, m_scale);
+    if (!levels.prices.isEmpty())
+    {
+        qint64 last = levels.prices.last();
+        if (mantissa == last)
+        {
+            levels.quantity.last() += quantity;
+            levels.cost.last() += cost;
+            return true;
+        }
+        if (better(side, mantissa, last))
+        {
+            return false;
+        }
+    }
+    if (levels.prices.size() >= MaxLevels)
+    {
+        return false;
+    }
+
+    double quantityBefore = levels.quantity.isEmpty() ? 0.0 : levels.quantity.last();
+    double costBefore = levels.cost.isEmpty() ? 0.0 : levels.cost.last();
+    levels.prices.append(mantissa);
+    levels.quantity.append(quantityBefore + quantity);
+    levels.cost.append(costBefore + cost);
+    return true;
+}
+
+int OrderBook::scale() const
+{
+    return m_scale;
+}
+
+int OrderBook::levels(Side side) const
+{
+    return m_sides[side].prices.size();
+}
+
+bool OrderBook::isEmpty(Side side) const
+{
+    return m_sides[side].prices.isEmpty();
+}
+
+Price OrderBook::best(Side side) const
+{
+    const Levels &levels = m_sides[side];
+    return Price(levels.prices.isEmpty() ? 0 : levels.prices.first(), m_scale);
+}
+
+qint64 OrderBook::worst(Side side) const
+{
+    const Levels &levels = m_sides[side];
+    return levels.prices.isEmpty() ? 0 : levels.prices.last();
+}
+
+double OrderBook::total(Side side) const
+{
+    const Levels &levels = m_sides[side];
+    return levels.quantity.isEmpty() ? 0.0 : levels.quantity.last();
+}
+
+OrderBook::Fill OrderBook::fill(Side side, double amount) const
+{
+    const Levels &levels = m_sides[side];
+    Fill fill;
+    if (levels.prices.isEmpty() || !(amount > 0.0))
+    {
+        fill.complete = !(amount > 0.0);
+        return fill;
+    }
+
+    // first level whose running quantity covers the order
+    int index = int(std::lower_bound(levels.quantity.constBegin(), levels.quantity.constEnd(), amount)
+                    - levels.quantity.constBegin());
+    if (index == levels.prices.size())
+    {
+        fill.amount = levels.quantity.last();
+        fill.cost = levels.cost.last();
+    }
+    else
+    {
+        double quantityBefore = index > 0 ? levels.quantity.at(index - 1) : 0.0;
+        double costBefore = index > 0 ? levels.cost.at(index - 1) : 0.0;
+        fill.amount = amount;
+        fill.cost = costBefore + (amount - quantityBefore) * toDouble(levels.prices.at(index), m_scale);
+        fill.complete = true;
+    }
+
+    double best = toDouble(levels.prices.first(), m_scale);
+    fill.average = fill.cost / fill.amount;
+    fill.slippage = qAbs(fill.average - best) / best;
+    return fill;
+}
+
+double OrderBook::within(Side side, qint64 limit, double *cost) const
+{
+    // quantity of all levels at or better than the limit
+    const Levels &levels = m_sides[side];
+    QVector<qint64>::const_iterator end;
+    if (side == Asks)
+    {
+        end = std::upper_bound(levels.prices.constBegin(), levels.prices.constEnd(), limit);
+    }
+    else
+    {
+        end = std::upper_bound(levels.prices.constBegin(), levels.prices.constEnd(), limit, std::greater<qint64>());
+    }
+    int count = int(end - levels.prices.constBegin());
+    if (cost)
+    {
+        *cost = count > 0 ? levels.cost.at(count - 1) : 0.0;
+    }
+    return count > 0 ? levels.quantity.at(count - 1) : 0.0;
+}
+
+bool OrderBook::better(Side side, qint64 price, qint64 limit)
+{
+    return side == Asks ? price < limit : price > limit;
+}
+
+OrderBook::Fill OrderBook::split(const QVector<const OrderBook *> &books, Side side, double amount,
+                                 QVector<double> *shares)
+{
+    Fill fill;
+    if (shares)
+    {
+        shares->fill(0.0, books.size());
+    }
+
+    // the best and worst price over all books bound the marginal price
+    int count = 0;
+    int scale = Price::DefaultScale;
+    qint64 best = 0;
+    qint64 worst = 0;
+    double total = 0.0;
+    for (int i = 0; i < books.size(); i++)
+    {
+        const OrderBook *book = books.at(i);
+        if (book->isEmpty(side))
+        {
+            continue;
+        }
+        Q_ASSERT(count == 0 || book->scale() == scale);
+        qint64 first = book->best(side).mantissa();
+        qint64 last = book->worst(side);
+        if (count == 0 || better(side, first, best))
+        {
+            best = first;
+        }
+        if (count == 0 || better(side, worst, last))
+        {
+            worst = last;
+        }
+        scale = book->scale();
+        total += book->total(side);
+        count++;
+    }
+    if (count == 0 || !(amount > 0.0))
+    {
+        fill.complete = !(amount > 0.0);
+        return fill;
+    }
+
+    // bisect the price at which the books together cover the order; the
+    // depth up to a price is a binary search per book
+    qint64 limit = worst;
+    if (amount < total)
+    {
+        qint64 low = qMin(best, worst);
+        qint64 high = qMax(best, worst);
+        while (low < high)
+        {
+            qint64 middle = (side == Asks) ? low + (high - low) / 2 : low + (high - low + 1) / 2;
+            double depth = 0.0;
+            for (int i = 0; i < books.size(); i++)
+            {
+                depth += books.at(i)->within(side, middle);
+            }
+            bool covered = depth >= amount;
+            if (side == Asks && covered)
+            {
+                high = middle;
+            }
+            else if (side == Asks)
+            {
+                low = middle + 1;
+            }
+            else if (covered)
+            {
+                low = middle;
+            }
+            else
+            {
+                high = middle - 1;
+            }
+        }
+        limit = low;
+    }
+
+    // everything strictly better than the limit is taken in full, the rest
+    // comes from the books quoting the limit itself
+    qint64 inside = (side == Asks) ? limit - 1 : limit + 1;
+    double price = toDouble(limit, scale);
+    double remaining = amount;
+    for (int i = 0; i < books.size(); i++)
+    {
+        double cost = 0.0;
+        double taken = books.at(i)->within(side, inside, &cost);
+        remaining -= taken;
+        fill.amount += taken;
+        fill.cost += cost;
+        if (shares)
+        {
+            (*shares)[i] = taken;
+        }
+    }
+    for (int i = 0; i < books.size() && remaining > 0.0; i++)
+    {
+        double available = books.at(i)->within(side, limit) - books.at(i)->within(side, inside);
+        double taken = qMin(available, remaining);
+        remaining -= taken;
+        fill.amount += taken;
+        fill.cost += taken * price;
+        if (shares)
+        {
+            (*shares)[i] += taken;
+        }
+    }
+
+    fill.complete = amount <= total;
+    double reference = toDouble(best, scale);
+    fill.average = fill.amount > 0.0 ? fill.cost / fill.amount : 0.0;
+    fill.slippage = fill.amount > 0.0 ? qAbs(fill.average - reference) / reference : 0.0;
+    return fill;
+}
+
+double OrderBook::toDouble(qint64 mantissa, int scale)
+{
+    return double(mantissa) / POW10[qBound(0, scale, int(Price::MaxScale))];
+}
+
+OrderBooks::OrderBooks()
+    :   m_books(Symbols::count())
+{
+    for (int pair = 0; pair < m_books.size(); pair++)
+    {
+        m_books[pair].clear(Symbols::info(pair).scale);
+    }
+}
+
+const OrderBook &OrderBooks::book(int pair) const
+{
+    return m_books.at(pair);
+}
+
+OrderBook &OrderBooks::book(int pair)
+{
+    return m_books[pair];
+}
+
+void OrderBook::measure(MemoryReport &report) const
+{
+    for (int side = 0; side < 2; side++)
+    {
+        report.add(MemoryReport::Prices, m_sides[side].prices);
+        report.add(MemoryReport::Prices, m_sides[side].quantity);
+        report.add(MemoryReport::Prices, m_sides[side].cost);
+    }
+}
+
+void OrderBooks::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Prices, m_books);
+    for (int pair = 0; pair < m_books.size(); pair++)
+    {
+        m_books.at(pair).measure(report);
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ORDERBOOK_H
+#define ORDERBOOK_H
+
+#include <QVector>
+
+#include "price.h"
+#include "symbols.h"
+
+class MemoryReport;
+
+/*
+ * Depth of a single market. Each side keeps its levels best first together
+ * with running sums of quantity and cost, so the fill of any order size is
+ * one binary search over the cumulative quantity plus a partial level, and
+ * the depth up to a price limit is one binary search over the prices.
+ * Quantities are in the base asset, costs in the quote asset.
+ */
+class OrderBook
+{
+public:
+    enum Side {
+        Bids,   // consumed by sells
+        Asks    // consumed by buys
+    };
+
+    enum {
+        MaxLevels = 500
+    };
+
+    struct Fill
+    {
+        Fill()
+            :   amount(0.0)
+            ,   cost(0.0)
+            ,   average(0.0)
+            ,   slippage(0.0)
+            ,   complete(false)
+        {
+        }
+
+        double amount;      // filled base amount, less than asked if incomplete
+        double cost;        // quote amount paid or received
+        double average;     // cost / amount
+        double slippage;    // relative distance of the average from the best level
+        bool complete;
+    };
+
+    OrderBook();
+
+    void clear(int scale);
+    bool add(Side side, const Price &price, double quantity);
+
+    int scale() const;
+    int levels(Side side) const;
+    bool isEmpty(Side side) const;
+    Price best(Side side) const;
+    qint64 worst(Side side) const;
+    double total(Side side) const;
+
+    Fill fill(Side side, double amount) const;
+    double within(Side side, qint64 limit, double *cost = 0) const;
+    static bool better(Side side, qint64 price, qint64 limit);
+
+    // optimal split of an order over the books of one asset pair, the
+    // amounts taken from each book are written to shares if given
+    static Fill split(const QVector<const OrderBook *> &books, Side side, double amount,
+                      QVector<double> *shares = 0);
+
+    void measure(MemoryReport &report) const;
+
+    uint updated;
+
+private:
+    struct Levels
+    {
+        QVector<qint64> prices;
+        QVector<double> quantity;   // cumulative
+        QVector<double> cost;       // cumulative
+    };
+
+    static double toDouble(qint64 mantissa, int scale);
+
+    Levels m_sides[2];
+    int m_scale;
+};
+
+/*
+ * Order books of all markets, indexed by pair id like the price table.
+ */
+class OrderBooks
+{
+public:
+    OrderBooks();
+
+    const OrderBook &book(int pair) const;
+    OrderBook &book(int pair);
+
+    void measure(MemoryReport &report) const;
+
+private:
+    QVector<OrderBook> m_books;
+};
+
+#endif // ORDERBOOK_H
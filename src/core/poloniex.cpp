@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QByteArray>
+#include <QUrl>
+#include <QDateTime>
+
+#include "poloniex.h"
+#include "jsonscanner.h"
+#include "trace.h"
+#include "memoryreport.h"
+
+namespace {
+    static const QString TICKER = "https://poloniex.com/public?command=returnTicker";
+    static const QString ORDERBOOK = "https://poloniex.com/public?command=returnOrderBook&depth=%1&currencyPair=";
+
+    static const int FIRST = Pair::PoloniexBtcUsd;
+    static const int MARKET_COUNT = Pair::PoloniexXmrBtc - Pair::PoloniexBtcUsd + 1;
+
+    struct FieldKey
+    {
+        const char *key;
+        PriceTable::Field field;
+    };
+
+    // the market "BTC_XMR" trades XMR, so its quoteVolume is our base volume
+    static const FieldKey FIELDS[] = {
+        { "highestBid", PriceTable::Bid },
+        { "lowestAsk", PriceTable::Ask },
+        { "last", PriceTable::Last },
+        { "high24hr", PriceTable::High },
+        { "low24hr", PriceTable::Low },
+        { "quoteVolume", PriceTable::Volume },
+        { "percentChange", PriceTable::Change }
+    };
+
+    static const int FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+    struct Record
+    {
+        Record()
+            :   found(0)
+        {
+        }
+
+        Price fields[PriceTable::FieldCount];
+        quint8 found;
+    };
+}
+
+PoloniEx::PoloniEx(PriceTable *prices, OrderBooks *books, DataUsage *usage, QObject *parent)
+    :   QObject(parent)
+    ,   m_prices(prices)
+    ,   m_books(books)
+    ,   m_usage(usage)
+    ,   m_tickerManager(this)
+    ,   m_bookManager(this)
+{
+    connect(&m_tickerManager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onTickerResult(QNetworkReply*)));
+    connect(&m_bookManager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onBookResult(QNetworkReply*)));
+}
+
+PoloniEx::~PoloniEx()
+{
+}
+
+bool PoloniEx::fetch()
+{
+    if (!m_breaker.allowRequest(QDateTime::currentDateTime().toTime_t()))
+    {
+        return false;
+    }
+
+    QNetworkRequest request;
+    request.setUrl(QUrl(TICKER));
+    Trace::stamp(request);
+    m_tickerManager.get(request);
+    m_breaker.requestStarted();
+    return true;
+}
+
+bool PoloniEx::fetchBook(int pair)
+{
+    // books are fetched on demand and stay out of the breaker's cycles, but
+    // an exchange the breaker gave up on is not asked either
+    if (pair < FIRST || pair >= FIRST + MARKET_COUNT || m_breaker.state() != CircuitBreaker::Closed)
+    {
+        return false;
+    }
+
+    QNetworkRequest request;
+    request.setUrl(QUrl(QString(ORDERBOOK).arg(int(OrderBook::MaxLevels)).append(Symbols::info(pair).market)));
+    request.setAttribute(QNetworkRequest::User, pair);
+    m_bookManager.get(request);
+    return true;
+}
+
+void PoloniEx::onTickerResult(QNetworkReply* reply)
+{
+    Trace::finished(reply, "poloniex", "request");
+    m_usage->add(Exchange::Poloniex, reply);
+    Record records[MARKET_COUNT];
+
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        TRACE_SCOPE("poloniex", "parse");
+        QByteArray data = reply->readAll();
+        JsonScanner scanner(data.constData(), data.size());
+        JsonScanner::Token token;
+        int pair = Pair::Invalid;
+        while ((token = scanner.next()) != JsonScanner::End)
+        {
+            if (token != JsonScanner::Key)
+            {
+                continue;
+            }
+            if (scanner.depth() == 1)
+            {
+                // one hash per market key, untracked markets are skipped
+                // without looking at their fields
+                pair = Symbols::lookup(Exchange::Poloniex, scanner.begin(), scanner.size());
+                if (pair == Pair::Invalid)
+                {
+                    scanner.skipValue();
+                }
+            }
+            else if (pair != Pair::Invalid && scanner.depth() == 2)
+            {
+                for (int i = 0; i < FIELD_COUNT; i++)
+                {
+                    if (scanner.equals(FIELDS[i].key))
+                    {
+                        PriceTable::Field field = FIELDS[i].field;
+                        Record &record = records[pair - FIRST];
+                        bool ok = false;
+                        scanner.next();
+                        record.fields[field] = Price::parse(scanner.begin(), scanner.end(),
+                                                            PriceTable::scale(pair, field), &ok);
+                        if (ok)
+                        {
+                            record.found |= (1 << field);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    reply->deleteLater();
+
+    TRACE_SCOPE("poloniex", "store");
+    uint now = QDateTime::currentDateTime().toTime_t();
+    bool success = false;
+    for (int i = 0; i < MARKET_COUNT; i++)
+    {
+        const Record &record = records[i];
+        if (record.fields[PriceTable::Bid].isValid())
+        {
+            for (int field = PriceTable::Ask; field < PriceTable::FieldCount; field++)
+            {
+                if (record.found & (1 << field))
+                {
+                    m_prices->setField(FIRST + i, PriceTable::Field(field), record.fields[field]);
+                }
+            }
+            m_prices->quote(FIRST + i).update(record.fields[PriceTable::Bid], now);
+            emit quoteUpdated(FIRST + i);
+            success = true;
+        }
+        else
+        {
+            m_prices->quote(FIRST + i).fail();
+        }
+    }
+    m_breaker.requestFinished(success, now);
+    if (m_breaker.pending() == 0)
+    {
+        emit fetched();
+    }
+}
+
+void PoloniEx::onBookResult(QNetworkReply* reply)
+{
+    int pair = reply->request().attribute(QNetworkRequest::User).toInt();
+    m_usage->add(Exchange::Poloniex, reply);
+
+    OrderBook book;
+    book.clear(Symbols::info(pair).scale);
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        QByteArray data = reply->readAll();
+
+        // {"asks":[["0.0123",1.5],...],"bids":[...],"isFrozen":"0"}, every
+        // level is a two element array of price and quantity
+        JsonScanner scanner(data.constData(), data.size());
+        JsonScanner::Token token;
+        int side = -1;
+        int element = 0;
+        Price price;
+        while ((token = scanner.next()) != JsonScanner::End)
+        {
+            if (token == JsonScanner::Key && scanner.depth() == 1)
+            {
+                side = scanner.equals("bids") ? int(OrderBook::Bids) : scanner.equals("asks") ? int(OrderBook::Asks) : -1;
+            }
+            else if (token == JsonScanner::BeginArray && scanner.depth() == 3)
+            {
+                element = 0;
+            }
+            else if (side >= 0 && scanner.depth() == 3 && (token == JsonScanner::String || token == JsonScanner::Number))
+            {
+                if (element == 0)
+                {
+                    price = Price::parse(scanner.begin(), scanner.end(), Symbols::info(pair).scale);
+                }
+                else if (element == 1)
+                {
+                    book.add(OrderBook::Side(side), price, Price::parse(scanner.begin(), scanner.end()).toDouble());
+                }
+                element++;
+            }
+        }
+    }
+    reply->deleteLater();
+
+    if (!book.isEmpty(OrderBook::Bids) || !book.isEmpty(OrderBook::Asks))
+    {
+        book.updated = QDateTime::currentDateTime().toTime_t();
+        m_books->book(pair) = book;
+        emit bookUpdated(pair);
+    }
+}
+
+void PoloniEx::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Network, m_tickerManager);
+    report.add(MemoryReport::Network, m_bookManager);
+}
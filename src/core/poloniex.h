@@ -15,41 +15,49 @@
  * this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef POLONIEX_H
+#define POLONIEX_H
+
 #include <QObject>
 #include <QNetworkAccessManager>
 
+#include "pricetable.h"
+#include "orderbook.h"
+#include "circuitbreaker.h"
+#include "datausage.h"
+
+class MemoryReport;
+
 class PoloniEx : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit PoloniEx(QObject *parent = 0);
+    PoloniEx(PriceTable *prices, OrderBooks *books, DataUsage *usage, QObject *parent = 0);
     ~PoloniEx();
 
-    double getBtcUsd();
-    double getXmrUsd();
-    double getDrkBtc();
-    double getDrkXmr();
-    double getBtcdBtc();
-    double getBtcdXmr();
-    double getXcBtc();
-    double getXmrBtc();
+    bool fetch();
+    void measure(MemoryReport &report) const;
+    bool fetchBook(int pair);
 
-    void fetch();
+signals:
+    void quoteUpdated(int pair);
+    void bookUpdated(int pair);
+    void fetched();
 
 public slots:
     void onTickerResult(QNetworkReply* reply);
+    void onBookResult(QNetworkReply* reply);
 
 private:
-    double m_pairBtcUsd;
-    double m_pairXmrUsd;
-    double m_pairDrkBtc;
-    double m_pairDrkXmr;
-    double m_pairBtcdBtc;
-    double m_pairBtcdXmr;
-    double m_pairXcBtc;
-    double m_pairXmrBtc;
+    PriceTable *m_prices;
+    OrderBooks *m_books;
+    DataUsage *m_usage;
+    CircuitBreaker m_breaker;
 
     QNetworkAccessManager m_tickerManager;
+    QNetworkAccessManager m_bookManager;
 
 };
+
+#endif // POLONIEX_H
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <QtEndian>
+
+#include "portfolio.h"
+#include "memoryreport.h"
+
+namespace {
+    static const uint DAY = 24 * 60 * 60;
+    static const int AMOUNT_SCALE = 8;
+    static const int USD_SCALE = 4;
+}
+
+Portfolio::Portfolio(const PriceTable *prices, QObject *parent)
+    :   QObject(parent)
+    ,   m_prices(prices)
+    ,   m_dependents(Symbols::count())
+    ,   m_usdRate(0.0)
+    ,   m_totalBtc(0.0)
+    ,   m_day(0)
+    ,   m_stored(0)
+    ,   m_storedBtc(0.0)
+    ,   m_recording(true)
+    ,   m_holdings(QString("holdings.dat"), HoldingRecordSize)
+    ,   m_valuations(QString("valuation.dat"), ValuationRecordSize)
+{
+    // bitcoin is valued at par, every other coin through its btc markets
+    Position bitcoin;
+    bitcoin.asset = "BTC";
+    bitcoin.amount = 0.0;
+    bitcoin.rate = 1.0;
+    bitcoin.value = 0.0;
+    m_positions.append(bitcoin);
+
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        const PairInfo &info = Symbols::info(pair);
+        if (QLatin1String(info.quote) == QLatin1String("USD") && QLatin1String(info.base) == QLatin1String("BTC"))
+        {
+            m_usdPairs.append(pair);
+            continue;
+        }
+        if (QLatin1String(info.quote) != QLatin1String("BTC"))
+        {
+            continue;
+        }
+        int position = indexOf(info.base);
+        if (position < 0)
+        {
+            Position coin;
+            coin.asset = info.base;
+            coin.amount = 0.0;
+            coin.rate = 0.0;
+            coin.value = 0.0;
+            m_positions.append(coin);
+            position = m_positions.size() - 1;
+        }
+        m_positions[position].pairs.append(pair);
+        m_dependents[pair].append(position);
+    }
+
+    load();
+}
+
+Portfolio::~Portfolio()
+{
+}
+
+QStringList Portfolio::assets() const
+{
+    QStringList assets;
+    for (int i = 0; i < m_positions.size(); i++)
+    {
+        assets.append(m_positions.at(i).asset);
+    }
+    return assets;
+}
+
+void Portfolio::setHolding(const QString &asset, double amount)
+{
+    int position = indexOf(asset);
+    if (position < 0 || amount < 0.0)
+    {
+        return;
+    }
+
+    // append-only: the last record of an asset wins; a mirror only keeps
+    // the amount, the writer stores it
+    if (m_recording)
+    {
+        uchar record[HoldingRecordSize];
+        memset(record, 0, HoldingRecordSize);
+        QByteArray code = asset.toLatin1().left(8);
+        memcpy(record, code.constData(), code.size());
+        qToLittleEndian<qint64>(Price::fromDouble(amount, AMOUNT_SCALE).mantissa(), record + 8);
+        m_holdings.append(reinterpret_cast<const char *>(record));
+    }
+
+    m_positions[position].amount = amount;
+    recompute(position);
+    emit changed();
+}
+
+double Portfolio::holding(const QString &asset) const
+{
+    int position = indexOf(asset);
+    return position < 0 ? 0.0 : m_positions.at(position).amount;
+}
+
+double Portfolio::value(const QString &asset) const
+{
+    int position = indexOf(asset);
+    return position < 0 ? 0.0 : m_positions.at(position).value;
+}
+
+double Portfolio::totalBtc() const
+{
+    return m_totalBtc;
+}
+
+double Portfolio::totalUsd() const
+{
+    return m_totalBtc * m_usdRate;
+}
+
+QVector<Valuation> Portfolio::history()
+{
+    QVector<Valuation> history;
+    uchar record[ValuationRecordSize];
+    for (qint64 i = 0; i < m_valuations.count(); i++)
+    {
+        if (!m_valuations.read(i, reinterpret_cast<char *>(record)))
+        {
+            break;
+        }
+        Valuation valuation;
+        valuation.day = qFromLittleEndian<quint32>(record);
+        valuation.btc = Price(qFromLittleEndian<qint64>(record + 8), AMOUNT_SCALE).toDouble();
+        valuation.usd = Price(qFromLittleEndian<qint64>(record + 16), USD_SCALE).toDouble();
+        history.append(valuation);
+    }
+    return history;
+}
+
+void Portfolio::setRecording(bool enabled)
+{
+    // only one process may write the valuation history
+    m_recording = enabled;
+}
+
+void Portfolio::add(int pair, uint timestamp)
+{
+    // close the previous day before the first quote of a new one counts
+    uint day = timestamp - timestamp % DAY;
+    if (m_recording && m_day > 0 && day > m_day && m_totalBtc > 0.0)
+    {
+        storeValuation(m_day);
+    }
+    m_day = qMax(m_day, day);
+
+    const QList<int> &dependents = m_dependents.at(pair);
+    for (int i = 0; i < dependents.size(); i++)
+    {
+        recompute(dependents.at(i));
+    }
+    if (m_usdPairs.contains(pair))
+    {
+        m_usdRate = bestRate(m_usdPairs);
+    }
+    if (!dependents.isEmpty() || m_usdPairs.contains(pair))
+    {
+        emit changed();
+    }
+
+    if (m_recording && m_totalBtc > 0.0 && m_totalBtc != m_storedBtc && timestamp >= m_stored + ValuationInterval)
+    {
+        storeValuation(m_day);
+        m_stored = timestamp;
+    }
+}
+
+void Portfolio::flush()
+{
+    if (m_recording && m_day > 0 && m_totalBtc > 0.0 && m_totalBtc != m_storedBtc)
+    {
+        storeValuation(m_day);
+    }
+}
+
+int Portfolio::indexOf(const QString &asset) const
+{
+    for (int i = 0; i < m_positions.size(); i++)
+    {
+        if (m_positions.at(i).asset == asset)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+double Portfolio::bestRate(const QList<int> &pairs) const
+{
+    // the most recently updated valid quote of all markets of a coin
+    const Quote *best = 0;
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        const Quote &quote = m_prices->quote(pairs.at(i));
+        if (quote.isValid() && (!best || quote.updated > best->updated))
+        {
+            best = &quote;
+        }
+    }
+    return best ? best->value.toDouble() : 0.0;
+}
+
+void Portfolio::recompute(int position)
+{
+    Position &entry = m_positions[position];
+    if (!entry.pairs.isEmpty())
+    {
+        entry.rate = bestRate(entry.pairs);
+    }
+    double value = entry.amount * entry.rate;
+    m_totalBtc += value - entry.value;
+    entry.value = value;
+}
+
+void Portfolio::reload()
+{
+    // holdings the previous writer stored
+    load();
+    emit changed();
+}
+
+void Portfolio::load()
+{
+    for (int i = 0; i < m_positions.size(); i++)
+    {
+        m_positions[i].amount = 0.0;
+    }
+
+    uchar record[HoldingRecordSize];
+    for (qint64 i = 0; i < m_holdings.count(); i++)
+    {
+        if (!m_holdings.read(i, reinterpret_cast<char *>(record)))
+        {
+            break;
+        }
+        QString asset = QString::fromLatin1(reinterpret_cast<const char *>(record), qstrnlen(reinterpret_cast<const char *>(record), 8));
+        int position = indexOf(asset);
+        if (position >= 0)
+        {
+            m_positions[position].amount = Price(qFromLittleEndian<qint64>(record + 8), AMOUNT_SCALE).toDouble();
+        }
+    }
+
+    m_totalBtc = 0.0;
+    for (int i = 0; i < m_positions.size(); i++)
+    {
+        m_positions[i].value = 0.0;
+        recompute(i);
+    }
+    m_usdRate = bestRate(m_usdPairs);
+}
+
+void Portfolio::storeValuation(uint day)
+{
+    uchar record[ValuationRecordSize];
+    memset(record, 0, ValuationRecordSize);
+    qToLittleEndian<quint32>(day, record);
+    qToLittleEndian<qint64>(Price::fromDouble(m_totalBtc, AMOUNT_SCALE).mantissa(), record + 8);
+    qToLittleEndian<qint64>(Price::fromDouble(totalUsd(), USD_SCALE).mantissa(), record + 16);
+    m_storedBtc = m_totalBtc;
+
+    // one record per day, the last one is rewritten until the day is over
+    uchar last[ValuationRecordSize];
+    qint64 count = m_valuations.count();
+    if (count > 0 && m_valuations.read(count - 1, reinterpret_cast<char *>(last)))
+    {
+        uint stored = qFromLittleEndian<quint32>(last);
+        if (stored == day)
+        {
+            m_valuations.write(count - 1, reinterpret_cast<const char *>(record));
+            return;
+        }
+        if (stored > day)
+        {
+            return;
+        }
+    }
+    m_valuations.append(reinterpret_cast<const char *>(record));
+}
+
+void Portfolio::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Prices, m_positions);
+    for (int i = 0; i < m_positions.size(); i++)
+    {
+        report.add(MemoryReport::Prices, m_positions.at(i).asset);
+        report.add(MemoryReport::Prices, qint64(m_positions.at(i).pairs.size()) * sizeof(void *));
+    }
+    report.add(MemoryReport::Prices, m_dependents);
+    for (int pair = 0; pair < m_dependents.size(); pair++)
+    {
+        if (!m_dependents.at(pair).isEmpty())
+        {
+            report.add(MemoryReport::Prices, qint64(m_dependents.at(pair).size()) * sizeof(void *));
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "pricetable.h"
+#include "recordfile.h"
+
+class MemoryReport;
+
+struct Valuation
+{
+    uint day;
+    double btc;
+    double usd;
+};
+
+/*
+ * Values user holdings in BTC and USD from the rates already in the price
+ * table. Every position knows the pairs it depends on, so a quote only
+ * recomputes the positions using that pair and adjusts the totals by the
+ * difference. Holdings and the daily valuation history are kept in record
+ * files next to the candles. Only the writer of the history stores holdings,
+ * a mirror passes them on to it and reloads the file once it becomes the
+ * writer itself.
+ *
+ * The valuation of a day is one record, rewritten while the day is running:
+ * when the total changed and ValuationInterval seconds of tick time passed,
+ * at the first quote of the next day and by flush() at shutdown.
+ */
+class Portfolio : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(double totalBtc READ totalBtc NOTIFY changed)
+    Q_PROPERTY(double totalUsd READ totalUsd NOTIFY changed)
+
+public:
+    enum {
+        HoldingRecordSize = 24,
+        ValuationRecordSize = 24,
+        ValuationInterval = 300
+    };
+
+    explicit Portfolio(const PriceTable *prices, QObject *parent = 0);
+    ~Portfolio();
+
+    QStringList assets() const;
+    void setHolding(const QString &asset, double amount);
+    double holding(const QString &asset) const;
+    double value(const QString &asset) const;
+
+    double totalBtc() const;
+    double totalUsd() const;
+    QVector<Valuation> history();
+    void setRecording(bool enabled);
+    void reload();
+
+    void add(int pair, uint timestamp);
+    void flush();
+    void measure(MemoryReport &report) const;
+
+signals:
+    void changed();
+
+private:
+    struct Position
+    {
+        QString asset;
+        double amount;
+        double rate;
+        double value;
+        QList<int> pairs;
+    };
+
+    int indexOf(const QString &asset) const;
+    double bestRate(const QList<int> &pairs) const;
+    void recompute(int position);
+    void load();
+    void storeValuation(uint day);
+
+    const PriceTable *m_prices;
+    QVector<Position> m_positions;
+    QVector<QList<int> > m_dependents;
+    QList<int> m_usdPairs;
+    double m_usdRate;
+    double m_totalBtc;
+    uint m_day;
+    uint m_stored;          // tick time of the last stored valuation
+    double m_storedBtc;
+    bool m_recording;
+
+    RecordFile m_holdings;
+    RecordFile m_valuations;
+};
+
+#endif // PORTFOLIO_H
@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "price.h"
+
+namespace {
+    static const qint64 POW10[] = {
+        Q_INT64_C(1),
+        Q_INT64_C(10),
+        Q_INT64_C(100),
+        Q_INT64_C(1000),
+        Q_INT64_C(10000),
+        Q_INT64_C(100000),
+        Q_INT64_C(1000000),
+        Q_INT64_C(10000000),
+        Q_INT64_C(100000000),
+        Q_INT64_C(1000000000),
+        Q_INT64_C(10000000000),
+        Q_INT64_C(100000000000),
+        Q_INT64_C(1000000000000),
+        Q_INT64_C(10000000000000),
+        Q_INT64_C(100000000000000),
+        Q_INT64_C(1000000000000000),
+        Q_INT64_C(10000000000000000),
+        Q_INT64_C(100000000000000000),
+        Q_INT64_C(1000000000000000000)
+    };
+
+    static const int MAX_DIGITS = 18;
+
+    // shifts a mantissa by a power of ten, rounding half away from zero;
+    // returns false on overflow
+    bool shift(qint64 &mantissa, int exponent)
+    {
+        if (exponent > 0)
+        {
+            if (exponent > MAX_DIGITS)
+            {
+                return mantissa == 0;
+            }
+            qint64 limit = Q_INT64_C(9223372036854775807) / POW10[exponent];
+            if (mantissa > limit || mantissa < -limit)
+            {
+                return false;
+            }
+            mantissa *= POW10[exponent];
+        }
+        else if (exponent < 0)
+        {
+            if (-exponent > MAX_DIGITS)
+            {
+                mantissa = 0;
+                return true;
+            }
+            qint64 divisor = POW10[-exponent];
+            qint64 rest = mantissa % divisor;
+            mantissa /= divisor;
+            if (rest * 2 >= divisor)
+            {
+                mantissa++;
+            }
+            else if (rest * 2 <= -divisor)
+            {
+                mantissa--;
+            }
+        }
+        return true;
+    }
+}
+
+Price::Price()
+    :   m_mantissa(0)
+    ,   m_scale(DefaultScale)
+{
+}
+
+Price::Price(qint64 mantissa, int scale)
+    :   m_mantissa(mantissa)
+    ,   m_scale(qBound(0, scale, int(MaxScale)))
+{
+}
+
+Price Price::parse(const char *begin, const char *end, int scale, bool *ok)
+{
+    // accepts [-]digits[.digits][e[+-]digits], optionally wrapped in quotes
+    const char *p = begin;
+    bool valid = false;
+    bool negative = false;
+    qint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+
+    scale = qBound(0, scale, int(MaxScale));
+
+    if (p < end && *p == '"')
+    {
+        p++;
+    }
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        valid = true;
+        if (digits < MAX_DIGITS)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa > 0)
+            {
+                digits++;
+            }
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            valid = true;
+            if (digits < MAX_DIGITS)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa > 0)
+                {
+                    digits++;
+                }
+                exponent--;
+            }
+        }
+    }
+    if (valid && p < end && (*p == 'e' || *p == 'E'))
+    {
+        bool negativeExponent = false;
+        int value = 0;
+        p++;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negativeExponent = (*p == '-');
+            p++;
+        }
+        valid = (p < end && *p >= '0' && *p <= '9');
+        for (; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            if (value < 1000)
+            {
+                value = value * 10 + (*p - '0');
+            }
+        }
+        exponent += negativeExponent ? -value : value;
+    }
+    if (p < end && *p == '"')
+    {
+        p++;
+    }
+    valid = valid && p == end && shift(mantissa, exponent + scale);
+
+    if (ok)
+    {
+        *ok = valid;
+    }
+    if (!valid)
+    {
+        return Price(0, scale);
+    }
+    return Price(negative ? -mantissa : mantissa, scale);
+}
+
+Price Price::fromDouble(double value, int scale)
+{
+    scale = qBound(0, scale, int(MaxScale));
+    double scaled = value * double(POW10[scale]);
+    return Price(qint64(scaled < 0 ? scaled - 0.5 : scaled + 0.5), scale);
+}
+
+qint64 Price::mantissa() const
+{
+    return m_mantissa;
+}
+
+int Price::scale() const
+{
+    return m_scale;
+}
+
+bool Price::isValid() const
+{
+    return m_mantissa > 0;
+}
+
+Price Price::rescaled(int scale) const
+{
+    scale = qBound(0, scale, int(MaxScale));
+    qint64 mantissa = m_mantissa;
+    if (!shift(mantissa, scale - m_scale))
+    {
+        return Price(0, scale);
+    }
+    return Price(mantissa, scale);
+}
+
+double Price::toDouble() const
+{
+    return double(m_mantissa) / double(POW10[m_scale]);
+}
+
+int Price::format(char *buffer, int precision) const
+{
+    // writes at most MaxFormatted bytes, returns the length
+    precision = qBound(0, precision, int(MaxScale));
+    qint64 mantissa = m_mantissa;
+    if (!shift(mantissa, precision - m_scale))
+    {
+        mantissa = 0;
+    }
+
+    char digits[24];
+    int count = 0;
+    bool negative = mantissa < 0;
+    quint64 rest = negative ? quint64(-(mantissa + 1)) + 1 : quint64(mantissa);
+    do
+    {
+        digits[count++] = char('0' + rest % 10);
+        rest /= 10;
+    }
+    while (rest > 0 || count <= precision);
+
+    int length = 0;
+    if (negative)
+    {
+        buffer[length++] = '-';
+    }
+    for (int i = count - 1; i >= 0; i--)
+    {
+        buffer[length++] = digits[i];
+        if (i == precision && precision > 0)
+        {
+            buffer[length++] = '.';
+        }
+    }
+    return length;
+}
+
+QString Price::toString(int precision) const
+{
+    char buffer[MaxFormatted];
+    return QString::fromLatin1(buffer, format(buffer, precision));
+}
+
+bool Price::operator==(const Price &other) const
+{
+    if (m_scale == other.m_scale)
+    {
+        return m_mantissa == other.m_mantissa;
+    }
+    return rescaled(other.m_scale).m_mantissa == other.m_mantissa
+        && other.rescaled(m_scale).m_mantissa == m_mantissa;
+}
+
+bool Price::operator!=(const Price &other) const
+{
+    return !(*this == other);
+}
+
+bool Price::operator<(const Price &other) const
+{
+    if (m_scale == other.m_scale)
+    {
+        return m_mantissa < other.m_mantissa;
+    }
+    return toDouble() < other.toDouble();
+}
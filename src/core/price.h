@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRICE_H
+#define PRICE_H
+
+#include <QtGlobal>
+#include <QString>
+
+/*
+ * Fixed-point decimal price: a 64 bit mantissa and a decimal scale, i.e. the
+ * value is mantissa * 10^-scale. Rates of one market always share the same
+ * scale, so change detection is an exact integer comparison and formatting
+ * does not go through a double.
+ */
+class Price
+{
+public:
+    enum {
+        DefaultScale = 8,
+        MaxScale = 18,
+        MaxFormatted = 48
+    };
+
+    Price();
+    Price(qint64 mantissa, int scale);
+
+    static Price parse(const char *begin, const char *end, int scale = DefaultScale, bool *ok = 0);
+    static Price fromDouble(double value, int scale = DefaultScale);
+
+    qint64 mantissa() const;
+    int scale() const;
+    bool isValid() const;
+
+    Price rescaled(int scale) const;
+    double toDouble() const;
+
+    int format(char *buffer, int precision) const;
+    QString toString(int precision) const;
+
+    bool operator==(const Price &other) const;
+    bool operator!=(const Price &other) const;
+    bool operator<(const Price &other) const;
+
+private:
+    qint64 m_mantissa;
+    int m_scale;
+};
+
+#endif // PRICE_H
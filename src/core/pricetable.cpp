@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pricetable.h"
+#include "memoryreport.h"
+
+namespace {
+    static const char *const FIELD_NAMES[PriceTable::FieldCount] = {
+        "bid",
+        "ask",
+        "last",
+        "high",
+        "low",
+        "volume",
+        "change"
+    };
+}
+
+PriceTable::PriceTable()
+    :   m_quotes(Symbols::count())
+    ,   m_present(Symbols::count(), 0)
+{
+    for (int i = 0; i < FieldCount; i++)
+    {
+        m_columns[i].fill(0, Symbols::count());
+    }
+}
+
+int PriceTable::count() const
+{
+    return m_quotes.size();
+}
+
+const Quote &PriceTable::quote(int pair) const
+{
+    return m_quotes.at(pair);
+}
+
+Quote &PriceTable::quote(int pair)
+{
+    return m_quotes[pair];
+}
+
+int PriceTable::scale(int pair, Field field)
+{
+    if (field == Volume || field == Change)
+    {
+        return Price::DefaultScale;
+    }
+    return Symbols::info(pair).scale;
+}
+
+const char *PriceTable::fieldName(Field field)
+{
+    return FIELD_NAMES[field];
+}
+
+bool PriceTable::has(int pair, Field field) const
+{
+    if (field == Bid)
+    {
+        return m_quotes.at(pair).isValid();
+    }
+    return m_present.at(pair) & (1 << field);
+}
+
+Price PriceTable::field(int pair, Field field) const
+{
+    if (field == Bid)
+    {
+        return m_quotes.at(pair).value;
+    }
+    return Price(m_columns[field].at(pair), scale(pair, field));
+}
+
+void PriceTable::setField(int pair, Field field, const Price &value)
+{
+    // the bid goes through Quote::update so change detection sees it
+    Q_ASSERT(field != Bid);
+    m_columns[field][pair] = value.rescaled(scale(pair, field)).mantissa();
+    m_present[pair] |= (1 << field);
+}
+
+Price PriceTable::mid(int pair) const
+{
+    if (!has(pair, Bid) || !has(pair, Ask))
+    {
+        return Price(0, scale(pair, Bid));
+    }
+    qint64 bid = m_quotes.at(pair).value.rescaled(scale(pair, Bid)).mantissa();
+    qint64 ask = m_columns[Ask].at(pair);
+    return Price(bid + (ask - bid) / 2, scale(pair, Bid));
+}
+
+Price PriceTable::spread(int pair) const
+{
+    if (!has(pair, Bid) || !has(pair, Ask))
+    {
+        return Price(0, scale(pair, Bid));
+    }
+    qint64 bid = m_quotes.at(pair).value.rescaled(scale(pair, Bid)).mantissa();
+    return Price(m_columns[Ask].at(pair) - bid, scale(pair, Bid));
+}
+
+void PriceTable::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Prices, m_quotes);
+    for (int field = 0; field < FieldCount; field++)
+    {
+        report.add(MemoryReport::Prices, m_columns[field]);
+    }
+    report.add(MemoryReport::Prices, m_present);
+}
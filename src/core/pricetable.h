@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRICETABLE_H
+#define PRICETABLE_H
+
+#include <QVector>
+
+#include "quote.h"
+#include "symbols.h"
+
+class MemoryReport;
+
+/*
+ * Quotes of all markets, indexed by pair id. The exchanges write into the
+ * table, everything else only reads from it.
+ *
+ * Besides the bid kept in the Quote, the table stores the rest of a ticker
+ * record column-wise: one mantissa vector per field and a presence mask per
+ * pair. Price fields share the scale of their market, volume (in the base
+ * asset) and change (a fraction, 0.01 = 1%) use Price::DefaultScale.
+ */
+class PriceTable
+{
+public:
+    enum Field {
+        Bid,
+        Ask,
+        Last,
+        High,
+        Low,
+        Volume,
+        Change,
+        FieldCount
+    };
+
+    PriceTable();
+
+    int count() const;
+    const Quote &quote(int pair) const;
+    Quote &quote(int pair);
+
+    static int scale(int pair, Field field);
+    static const char *fieldName(Field field);
+
+    bool has(int pair, Field field) const;
+    Price field(int pair, Field field) const;
+    void setField(int pair, Field field, const Price &value);
+
+    // midpoint and width of the book, invalid without both sides
+    Price mid(int pair) const;
+    Price spread(int pair) const;
+
+    void measure(MemoryReport &report) const;
+
+private:
+    QVector<Quote> m_quotes;
+    QVector<qint64> m_columns[FieldCount];
+    QVector<quint8> m_present;
+};
+
+#endif // PRICETABLE_H
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUOTE_H
+#define QUOTE_H
+
+#include <QtGlobal>
+
+#include "price.h"
+
+/*
+ * Last known rate of a single market. A failed fetch never overwrites the
+ * value, it only increases the error streak, so the UI can keep showing the
+ * last good price together with its age.
+ */
+struct Quote
+{
+    Quote()
+        :   updated(0)
+        ,   errors(0)
+    {
+    }
+
+    bool isValid() const
+    {
+        return value.isValid();
+    }
+
+    // returns true if the rate changed
+    bool update(const Price &rate, uint timestamp)
+    {
+        bool changed = (rate != value);
+        value = rate;
+        updated = timestamp;
+        errors = 0;
+        return changed;
+    }
+
+    void fail()
+    {
+        errors++;
+    }
+
+    Price value;
+    uint updated;
+    int errors;
+};
+
+#endif // QUOTE_H
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDir>
+#include <QStandardPaths>
+
+#include "recordfile.h"
+
+RecordFile::RecordFile(const QString &name, int recordSize)
+    :   m_recordSize(recordSize)
+    ,   m_count(0)
+    ,   m_file(dataPath(name))
+{
+    open();
+}
+
+RecordFile::~RecordFile()
+{
+    m_file.close();
+}
+
+bool RecordFile::append(const char *record)
+{
+    if (!m_file.isOpen() && !open())
+    {
+        return false;
+    }
+    // the writer lock moves between processes, records appended by the
+    // previous writer are kept and a torn record of it is cut off
+    qint64 size = m_file.size();
+    m_count = size / m_recordSize;
+    if (m_count * m_recordSize != size && !m_file.resize(m_count * m_recordSize))
+    {
+        return false;
+    }
+    if (!m_file.seek(m_count * m_recordSize) || m_file.write(record, m_recordSize) != m_recordSize)
+    {
+        return false;
+    }
+    m_file.flush();
+    m_count++;
+    return true;
+}
+
+bool RecordFile::write(qint64 index, const char *record)
+{
+    if (index < 0 || index >= count() || !m_file.isOpen())
+    {
+        return false;
+    }
+    if (!m_file.seek(index * m_recordSize) || m_file.write(record, m_recordSize) != m_recordSize)
+    {
+        return false;
+    }
+    return m_file.flush();
+}
+
+bool RecordFile::read(qint64 index, char *record)
+{
+    if (index < 0 || index >= count() || !m_file.isOpen())
+    {
+        return false;
+    }
+    return m_file.seek(index * m_recordSize) && m_file.read(record, m_recordSize) == m_recordSize;
+}
+
+qint64 RecordFile::count() const
+{
+    // includes what other processes appended since
+    return m_file.isOpen() ? m_file.size() / m_recordSize : m_count;
+}
+
+int RecordFile::recordSize() const
+{
+    return m_recordSize;
+}
+
+QString RecordFile::fileName() const
+{
+    return m_file.fileName();
+}
+
+QString RecordFile::dataPath(const QString &name)
+{
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    QDir().mkpath(path);
+    return path.append("/").append(name);
+}
+
+bool RecordFile::open()
+{
+    if (!m_file.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+
+    // a partial record may still be in the writing of another process,
+    // it is left alone until the next append()
+    m_count = m_file.size() / m_recordSize;
+    return true;
+}
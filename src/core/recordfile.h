@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDFILE_H
+#define RECORDFILE_H
+
+#include <QFile>
+#include <QString>
+
+/*
+ * Append-only file of fixed-size binary records in the application data
+ * directory. Readers ignore a torn record at the end of the file, e.g. after
+ * a power loss; the next append() cuts it off. Only the process holding the
+ * writer lock of TickerCore appends, count() sees its records right away.
+ * write() replaces a complete record in place, e.g. a running daily total.
+ */
+class RecordFile
+{
+public:
+    RecordFile(const QString &name, int recordSize);
+    ~RecordFile();
+
+    bool append(const char *record);
+    bool write(qint64 index, const char *record);
+    bool read(qint64 index, char *record);
+    qint64 count() const;
+    int recordSize() const;
+    QString fileName() const;
+
+    static QString dataPath(const QString &name);
+
+private:
+    bool open();
+
+    int m_recordSize;
+    qint64 m_count;
+    QFile m_file;
+};
+
+#endif // RECORDFILE_H
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+#include "replay.h"
+#include "tickercore.h"
+#include "trace.h"
+
+double Replay::Result::ticksPerSecond() const
+{
+    return elapsed > 0 ? double(ticks) * 1e9 / double(elapsed) : 0.0;
+}
+
+Replay::Replay(TickerCore *core, QObject *parent)
+    :   QObject(parent)
+    ,   m_core(core)
+    ,   m_now(0)
+{
+    connect(m_core->alerts(), SIGNAL(triggered(int,int,Price)), this, SLOT(onTriggered(int,int,Price)));
+}
+
+Replay::~Replay()
+{
+}
+
+Replay::Result Replay::run(const QList<int> &pairs, uint from, uint to)
+{
+    TRACE_SCOPE("replay", "run");
+    m_core->setMirror(true);
+    m_alerts.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // one head per pair, the oldest on top; ties go by pair for a stable order
+    QList<TickCursor *> cursors;
+    m_heap.clear();
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        TickCursor *cursor = new TickCursor(m_core->ticks(), pairs.at(i), from, to);
+        Head head;
+        head.cursor = cursors.size();
+        cursors.append(cursor);
+        if (cursor->next(head.tick))
+        {
+            m_heap.append(head);
+        }
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), later);
+
+    Result result;
+    PriceTable *prices = m_core->prices();
+    while (!m_heap.isEmpty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), later);
+        Head &head = m_heap.last();
+        int pair = pairs.at(head.cursor);
+        m_now = head.tick.timestamp;
+        if (result.ticks == 0)
+        {
+            result.first = m_now;
+        }
+
+        prices->quote(pair).update(Price(head.tick.mantissa, Symbols::info(pair).scale), m_now);
+        m_core->ingest(pair);
+        result.ticks++;
+
+        if (cursors.at(head.cursor)->next(head.tick))
+        {
+            std::push_heap(m_heap.begin(), m_heap.end(), later);
+        }
+        else
+        {
+            m_heap.removeLast();
+        }
+    }
+    qDeleteAll(cursors);
+
+    result.last = m_now;
+    result.alerts = m_alerts;
+    result.elapsed = timer.nsecsElapsed();
+    return result;
+}
+
+uint Replay::now() const
+{
+    return m_now;
+}
+
+void Replay::onTriggered(int rule, int pair, const Price &price)
+{
+    Alert alert;
+    alert.time = m_now;
+    alert.rule = rule;
+    alert.pair = pair;
+    alert.price = price;
+    m_alerts.append(alert);
+}
+
+bool Replay::later(const Head &a, const Head &b)
+{
+    if (a.tick.timestamp != b.tick.timestamp)
+    {
+        return a.tick.timestamp > b.tick.timestamp;
+    }
+    return a.cursor > b.cursor;
+}
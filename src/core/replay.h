@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+
+#include "price.h"
+#include "ticklog.h"
+
+class TickerCore;
+
+/*
+ * Backtesting: streams the stored ticks of a set of pairs in timestamp order
+ * through TickerCore::ingest(), the path the live exchanges feed, so
+ * statistics, consensus, alerts and the portfolio see the past as if it was
+ * polled. Every pair is read through its own TickCursor and a heap of the
+ * cursor heads merges them, memory does not depend on the length of the
+ * range. The clock is virtual: now() is the timestamp of the tick being
+ * replayed and nothing waits for it.
+ *
+ * The core is switched to mirror mode, which also gives up the writer lock,
+ * so the replay never writes history. Use a core of its own, not the
+ * one that polls.
+ */
+class Replay : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Alert
+    {
+        uint time;          // virtual time the rule fired at
+        int rule;
+        int pair;
+        Price price;
+    };
+
+    struct Result
+    {
+        Result()
+            :   ticks(0)
+            ,   first(0)
+            ,   last(0)
+            ,   elapsed(0)
+        {
+        }
+
+        double ticksPerSecond() const;
+
+        qint64 ticks;
+        QVector<Alert> alerts;
+        uint first;         // virtual time of the first and last tick
+        uint last;
+        qint64 elapsed;     // wall time in nanoseconds
+    };
+
+    explicit Replay(TickerCore *core, QObject *parent = 0);
+    ~Replay();
+
+    Result run(const QList<int> &pairs, uint from, uint to);
+    uint now() const;
+
+private slots:
+    void onTriggered(int rule, int pair, const Price &price);
+
+private:
+    struct Head
+    {
+        Tick tick;
+        int cursor;
+    };
+
+    static bool later(const Head &a, const Head &b);
+
+    TickerCore *m_core;
+    QVector<Head> m_heap;
+    uint m_now;
+    QVector<Alert> m_alerts;
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include <QVector>
+
+/*
+ * Double-ended ring buffer on top of a QVector. Storage only grows, so once
+ * a window reached its steady size pushing and popping does not allocate.
+ */
+template <typename T>
+class Ring
+{
+public:
+    explicit Ring(int capacity = 16)
+        :   m_data(qMax(capacity, 1))
+        ,   m_head(0)
+        ,   m_size(0)
+    {
+    }
+
+    int size() const
+    {
+        return m_size;
+    }
+
+    int capacity() const
+    {
+        return m_data.size();
+    }
+
+    bool isEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    const T &at(int i) const
+    {
+        return m_data.at((m_head + i) % m_data.size());
+    }
+
+    const T &first() const
+    {
+        return at(0);
+    }
+
+    const T &last() const
+    {
+        return at(m_size - 1);
+    }
+
+    void append(const T &value)
+    {
+        if (m_size == m_data.size())
+        {
+            grow();
+        }
+        m_data[(m_head + m_size) % m_data.size()] = value;
+        m_size++;
+    }
+
+    void removeFirst()
+    {
+        m_head = (m_head + 1) % m_data.size();
+        m_size--;
+    }
+
+    void removeLast()
+    {
+        m_size--;
+    }
+
+    void clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+
+private:
+    void grow()
+    {
+        QVector<T> data(m_data.size() * 2);
+        for (int i = 0; i < m_size; i++)
+        {
+            data[i] = at(i);
+        }
+        m_data = data;
+        m_head = 0;
+    }
+
+    QVector<T> m_data;
+    int m_head;
+    int m_size;
+};
+
+#endif // RING_H
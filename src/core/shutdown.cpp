@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QSocketNotifier>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "shutdown.h"
+
+int Shutdown::s_fds[2] = { -1, -1 };
+
+void Shutdown::install()
+{
+    if (s_fds[0] >= 0 || !QCoreApplication::instance()
+            || ::socketpair(AF_UNIX, SOCK_STREAM, 0, s_fds) != 0)
+    {
+        return;
+    }
+    new Shutdown(QCoreApplication::instance());
+
+    struct sigaction action;
+    action.sa_handler = Shutdown::handle;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    ::sigaction(SIGTERM, &action, 0);
+    ::sigaction(SIGINT, &action, 0);
+    ::sigaction(SIGHUP, &action, 0);
+}
+
+Shutdown::Shutdown(QObject *parent)
+    :   QObject(parent)
+    ,   m_notifier(new QSocketNotifier(s_fds[1], QSocketNotifier::Read, this))
+{
+    connect(m_notifier, SIGNAL(activated(int)), this, SLOT(onActivated()));
+}
+
+void Shutdown::onActivated()
+{
+    char byte;
+    if (::read(s_fds[1], &byte, 1) == 1)
+    {
+        QCoreApplication::quit();
+    }
+}
+
+void Shutdown::handle(int signal)
+{
+    // only async-signal-safe calls in here
+    Q_UNUSED(signal);
+    char byte = 1;
+    ssize_t written = ::write(s_fds[0], &byte, 1);
+    Q_UNUSED(written);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHUTDOWN_H
+#define SHUTDOWN_H
+
+#include <QObject>
+
+class QSocketNotifier;
+
+/*
+ * Turns SIGTERM, SIGINT and SIGHUP into QCoreApplication::quit(), so a
+ * headless process stopped by the session or by ctrl-c leaves the event loop
+ * normally and its destructors flush the tick log, candles and data usage.
+ * The signal handler only writes a byte to a socket pair; the quit happens
+ * in the event loop.
+ */
+class Shutdown : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void install();
+
+private slots:
+    void onActivated();
+
+private:
+    explicit Shutdown(QObject *parent = 0);
+
+    static void handle(int signal);
+
+    static int s_fds[2];
+    QSocketNotifier *m_notifier;
+};
+
+#endif // SHUTDOWN_H
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "snapshot.h"
+
+Snapshot::Format Snapshot::parseFormat(const QString &name, bool *ok)
+{
+    if (ok)
+    {
+        *ok = true;
+    }
+    if (name == "csv")
+    {
+        return Csv;
+    }
+    if (name == "json")
+    {
+        return Json;
+    }
+    if (ok && name != "text")
+    {
+        *ok = false;
+    }
+    return Text;
+}
+
+QByteArray Snapshot::write(const PriceTable &prices, const QList<int> &pairs, Format format)
+{
+    QByteArray out;
+    out.reserve(64 * (pairs.size() + 1));
+
+    if (format == Csv)
+    {
+        out.append("exchange,pair,base,quote,price,updated,errors,ask,last,high,low,volume,change,mid,spread\n");
+    }
+    else if (format == Json)
+    {
+        out.append('[');
+    }
+
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        int pair = pairs.at(i);
+        const PairInfo &info = Symbols::info(pair);
+        const Quote &quote = prices.quote(pair);
+        const char *exchange = Symbols::exchangeName(info.exchange);
+
+        switch (format)
+        {
+        case Text:
+            out.append(exchange).append(' ').append(info.base).append('/').append(info.quote).append(' ');
+            if (quote.isValid())
+            {
+                appendPrice(out, quote.value, info.precision);
+            }
+            else
+            {
+                out.append("n/a");
+            }
+            out.append('\n');
+            break;
+
+        case Csv:
+            out.append(exchange).append(',').append(info.name).append(',')
+               .append(info.base).append(',').append(info.quote).append(',');
+            if (quote.isValid())
+            {
+                appendPrice(out, quote.value, info.precision);
+            }
+            out.append(',').append(QByteArray::number(quote.updated))
+               .append(',').append(QByteArray::number(quote.errors));
+            appendRecord(out, prices, pair, format);
+            out.append('\n');
+            break;
+
+        case Json:
+            if (i > 0)
+            {
+                out.append(',');
+            }
+            out.append("{\"exchange\":");
+            appendString(out, exchange);
+            out.append(",\"pair\":");
+            appendString(out, info.name);
+            out.append(",\"base\":");
+            appendString(out, info.base);
+            out.append(",\"quote\":");
+            appendString(out, info.quote);
+            out.append(",\"price\":");
+            if (quote.isValid())
+            {
+                appendPrice(out, quote.value, info.precision);
+            }
+            else
+            {
+                out.append("null");
+            }
+            out.append(",\"updated\":").append(QByteArray::number(quote.updated))
+               .append(",\"errors\":").append(QByteArray::number(quote.errors));
+            appendRecord(out, prices, pair, format);
+            out.append('}');
+            break;
+        }
+    }
+
+    if (format == Json)
+    {
+        out.append("]\n");
+    }
+    return out;
+}
+
+void Snapshot::appendString(QByteArray &out, const char *text)
+{
+    // quoted, with quotes, backslashes and control characters escaped
+    static const char HEX[] = "0123456789abcdef";
+    out.append('"');
+    for (const char *c = text; *c; c++)
+    {
+        uchar ch = uchar(*c);
+        if (ch == '"' || ch == '\\')
+        {
+            out.append('\\').append(char(ch));
+        }
+        else if (ch < 0x20)
+        {
+            out.append("\\u00").append(HEX[ch >> 4]).append(HEX[ch & 0xf]);
+        }
+        else
+        {
+            out.append(char(ch));
+        }
+    }
+    out.append('"');
+}
+
+void Snapshot::appendPrice(QByteArray &out, const Price &price, int precision)
+{
+    char buffer[Price::MaxFormatted];
+    out.append(buffer, price.format(buffer, precision));
+}
+
+void Snapshot::appendRecord(QByteArray &out, const PriceTable &prices, int pair, Format format)
+{
+    // the remaining ticker fields, followed by mid and spread; missing values
+    // are left empty in csv and null in json
+    int precision = Symbols::info(pair).precision;
+    for (int i = PriceTable::Ask; i <= PriceTable::FieldCount + 1; i++)
+    {
+        Price value;
+        bool valid;
+        const char *name;
+        int digits = precision;
+        if (i < PriceTable::FieldCount)
+        {
+            PriceTable::Field field = PriceTable::Field(i);
+            valid = prices.has(pair, field);
+            value = prices.field(pair, field);
+            name = PriceTable::fieldName(field);
+            if (field == PriceTable::Volume || field == PriceTable::Change)
+            {
+                digits = Price::DefaultScale;
+            }
+        }
+        else
+        {
+            bool mid = (i == PriceTable::FieldCount);
+            valid = prices.has(pair, PriceTable::Bid) && prices.has(pair, PriceTable::Ask);
+            value = mid ? prices.mid(pair) : prices.spread(pair);
+            name = mid ? "mid" : "spread";
+        }
+
+        if (format == Json)
+        {
+            out.append(",\"").append(name).append("\":");
+            if (valid)
+            {
+                appendPrice(out, value, digits);
+            }
+            else
+            {
+                out.append("null");
+            }
+        }
+        else
+        {
+            out.append(',');
+            if (valid)
+            {
+                appendPrice(out, value, digits);
+            }
+        }
+    }
+}
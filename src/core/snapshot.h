@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "pricetable.h"
+
+/*
+ * Serializes the current quotes of a price table for non-graphical
+ * consumers. Prices are written with the fixed-point formatter, so the output
+ * carries exactly the digits received from the exchange.
+ *
+ * Names of configured exchanges and markets come from the user's config, so
+ * every JSON writer appends them through appendString().
+ */
+class Snapshot
+{
+public:
+    enum Format
+    {
+        Text,
+        Csv,
+        Json
+    };
+
+    static Format parseFormat(const QString &name, bool *ok = 0);
+    static QByteArray write(const PriceTable &prices, const QList<int> &pairs, Format format);
+    static void appendString(QByteArray &out, const char *text);
+
+private:
+    static void appendPrice(QByteArray &out, const Price &price, int precision);
+    static void appendRecord(QByteArray &out, const PriceTable &prices, int pair, Format format);
+};
+
+#endif // SNAPSHOT_H
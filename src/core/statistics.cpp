@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+
+#include "statistics.h"
+#include "symbols.h"
+#include "memoryreport.h"
+
+namespace {
+    static const uint DAY = 24 * 60 * 60;
+}
+
+PairStatistics::PairStatistics(int window, QObject *parent)
+    :   QObject(parent)
+    ,   m_window(qMax(window, 2))
+    ,   m_samples(0)
+    ,   m_alpha(2.0 / (m_window + 1))
+    ,   m_ema(0.0)
+    ,   m_mean(0.0)
+    ,   m_m2(0.0)
+    ,   m_recent(m_window)
+    ,   m_sequence(0)
+    ,   m_priceVolume(0.0)
+    ,   m_volume(0.0)
+{
+}
+
+PairStatistics::~PairStatistics()
+{
+}
+
+void PairStatistics::add(double price, double volume, uint timestamp)
+{
+    // sliding window welford, replacing the oldest sample once full
+    if (m_recent.size() < m_window)
+    {
+        int n = m_recent.size() + 1;
+        double delta = price - m_mean;
+        m_mean += delta / n;
+        m_m2 += delta * (price - m_mean);
+    }
+    else
+    {
+        double oldest = m_recent.first();
+        double mean = m_mean + (price - oldest) / m_window;
+        m_m2 += (price - oldest) * (price - mean + oldest - m_mean);
+        m_mean = mean;
+        m_recent.removeFirst();
+    }
+    m_recent.append(price);
+    if (m_m2 < 0.0)
+    {
+        m_m2 = 0.0;
+    }
+
+    m_ema = (m_samples == 0) ? price : m_ema + m_alpha * (price - m_ema);
+    m_samples++;
+
+    // 24 hour window with monotonic deques for its range
+    while (!m_day.isEmpty() && m_day.first().timestamp + DAY <= timestamp)
+    {
+        const Sample &expired = m_day.first();
+        if (expired.volume > 0.0)
+        {
+            m_priceVolume -= expired.price * expired.volume;
+            m_volume -= expired.volume;
+        }
+        if (!m_minima.isEmpty() && m_minima.first().sequence == expired.sequence)
+        {
+            m_minima.removeFirst();
+        }
+        if (!m_maxima.isEmpty() && m_maxima.first().sequence == expired.sequence)
+        {
+            m_maxima.removeFirst();
+        }
+        m_day.removeFirst();
+    }
+
+    Sample sample;
+    sample.timestamp = timestamp;
+    sample.price = price;
+    sample.volume = volume;
+    sample.sequence = m_sequence++;
+    m_day.append(sample);
+
+    while (!m_minima.isEmpty() && m_minima.last().price >= price)
+    {
+        m_minima.removeLast();
+    }
+    m_minima.append(sample);
+    while (!m_maxima.isEmpty() && m_maxima.last().price <= price)
+    {
+        m_maxima.removeLast();
+    }
+    m_maxima.append(sample);
+
+    if (volume > 0.0)
+    {
+        m_priceVolume += price * volume;
+        m_volume += volume;
+    }
+
+    emit changed();
+}
+
+int PairStatistics::samples() const
+{
+    return m_samples;
+}
+
+double PairStatistics::sma() const
+{
+    return m_mean;
+}
+
+double PairStatistics::ema() const
+{
+    return m_ema;
+}
+
+double PairStatistics::stddev() const
+{
+    int n = m_recent.size();
+    if (n < 2)
+    {
+        return 0.0;
+    }
+    return sqrt(m_m2 / (n - 1));
+}
+
+double PairStatistics::change() const
+{
+    if (m_day.isEmpty() || m_day.first().price <= 0.0)
+    {
+        return 0.0;
+    }
+    return (m_day.last().price - m_day.first().price) / m_day.first().price * 100.0;
+}
+
+double PairStatistics::minimum() const
+{
+    return m_minima.isEmpty() ? 0.0 : m_minima.first().price;
+}
+
+double PairStatistics::maximum() const
+{
+    return m_maxima.isEmpty() ? 0.0 : m_maxima.first().price;
+}
+
+double PairStatistics::vwap() const
+{
+    return m_volume > 0.0 ? m_priceVolume / m_volume : 0.0;
+}
+
+Statistics::Statistics(int window, QObject *parent)
+    :   QObject(parent)
+    ,   m_pairs(Symbols::count())
+    ,   m_totals(Symbols::count(), -1.0)
+{
+    for (int i = 0; i < m_pairs.size(); i++)
+    {
+        m_pairs[i] = new PairStatistics(window, this);
+    }
+}
+
+Statistics::~Statistics()
+{
+}
+
+void Statistics::add(int pair, const Price &price, const Price &total, uint timestamp)
+{
+    // a shrinking total only lost old trades, nothing is known to be new
+    double volume = 0.0;
+    if (total.isValid())
+    {
+        double current = total.toDouble();
+        if (m_totals.at(pair) >= 0.0 && current > m_totals.at(pair))
+        {
+            volume = current - m_totals.at(pair);
+        }
+        m_totals[pair] = current;
+    }
+    m_pairs.at(pair)->add(price.toDouble(), volume, timestamp);
+}
+
+PairStatistics *Statistics::pair(int pair)
+{
+    if (pair < 0 || pair >= m_pairs.size())
+    {
+        return 0;
+    }
+    return m_pairs.at(pair);
+}
+
+void PairStatistics::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::History, sizeof(PairStatistics));
+    report.add(MemoryReport::History, m_recent);
+    report.add(MemoryReport::History, m_day);
+    report.add(MemoryReport::History, m_minima);
+    report.add(MemoryReport::History, m_maxima);
+}
+
+void Statistics::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::History, m_pairs);
+    report.add(MemoryReport::History, m_totals);
+    for (int pair = 0; pair < m_pairs.size(); pair++)
+    {
+        m_pairs.at(pair)->measure(report);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <QObject>
+#include <QVector>
+
+#include "price.h"
+#include "ring.h"
+
+class MemoryReport;
+
+/*
+ * Rolling statistics of a single pair, exposed to QML as bindable
+ * properties. Moving averages and the standard deviation cover the last
+ * samples, change, range and vwap cover the last 24 hours.
+ */
+class PairStatistics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int samples READ samples NOTIFY changed)
+    Q_PROPERTY(double sma READ sma NOTIFY changed)
+    Q_PROPERTY(double ema READ ema NOTIFY changed)
+    Q_PROPERTY(double stddev READ stddev NOTIFY changed)
+    Q_PROPERTY(double change READ change NOTIFY changed)
+    Q_PROPERTY(double minimum READ minimum NOTIFY changed)
+    Q_PROPERTY(double maximum READ maximum NOTIFY changed)
+    Q_PROPERTY(double vwap READ vwap NOTIFY changed)
+
+public:
+    explicit PairStatistics(int window, QObject *parent = 0);
+    ~PairStatistics();
+
+    void add(double price, double volume, uint timestamp);
+
+    int samples() const;
+    double sma() const;
+    double ema() const;
+    double stddev() const;
+    double change() const;
+    double minimum() const;
+    double maximum() const;
+    double vwap() const;
+
+    void measure(MemoryReport &report) const;
+
+signals:
+    void changed();
+
+private:
+    struct Sample
+    {
+        uint timestamp;
+        double price;
+        double volume;
+        quint64 sequence;
+    };
+
+    int m_window;
+    int m_samples;
+    double m_alpha;
+    double m_ema;
+    double m_mean;
+    double m_m2;
+    Ring<double> m_recent;
+
+    quint64 m_sequence;
+    double m_priceVolume;
+    double m_volume;
+    Ring<Sample> m_day;
+    Ring<Sample> m_minima;
+    Ring<Sample> m_maxima;
+};
+
+/*
+ * Statistics engine holding one PairStatistics per pair. Every tick updates
+ * its pair in O(1) amortized: Welford's algorithm over a sliding window for
+ * mean and variance, monotonic deques for the 24h minimum and maximum.
+ *
+ * Exchanges report volume as a rolling 24h total, so the volume weighted
+ * into the vwap is its growth since the previous tick of the pair.
+ */
+class Statistics : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Statistics(int window = 20, QObject *parent = 0);
+    ~Statistics();
+
+    void add(int pair, const Price &price, const Price &total, uint timestamp);
+    PairStatistics *pair(int pair);
+    void measure(MemoryReport &report) const;
+
+private:
+    QVector<PairStatistics *> m_pairs;
+    QVector<double> m_totals;       // last 24h volume, negative if unknown
+};
+
+#endif // STATISTICS_H
@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <QList>
+#include <QVector>
+
+#include "symbols.h"
+#include "price.h"
+#include "memoryreport.h"
+
+namespace {
+    static const PairInfo PAIRS[Pair::Count] = {
+        { Exchange::Bitfinex, "btcusd",   "bitfinexBtcUsd",  "BTC",   "USD", 4, 2 },
+        { Exchange::Bitfinex, "drkusd",   "bitfinexDrkUsd",  "DRK",   "USD", 4, 2 },
+        { Exchange::Bitfinex, "drkbtc",   "bitfinexDrkBtc",  "DRK",   "BTC", 8, 5 },
+        { Exchange::Cryptsy,  "2",        "cryptsyBtcUsd",   "BTC",   "USD", 4, 2 },
+        { Exchange::Cryptsy,  "213",      "cryptsyDrkUsd",   "DRK",   "USD", 4, 2 },
+        { Exchange::Cryptsy,  "155",      "cryptsyDrkBtc",   "DRK",   "BTC", 8, 5 },
+        { Exchange::Cryptsy,  "214",      "cryptsyDrkLtc",   "DRK",   "LTC", 8, 3 },
+        { Exchange::Cryptsy,  "66",       "cryptsyAncBtc",   "ANC",   "BTC", 8, 5 },
+        { Exchange::Cryptsy,  "121",      "cryptsyAncLtc",   "ANC",   "LTC", 8, 3 },
+        { Exchange::Cryptsy,  "256",      "cryptsyBtcdBtc",  "BTCD",  "BTC", 8, 5 },
+        { Exchange::Cryptsy,  "227",      "cryptsyCloakBtc", "CLOAK", "BTC", 8, 7 },
+        { Exchange::Cryptsy,  "228",      "cryptsyCloakLtc", "CLOAK", "LTC", 8, 5 },
+        { Exchange::Cryptsy,  "210",      "cryptsyXcBtc",    "XC",    "BTC", 8, 5 },
+        { Exchange::Cryptsy,  "216",      "cryptsyXcLtc",    "XC",    "LTC", 8, 3 },
+        { Exchange::Poloniex, "XUSD_BTC", "poloniexBtcUsd",  "BTC",   "USD", 4, 2 },
+        { Exchange::Poloniex, "XUSD_XMR", "poloniexXmrUsd",  "XMR",   "USD", 4, 2 },
+        { Exchange::Poloniex, "BTC_DRK",  "poloniexDrkBtc",  "DRK",   "BTC", 8, 5 },
+        { Exchange::Poloniex, "XMR_DRK",  "poloniexDrkXmr",  "DRK",   "XMR", 8, 3 },
+        { Exchange::Poloniex, "BTC_BTCD", "poloniexBtcdBtc", "BTCD",  "BTC", 8, 5 },
+        { Exchange::Poloniex, "XMR_BTCD", "poloniexBtcdXmr", "BTCD",  "XMR", 8, 3 },
+        { Exchange::Poloniex, "BTC_XC",   "poloniexXcBtc",   "XC",    "BTC", 8, 5 },
+        { Exchange::Poloniex, "BTC_XMR",  "poloniexXmrBtc",  "XMR",   "BTC", 8, 5 }
+    };
+
+    static const char *EXCHANGES[Exchange::Count] = {
+        "Bitfinex",
+        "Cryptsy",
+        "Poloniex"
+    };
+
+    static const int FIRST[Exchange::Count] = {
+        Pair::BitfinexBtcUsd,
+        Pair::CryptsyBtcUsd,
+        Pair::PoloniexBtcUsd
+    };
+
+    static const int LAST[Exchange::Count] = {
+        Pair::BitfinexDrkBtc,
+        Pair::CryptsyXcLtc,
+        Pair::PoloniexXmrBtc
+    };
+
+    // configured exchanges and pairs; the byte arrays own the strings the
+    // pair infos point to
+    struct Configured
+    {
+        QList<QByteArray> strings;
+        QList<QByteArray> exchanges;
+        QVector<int> first;
+        QVector<int> last;
+        QVector<PairInfo> pairs;
+    };
+
+    Configured &configured()
+    {
+        static Configured instance;
+        return instance;
+    }
+
+    const char *intern(const QByteArray &string)
+    {
+        configured().strings.append(string);
+        return configured().strings.last().constData();
+    }
+
+    // generated by tools/gensymbols.py, do not edit
+    static const quint32 SEED = 1;
+    static const int TABLE_SIZE = 64;
+    static const qint8 TABLE[TABLE_SIZE] = {
+        -1, -1, -1, -1, -1, 11, 12,  7, -1, 17, 15, -1, -1, -1,  2, -1,
+         9, -1,  6, -1, -1, 16, -1,  3, 10,  1, -1, 20, -1, -1, -1, -1,
+        -1, -1, -1, 19, -1, 21, -1, -1,  5, -1, -1, -1, 13,  0, -1, 18,
+        -1, -1, -1,  4, -1, -1, -1, -1, -1, -1, 14,  8, -1, -1, -1, -1
+    };
+}
+
+int Symbols::lookup(Exchange::Id exchange, const char *market, int size)
+{
+    if (exchange >= Exchange::Count)
+    {
+        return Pair::Invalid;
+    }
+    int pair = TABLE[hash(exchange, market, size) % TABLE_SIZE];
+    if (pair < 0)
+    {
+        return Pair::Invalid;
+    }
+
+    // keys outside the set hash to arbitrary slots, verify the hit
+    const PairInfo &entry = PAIRS[pair];
+    if (entry.exchange != exchange || int(strlen(entry.market)) != size
+            || memcmp(entry.market, market, size) != 0)
+    {
+        return Pair::Invalid;
+    }
+    return pair;
+}
+
+int Symbols::find(const QString &name)
+{
+    // by accessor name, e.g. "poloniexDrkBtc"; not meant for hot paths
+    for (int pair = 0; pair < count(); pair++)
+    {
+        if (name == QLatin1String(info(pair).name))
+        {
+            return pair;
+        }
+    }
+    return Pair::Invalid;
+}
+
+const char *Symbols::exchangeName(Exchange::Id exchange)
+{
+    if (exchange >= Exchange::Count)
+    {
+        return configured().exchanges.at(exchange - Exchange::Count).constData();
+    }
+    return EXCHANGES[exchange];
+}
+
+const PairInfo &Symbols::info(int pair)
+{
+    if (pair >= Pair::Count)
+    {
+        return configured().pairs.at(pair - Pair::Count);
+    }
+    return PAIRS[pair];
+}
+
+int Symbols::count()
+{
+    return Pair::Count + configured().pairs.size();
+}
+
+int Symbols::first(Exchange::Id exchange)
+{
+    if (exchange >= Exchange::Count)
+    {
+        return configured().first.at(exchange - Exchange::Count);
+    }
+    return FIRST[exchange];
+}
+
+int Symbols::last(Exchange::Id exchange)
+{
+    if (exchange >= Exchange::Count)
+    {
+        return configured().last.at(exchange - Exchange::Count);
+    }
+    return LAST[exchange];
+}
+
+int Symbols::exchangeCount()
+{
+    return Exchange::Count + configured().exchanges.size();
+}
+
+int Symbols::addExchange(const QByteArray &name)
+{
+    // returns the new exchange id, -1 if the name is taken or no id is left
+    for (int exchange = 0; exchange < exchangeCount(); exchange++)
+    {
+        if (qstricmp(name.constData(), exchangeName(Exchange::Id(exchange))) == 0)
+        {
+            return -1;
+        }
+    }
+    if (name.isEmpty() || exchangeCount() > Exchange::Max)
+    {
+        return -1;
+    }
+
+    Configured &extra = configured();
+    extra.exchanges.append(name);
+    extra.first.append(Pair::Invalid);
+    extra.last.append(Pair::Invalid);
+    return exchangeCount() - 1;
+}
+
+int Symbols::addPair(int exchange, const QByteArray &market, const QByteArray &base,
+                     const QByteArray &quote, int scale, int precision)
+{
+    // pairs of one exchange have to be added in one go, they form a range;
+    // the accessor name follows the built-ins, e.g. "bittrexDrkBtc"
+    Configured &extra = configured();
+    int index = exchange - Exchange::Count;
+    if (index < 0 || index >= extra.exchanges.size() || market.isEmpty() || base.isEmpty() || quote.isEmpty()
+            || (extra.last.at(index) != Pair::Invalid && extra.last.at(index) != count() - 1))
+    {
+        return Pair::Invalid;
+    }
+
+    QByteArray name = extra.exchanges.at(index).toLower();
+    name.append(base.left(1).toUpper()).append(base.mid(1).toLower());
+    name.append(quote.left(1).toUpper()).append(quote.mid(1).toLower());
+    if (find(QString::fromLatin1(name)) != Pair::Invalid)
+    {
+        return Pair::Invalid;
+    }
+
+    PairInfo info;
+    info.exchange = Exchange::Id(exchange);
+    info.market = intern(market);
+    info.name = intern(name);
+    info.base = intern(base.toUpper());
+    info.quote = intern(quote.toUpper());
+    info.scale = qBound(0, scale, int(Price::MaxScale));
+    info.precision = qBound(0, precision, info.scale);
+    extra.pairs.append(info);
+
+    int pair = count() - 1;
+    if (extra.first.at(index) == Pair::Invalid)
+    {
+        extra.first[index] = pair;
+    }
+    extra.last[index] = pair;
+    return pair;
+}
+
+quint32 Symbols::hash(Exchange::Id exchange, const char *market, int size)
+{
+    // fnv-1a over the exchange id and the market key
+    quint32 h = 2166136261u ^ SEED;
+    h ^= quint8(exchange);
+    h *= 16777619u;
+    for (int i = 0; i < size; i++)
+    {
+        h ^= quint8(market[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void Symbols::measure(MemoryReport &report)
+{
+    // the built-in tables are static data, only the configured part lives
+    // on the heap
+    const Configured &registry = configured();
+    for (int i = 0; i < registry.strings.size(); i++)
+    {
+        report.add(MemoryReport::Parsers, sizeof(QByteArray));
+        report.add(MemoryReport::Parsers, registry.strings.at(i));
+    }
+    for (int i = 0; i < registry.exchanges.size(); i++)
+    {
+        report.add(MemoryReport::Parsers, registry.exchanges.at(i));
+    }
+    report.add(MemoryReport::Parsers, registry.first);
+    report.add(MemoryReport::Parsers, registry.last);
+    report.add(MemoryReport::Parsers, registry.pairs);
+}
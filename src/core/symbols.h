@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QByteArray>
+
+class MemoryReport;
+
+namespace Exchange {
+    enum Id {
+        Bitfinex,
+        Cryptsy,
+        Poloniex,
+        Count,
+        Max = 31        // configured exchanges take the ids after Count
+    };
+}
+
+namespace Pair {
+    enum Id {
+        Invalid = -1,
+        BitfinexBtcUsd,
+        BitfinexDrkUsd,
+        BitfinexDrkBtc,
+        CryptsyBtcUsd,
+        CryptsyDrkUsd,
+        CryptsyDrkBtc,
+        CryptsyDrkLtc,
+        CryptsyAncBtc,
+        CryptsyAncLtc,
+        CryptsyBtcdBtc,
+        CryptsyCloakBtc,
+        CryptsyCloakLtc,
+        CryptsyXcBtc,
+        CryptsyXcLtc,
+        PoloniexBtcUsd,
+        PoloniexXmrUsd,
+        PoloniexDrkBtc,
+        PoloniexDrkXmr,
+        PoloniexBtcdBtc,
+        PoloniexBtcdXmr,
+        PoloniexXcBtc,
+        PoloniexXmrBtc,
+        Count
+    };
+}
+
+struct PairInfo
+{
+    Exchange::Id exchange;
+    const char *market;     // identifier used by the exchange api
+    const char *name;       // ticker handler accessor name
+    const char *base;
+    const char *quote;
+    int scale;              // fixed-point scale of stored prices
+    int precision;          // displayed decimals
+};
+
+/*
+ * Interned registry of all markets. Every exchange market identifier maps to
+ * a compact pair id through a generated perfect hash (see tools/gensymbols.py),
+ * so resolving a key from a reply costs one hash and one compare.
+ *
+ * Exchanges and markets from the exchange config are appended behind the
+ * built-in ones at startup, before anything sizes its tables by count().
+ * Their parsers know their pair ids, so lookup() only covers built-ins.
+ */
+class Symbols
+{
+public:
+    static int lookup(Exchange::Id exchange, const char *market, int size);
+    static int find(const QString &name);
+    static const char *exchangeName(Exchange::Id exchange);
+    static const PairInfo &info(int pair);
+    static int count();
+    static int first(Exchange::Id exchange);
+    static int last(Exchange::Id exchange);
+    static int exchangeCount();
+
+    static int addExchange(const QByteArray &name);
+    static int addPair(int exchange, const QByteArray &market, const QByteArray &base,
+                       const QByteArray &quote, int scale, int precision);
+    static void measure(MemoryReport &report);
+
+private:
+    static quint32 hash(Exchange::Id exchange, const char *market, int size);
+};
+
+#endif // SYMBOLS_H
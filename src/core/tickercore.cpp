@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QTimer>
+
+#include "tickercore.h"
+#include "trace.h"
+#include "memoryreport.h"
+
+TickerCore::TickerCore(QObject *parent)
+    :   QObject(parent)
+    ,   m_consensus(&m_prices, this)
+    ,   m_usage(this)
+    ,   m_trades(&m_usage, this)
+    ,   m_charts(&m_ticks)
+    ,   m_backfill(&m_ticks, &m_usage, this)
+    ,   m_statistics(20, this)
+    ,   m_alerts(this)
+    ,   m_portfolio(&m_prices, this)
+    ,   m_network(this)
+    ,   m_bitfinex(&m_prices, &m_usage, this)
+    ,   m_cryptsy(&m_prices, &m_books, &m_usage, this)
+    ,   m_poloniex(&m_prices, &m_books, &m_usage, this)
+    ,   m_lock(RecordFile::dataPath(QString("writer.lock")))
+    ,   m_fetching(0)
+    ,   m_mirror(false)
+    ,   m_writer(false)
+{
+    connect(&m_bitfinex, SIGNAL(quoteUpdated(int)), this, SLOT(ingest(int)));
+    connect(&m_cryptsy, SIGNAL(quoteUpdated(int)), this, SLOT(ingest(int)));
+    connect(&m_poloniex, SIGNAL(quoteUpdated(int)), this, SLOT(ingest(int)));
+    connect(&m_cryptsy, SIGNAL(bookUpdated(int)), this, SIGNAL(bookUpdated(int)));
+    connect(&m_poloniex, SIGNAL(bookUpdated(int)), this, SIGNAL(bookUpdated(int)));
+    connect(&m_bitfinex, SIGNAL(fetched()), this, SLOT(onExchangeFetched()));
+    connect(&m_cryptsy, SIGNAL(fetched()), this, SLOT(onExchangeFetched()));
+    connect(&m_poloniex, SIGNAL(fetched()), this, SLOT(onExchangeFetched()));
+    // a lock is only stale once its process is gone, never by age
+    m_lock.setStaleLockTime(0);
+    claim();
+    connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(flushHistory()));
+
+    m_usage.setMetered(m_network.isMetered());
+    connect(&m_network, SIGNAL(meteredChanged(bool)), &m_usage, SLOT(setMetered(bool)));
+
+    const QList<ExchangeConfig::Definition> &definitions = ExchangeConfig::definitions();
+    for (int i = 0; i < definitions.size(); i++)
+    {
+        ConfigExchange *exchange = new ConfigExchange(definitions.at(i), &m_prices, &m_usage, this);
+        connect(exchange, SIGNAL(quoteUpdated(int)), this, SLOT(ingest(int)));
+        connect(exchange, SIGNAL(fetched()), this, SLOT(onExchangeFetched()));
+        m_configured.append(exchange);
+    }
+}
+
+TickerCore::~TickerCore()
+{
+    // while the writer lock is still held
+    flushHistory();
+}
+
+PriceTable *TickerCore::prices()
+{
+    return &m_prices;
+}
+
+Consensus *TickerCore::consensus()
+{
+    return &m_consensus;
+}
+
+OrderBooks *TickerCore::books()
+{
+    return &m_books;
+}
+
+DataUsage *TickerCore::usage()
+{
+    return &m_usage;
+}
+
+TradeFeed *TickerCore::trades()
+{
+    return &m_trades;
+}
+
+NetworkMonitor *TickerCore::network()
+{
+    return &m_network;
+}
+
+CandleAggregator *TickerCore::candles()
+{
+    return &m_candles;
+}
+
+TickLog *TickerCore::ticks()
+{
+    return &m_ticks;
+}
+
+ChartCache *TickerCore::charts()
+{
+    return &m_charts;
+}
+
+Backfill *TickerCore::backfill()
+{
+    return &m_backfill;
+}
+
+Statistics *TickerCore::statistics()
+{
+    return &m_statistics;
+}
+
+AlertEngine *TickerCore::alerts()
+{
+    return &m_alerts;
+}
+
+Portfolio *TickerCore::portfolio()
+{
+    return &m_portfolio;
+}
+
+bool TickerCore::isFetching()
+{
+    return m_fetching != 0;
+}
+
+bool TickerCore::isMirror()
+{
+    return m_mirror;
+}
+
+void TickerCore::setMirror(bool mirror)
+{
+    m_mirror = mirror;
+    if (mirror && m_writer)
+    {
+        // the process we mirror takes over the history
+        flushHistory();
+        m_lock.unlock();
+        m_writer = false;
+    }
+    claim();
+}
+
+void TickerCore::flushHistory()
+{
+    // batched ticks, open candles and today's valuation, at shutdown or
+    // before the lock is handed over
+    if (m_writer)
+    {
+        m_ticks.flush();
+        m_candles.flush();
+        m_portfolio.flush();
+    }
+}
+
+bool TickerCore::isWriter()
+{
+    return m_writer;
+}
+
+void TickerCore::claim()
+{
+    if (!m_mirror && !m_writer)
+    {
+        m_writer = m_lock.tryLock(0);
+        if (m_writer)
+        {
+            m_portfolio.reload();
+        }
+    }
+    m_usage.setCounting(m_writer);
+    m_portfolio.setRecording(m_writer);
+}
+
+void TickerCore::fetch()
+{
+    // an exchange still busy with the last cycle reports fetched() only once
+    claim();
+    quint32 busy = m_fetching;
+    if (m_bitfinex.fetch())
+    {
+        m_fetching |= BitfinexBusy;
+    }
+    if (m_cryptsy.fetch())
+    {
+        m_fetching |= CryptsyBusy;
+    }
+    if (m_poloniex.fetch())
+    {
+        m_fetching |= PoloniexBusy;
+    }
+    for (int i = 0; i < m_configured.size(); i++)
+    {
+        if (m_configured.at(i)->fetch())
+        {
+            m_fetching |= quint32(ConfiguredBusy) << i;
+        }
+    }
+
+    if (busy == 0 && m_fetching != 0)
+    {
+        Trace::asyncBegin("core", "cycle", quintptr(this));
+    }
+
+    // trades are not part of the cycle, fetched() does not wait for them
+    if (m_trades.isEnabled())
+    {
+        m_trades.fetch();
+    }
+
+    // every breaker is open, the cycle is over right away
+    if (m_fetching == 0)
+    {
+        QTimer::singleShot(0, this, SIGNAL(fetched()));
+    }
+}
+
+void TickerCore::ingest(int pair)
+{
+    TRACE_SCOPE("core", "ingest");
+    const Quote &quote = m_prices.quote(pair);
+    if (m_writer)
+    {
+        m_ticks.add(pair, quote.value.mantissa(), quote.updated);
+        m_candles.add(pair, quote.value, quote.updated);
+    }
+    m_charts.add(pair, quote.value.mantissa(), quote.updated);
+    m_consensus.add(pair);
+    Price volume = m_prices.has(pair, PriceTable::Volume) ? m_prices.field(pair, PriceTable::Volume) : Price();
+    m_statistics.add(pair, quote.value, volume, quote.updated);
+    m_alerts.add(pair, quote.value);
+    m_portfolio.add(pair, quote.updated);
+    emit quoteUpdated(pair);
+}
+
+bool TickerCore::fetchBook(int pair)
+{
+    // bitfinex books are not fetched, its ticker only carries the top
+    switch (Symbols::info(pair).exchange)
+    {
+    case Exchange::Cryptsy:
+        return m_cryptsy.fetchBook(pair);
+    case Exchange::Poloniex:
+        return m_poloniex.fetchBook(pair);
+    default:
+        return false;
+    }
+}
+
+void TickerCore::onExchangeFetched()
+{
+    quint32 busy = m_fetching;
+    if (sender() == &m_bitfinex)
+    {
+        m_fetching &= ~BitfinexBusy;
+    }
+    else if (sender() == &m_cryptsy)
+    {
+        m_fetching &= ~CryptsyBusy;
+    }
+    else if (sender() == &m_poloniex)
+    {
+        m_fetching &= ~PoloniexBusy;
+    }
+    else
+    {
+        int index = m_configured.indexOf(static_cast<ConfigExchange *>(sender()));
+        if (index >= 0)
+        {
+            m_fetching &= ~(quint32(ConfiguredBusy) << index);
+        }
+    }
+
+    if (busy != 0 && m_fetching == 0)
+    {
+        Trace::asyncEnd("core", "cycle", quintptr(this));
+        m_usage.save();
+        // a no-op unless polling paused long enough to leave a gap
+        if (m_writer)
+        {
+            m_backfill.closeGaps();
+        }
+        emit fetched();
+    }
+}
+
+void TickerCore::measure(MemoryReport &report) const
+{
+    Symbols::measure(report);
+    m_prices.measure(report);
+    m_consensus.measure(report);
+    m_books.measure(report);
+    m_trades.measure(report);
+    m_candles.measure(report);
+    m_ticks.measure(report);
+    m_charts.measure(report);
+    m_backfill.measure(report);
+    m_statistics.measure(report);
+    m_alerts.measure(report);
+    m_portfolio.measure(report);
+    m_bitfinex.measure(report);
+    m_cryptsy.measure(report);
+    m_poloniex.measure(report);
+    for (int i = 0; i < m_configured.size(); i++)
+    {
+        m_configured.at(i)->measure(report);
+    }
+}
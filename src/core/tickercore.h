@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICKERCORE_H
+#define TICKERCORE_H
+
+#include <QObject>
+#include <QList>
+#include <QLockFile>
+
+#include "exchangeconfig.h"
+#include "pricetable.h"
+#include "consensus.h"
+#include "orderbook.h"
+#include "datausage.h"
+#include "trades.h"
+#include "networkmonitor.h"
+#include "candles.h"
+#include "ticklog.h"
+#include "chartcache.h"
+#include "backfill.h"
+#include "statistics.h"
+#include "alerts.h"
+#include "portfolio.h"
+#include "bitfinex.h"
+#include "cryptsy.h"
+#include "poloniex.h"
+#include "configexchange.h"
+
+/*
+ * Headless ticker engine: owns the exchanges, the price table and everything
+ * derived from the quotes. It only depends on QtCore and QtNetwork, so the
+ * Sailfish app, the command line tool and benchmarks share it.
+ *
+ * Every good quote of an exchange goes through ingest(), which feeds the
+ * tick log, candles, consensus, statistics, alerts and portfolio before
+ * quoteUpdated() is emitted. A mirror core gets its quotes from another process, which also
+ * owns the tick and candle history, so it only keeps the in-memory data up to
+ * date.
+ *
+ * Exchanges from the exchange config run next to the built-in ones; the
+ * config is loaded before any table is sized.
+ *
+ * Every reply is counted in the data usage of its exchange. Only the
+ * polling process counts, a mirror core reloads the stored totals.
+ *
+ * The app, the service and the command line tool share one data directory.
+ * Only the core holding writer.lock there records ticks, candles, the
+ * valuation history and data usage; every other one runs like a mirror and
+ * tries to take the lock over again on each fetch().
+ */
+class TickerCore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TickerCore(QObject *parent = 0);
+    ~TickerCore();
+
+    PriceTable *prices();
+    Consensus *consensus();
+    OrderBooks *books();
+    DataUsage *usage();
+    TradeFeed *trades();
+    NetworkMonitor *network();
+    CandleAggregator *candles();
+    TickLog *ticks();
+    ChartCache *charts();
+    Backfill *backfill();
+    Statistics *statistics();
+    AlertEngine *alerts();
+    Portfolio *portfolio();
+
+    bool isFetching();
+    bool isMirror();
+    void setMirror(bool mirror);
+    bool isWriter();
+    void measure(MemoryReport &report) const;
+
+public slots:
+    void fetch();
+    void ingest(int pair);
+    bool fetchBook(int pair);
+
+signals:
+    void quoteUpdated(int pair);
+    void bookUpdated(int pair);
+    void fetched();
+
+private slots:
+    void onExchangeFetched();
+    void flushHistory();
+
+private:
+    enum Busy
+    {
+        BitfinexBusy = 0x1,
+        CryptsyBusy = 0x2,
+        PoloniexBusy = 0x4,
+        ConfiguredBusy = 0x8    // shifted by the index of the exchange, as quint32
+    };
+
+    void claim();
+
+    ExchangeConfig m_config;
+    PriceTable m_prices;
+    Consensus m_consensus;
+    OrderBooks m_books;
+    DataUsage m_usage;
+    TradeFeed m_trades;
+    CandleAggregator m_candles;
+    TickLog m_ticks;
+    ChartCache m_charts;
+    Backfill m_backfill;
+    Statistics m_statistics;
+    AlertEngine m_alerts;
+    Portfolio m_portfolio;
+    NetworkMonitor m_network;
+
+    BitFinex m_bitfinex;
+    Cryptsy m_cryptsy;
+    PoloniEx m_poloniex;
+    QList<ConfigExchange *> m_configured;
+
+    QLockFile m_lock;
+    quint32 m_fetching;         // one bit per exchange, up to Exchange::Max
+    bool m_mirror;
+    bool m_writer;
+};
+
+#endif // TICKERCORE_H
@@ -0,0 +1,767 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <unistd.h>
+
+#include "ticklog.h"
+#include "recordfile.h"
+#include "symbols.h"
+#include "memoryreport.h"
+
+namespace {
+    static const quint32 MAGIC = 0x324c5444;    // "DTL2"
+    static const uint DAY = 86400;
+
+    quint32 crc32(const uchar *data, int size)
+    {
+        static quint32 table[256];
+        static bool ready = false;
+        if (!ready)
+        {
+            for (quint32 i = 0; i < 256; i++)
+            {
+                quint32 c = i;
+                for (int k = 0; k < 8; k++)
+                {
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                table[i] = c;
+            }
+            ready = true;
+        }
+
+        quint32 crc = 0xffffffffu;
+        for (int i = 0; i < size; i++)
+        {
+            crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        return crc ^ 0xffffffffu;
+    }
+
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(QByteArray &out)
+            :   m_out(out)
+            ,   m_byte(0)
+            ,   m_bits(0)
+        {
+        }
+
+        void write(quint64 value, int count)
+        {
+            while (count > 0)
+            {
+                int take = qMin(count, 8 - m_bits);
+                count -= take;
+                m_byte = uchar((m_byte << take) | ((value >> count) & ((1u << take) - 1)));
+                m_bits += take;
+                if (m_bits == 8)
+                {
+                    m_out.append(char(m_byte));
+                    m_byte = 0;
+                    m_bits = 0;
+                }
+            }
+        }
+
+        void finish()
+        {
+            if (m_bits > 0)
+            {
+                m_out.append(char(m_byte << (8 - m_bits)));
+                m_byte = 0;
+                m_bits = 0;
+            }
+        }
+
+    private:
+        QByteArray &m_out;
+        uchar m_byte;
+        int m_bits;
+    };
+
+    class BitReader
+    {
+    public:
+        BitReader(const uchar *data, int size)
+            :   m_data(data)
+            ,   m_size(qint64(size) * 8)
+            ,   m_position(0)
+        {
+        }
+
+        bool read(int count, quint64 &value)
+        {
+            if (m_position + count > m_size)
+            {
+                return false;
+            }
+            value = 0;
+            while (count > 0)
+            {
+                int offset = int(m_position & 7);
+                int take = qMin(count, 8 - offset);
+                uchar byte = m_data[m_position >> 3];
+                value = (value << take) | ((byte >> (8 - offset - take)) & ((1u << take) - 1));
+                m_position += take;
+                count -= take;
+            }
+            return true;
+        }
+
+        bool bit(bool &set)
+        {
+            quint64 value;
+            if (!read(1, value))
+            {
+                return false;
+            }
+            set = value != 0;
+            return true;
+        }
+
+    private:
+        const uchar *m_data;
+        qint64 m_size;
+        qint64 m_position;
+    };
+
+    // delta-of-delta buckets: control bits, control length, value bits
+    struct Bucket
+    {
+        quint64 control;
+        int controlBits;
+        int valueBits;
+    };
+
+    static const Bucket BUCKETS[] = {
+        { 0x2, 2, 7 },
+        { 0x6, 3, 9 },
+        { 0xe, 4, 12 },
+        { 0xf, 4, 40 }
+    };
+    static const int BUCKET_COUNT = 4;
+
+    bool earlier(const Tick &a, const Tick &b)
+    {
+        return a.timestamp < b.timestamp;
+    }
+
+    int leadingZeros(quint64 value)
+    {
+        return __builtin_clzll(value);
+    }
+
+    int trailingZeros(quint64 value)
+    {
+        return __builtin_ctzll(value);
+    }
+}
+
+TickLog::TickLog(const QString &directory)
+    :   m_path(RecordFile::dataPath(directory))
+    ,   m_pending(Symbols::count())
+    ,   m_stretches(Symbols::count())
+    ,   m_flushed(0)
+{
+    for (int pair = 0; pair < m_stretches.size(); pair++)
+    {
+        m_stretches[pair].since = 0;
+        m_stretches[pair].latest = 0;
+        m_stretches[pair].gap = 0;
+    }
+    QDir().mkpath(m_path);
+}
+
+TickLog::~TickLog()
+{
+    flush();
+}
+
+void TickLog::add(int pair, qint64 mantissa, uint timestamp)
+{
+    QVector<Tick> &pending = m_pending[pair];
+
+    // a block never crosses the end of a day
+    if (!pending.isEmpty() && timestamp / DAY != pending.first().timestamp / DAY)
+    {
+        write(pair);
+    }
+
+    Tick tick;
+    tick.timestamp = timestamp;
+    tick.mantissa = mantissa;
+    pending.append(tick);
+
+    if (pending.size() >= BlockSamples)
+    {
+        write(pair);
+    }
+
+    Stretch &stretch = m_stretches[pair];
+    if (stretch.since == 0 || timestamp > stretch.latest + LiveGap)
+    {
+        stretch.gap = stretch.latest;
+        stretch.since = timestamp;
+    }
+    stretch.latest = qMax(stretch.latest, timestamp);
+
+    if (m_flushed == 0)
+    {
+        m_flushed = timestamp;
+    }
+    else if (timestamp >= m_flushed + FlushInterval)
+    {
+        flush();
+        m_flushed = timestamp;
+    }
+}
+
+void TickLog::flush()
+{
+    for (int pair = 0; pair < m_pending.size(); pair++)
+    {
+        if (!m_pending.at(pair).isEmpty())
+        {
+            write(pair);
+        }
+    }
+}
+
+int TickLog::merge(int pair, QVector<Tick> ticks, uint tolerance)
+{
+    // returns the number of ticks added; a tick within tolerance seconds of
+    // a known one is a duplicate
+    std::sort(ticks.begin(), ticks.end(), earlier);
+    int added = 0;
+    int i = 0;
+    while (i < ticks.size())
+    {
+        uint day = ticks.at(i).timestamp - ticks.at(i).timestamp % DAY;
+        int end = i;
+        while (end < ticks.size() && ticks.at(end).timestamp - ticks.at(end).timestamp % DAY == day)
+        {
+            end++;
+        }
+
+        QVector<Tick> existing;
+        TickCursor cursor(this, pair, day, day + DAY - 1);
+        Tick tick;
+        while (cursor.next(tick))
+        {
+            existing.append(tick);
+        }
+        QVector<Tick> &pending = m_pending[pair];
+        bool withPending = !pending.isEmpty() && pending.first().timestamp - pending.first().timestamp % DAY == day;
+        if (withPending)
+        {
+            existing += pending;
+        }
+        std::sort(existing.begin(), existing.end(), earlier);
+
+        QVector<Tick> merged = existing;
+        int count = 0;
+        for (int j = i; j < end; j++)
+        {
+            const Tick &candidate = ticks.at(j);
+            QVector<Tick>::const_iterator next = std::lower_bound(existing.constBegin(), existing.constEnd(), candidate, earlier);
+            bool duplicate = (next != existing.constEnd() && next->timestamp - candidate.timestamp <= tolerance)
+                || (next != existing.constBegin() && candidate.timestamp - (next - 1)->timestamp <= tolerance)
+                || (count > 0 && candidate.timestamp == merged.last().timestamp);
+            if (!duplicate)
+            {
+                merged.append(candidate);
+                count++;
+            }
+        }
+
+        if (count > 0)
+        {
+            std::stable_sort(merged.begin(), merged.end(), earlier);
+            if (rewrite(pair, day, merged))
+            {
+                added += count;
+                if (withPending)
+                {
+                    pending.clear();
+                }
+            }
+        }
+        i = end;
+    }
+    return added;
+}
+
+QVector<Tick> TickLog::read(int pair, uint from, uint to)
+{
+    QVector<Tick> ticks;
+    TickCursor cursor(this, pair, from, to);
+    Tick tick;
+    while (cursor.next(tick))
+    {
+        ticks.append(tick);
+    }
+
+    // ticks not written yet are part of the history as well
+    const QVector<Tick> &pending = m_pending.at(pair);
+    for (int i = 0; i < pending.size(); i++)
+    {
+        if (pending.at(i).timestamp >= from && pending.at(i).timestamp <= to)
+        {
+            ticks.append(pending.at(i));
+        }
+    }
+    return ticks;
+}
+
+QVector<Tick> TickLog::pending(int pair) const
+{
+    // not written yet, in time order
+    return m_pending.at(pair);
+}
+
+uint TickLog::liveSince(int pair) const
+{
+    return m_stretches.at(pair).since;
+}
+
+uint TickLog::gapSince(int pair) const
+{
+    return m_stretches.at(pair).gap;
+}
+
+QString TickLog::segment(int pair, uint day) const
+{
+    QString date = QDateTime::fromTime_t(day).toUTC().toString("yyyyMMdd");
+    return QString("%1/%2-%3.tlg").arg(m_path).arg(Symbols::info(pair).name).arg(date);
+}
+
+QString TickLog::path() const
+{
+    return m_path;
+}
+
+QByteArray TickLog::encode(const Tick *ticks, int count, int scale)
+{
+    // one bit stream per column, timestamps first
+    QByteArray timeColumn;
+    QByteArray valueColumn;
+    timeColumn.reserve(count);
+    valueColumn.reserve(count * 3);
+    BitWriter times(timeColumn);
+    BitWriter values(valueColumn);
+    qint64 delta = 0;
+    int leading = -1;
+    int trailing = 0;
+    for (int i = 1; i < count; i++)
+    {
+        qint64 current = qint64(ticks[i].timestamp) - qint64(ticks[i - 1].timestamp);
+        qint64 dod = current - delta;
+        delta = current;
+        if (dod == 0)
+        {
+            times.write(0, 1);
+        }
+        else
+        {
+            for (int b = 0; b < BUCKET_COUNT; b++)
+            {
+                qint64 half = qint64(1) << (BUCKETS[b].valueBits - 1);
+                if ((dod >= -(half - 1) && dod <= half) || b == BUCKET_COUNT - 1)
+                {
+                    times.write(BUCKETS[b].control, BUCKETS[b].controlBits);
+                    times.write(quint64(dod + half - 1), BUCKETS[b].valueBits);
+                    break;
+                }
+            }
+        }
+
+        quint64 bits = quint64(ticks[i].mantissa) ^ quint64(ticks[i - 1].mantissa);
+        if (bits == 0)
+        {
+            values.write(0, 1);
+            continue;
+        }
+        values.write(1, 1);
+        int lead = leadingZeros(bits);
+        int trail = trailingZeros(bits);
+        if (leading >= 0 && lead >= leading && trail >= trailing)
+        {
+            // fits into the window of the previous value
+            values.write(0, 1);
+            values.write(bits >> trailing, 64 - leading - trailing);
+        }
+        else
+        {
+            leading = lead;
+            trailing = trail;
+            int meaningful = 64 - lead - trail;
+            values.write(1, 1);
+            values.write(quint64(lead), 6);
+            values.write(quint64(meaningful - 1), 6);
+            values.write(bits >> trail, meaningful);
+        }
+    }
+    times.finish();
+    values.finish();
+
+    QByteArray block(HeaderSize, 0);
+    block.reserve(HeaderSize + timeColumn.size() + valueColumn.size());
+    block.append(timeColumn).append(valueColumn);
+
+    uchar *header = reinterpret_cast<uchar *>(block.data());
+    qToLittleEndian<quint32>(MAGIC, header);
+    qToLittleEndian<quint32>(ticks[0].timestamp, header + 8);
+    qToLittleEndian<quint32>(ticks[count - 1].timestamp, header + 12);
+    qToLittleEndian<qint64>(ticks[0].mantissa, header + 16);
+    qToLittleEndian<quint16>(quint16(count), header + 24);
+    header[26] = uchar(scale);
+    header[27] = 0;
+    qToLittleEndian<quint16>(quint16(timeColumn.size()), header + 28);
+    qToLittleEndian<quint16>(quint16(valueColumn.size()), header + 30);
+    qToLittleEndian<quint32>(crc32(header + 8, block.size() - 8), header + 4);
+    return block;
+}
+
+int TickLog::blockSize(const char *header, int available)
+{
+    // size of a valid block header, 0 if it is torn or corrupt
+    if (available < HeaderSize)
+    {
+        return 0;
+    }
+    const uchar *data = reinterpret_cast<const uchar *>(header);
+    if (qFromLittleEndian<quint32>(data) != MAGIC || qFromLittleEndian<quint16>(data + 24) == 0)
+    {
+        return 0;
+    }
+    qint64 size = qint64(HeaderSize) + qFromLittleEndian<quint16>(data + 28) + qFromLittleEndian<quint16>(data + 30);
+    if (size > available)
+    {
+        return 0;
+    }
+    return int(size);
+}
+
+int TickLog::decode(const char *block, int size, QVector<Tick> &ticks)
+{
+    // returns the number of decoded ticks, -1 if the block is corrupt
+    ticks.clear();
+    const uchar *data = reinterpret_cast<const uchar *>(block);
+    if (blockSize(block, size) != size || qFromLittleEndian<quint32>(data + 4) != crc32(data + 8, size - 8))
+    {
+        return -1;
+    }
+
+    int count = qFromLittleEndian<quint16>(data + 24);
+    Tick tick;
+    tick.timestamp = qFromLittleEndian<quint32>(data + 8);
+    tick.mantissa = qFromLittleEndian<qint64>(data + 16);
+    ticks.reserve(count);
+    ticks.append(tick);
+
+    int timeBytes = qFromLittleEndian<quint16>(data + 28);
+    BitReader times(data + HeaderSize, timeBytes);
+    BitReader values(data + HeaderSize + timeBytes, size - HeaderSize - timeBytes);
+    qint64 delta = 0;
+    int leading = 0;
+    int trailing = 0;
+    quint64 value;
+    bool set;
+    for (int i = 1; i < count; i++)
+    {
+        if (!times.bit(set))
+        {
+            return -1;
+        }
+        if (set)
+        {
+            int b = 0;
+            while (b < BUCKET_COUNT - 1)
+            {
+                if (!times.bit(set))
+                {
+                    return -1;
+                }
+                if (!set)
+                {
+                    break;
+                }
+                b++;
+            }
+            if (!times.read(BUCKETS[b].valueBits, value))
+            {
+                return -1;
+            }
+            qint64 half = qint64(1) << (BUCKETS[b].valueBits - 1);
+            delta += qint64(value) - (half - 1);
+        }
+        tick.timestamp = uint(qint64(tick.timestamp) + delta);
+
+        if (!values.bit(set))
+        {
+            return -1;
+        }
+        if (set)
+        {
+            if (!values.bit(set))
+            {
+                return -1;
+            }
+            if (set)
+            {
+                if (!values.read(6, value))
+                {
+                    return -1;
+                }
+                leading = int(value);
+                if (!values.read(6, value))
+                {
+                    return -1;
+                }
+                trailing = 64 - leading - (int(value) + 1);
+                if (trailing < 0)
+                {
+                    return -1;
+                }
+            }
+            if (!values.read(64 - leading - trailing, value))
+            {
+                return -1;
+            }
+            tick.mantissa = qint64(quint64(tick.mantissa) ^ (value << trailing));
+        }
+        ticks.append(tick);
+    }
+    return ticks.size();
+}
+
+void TickLog::write(int pair)
+{
+    // blocks of at most BlockSamples ticks, never crossing the end of a day
+    QVector<Tick> &pending = m_pending[pair];
+    int scale = Symbols::info(pair).scale;
+    while (!pending.isEmpty())
+    {
+        uint day = pending.first().timestamp - pending.first().timestamp % DAY;
+        int count = 1;
+        while (count < pending.size() && count < BlockSamples && pending.at(count).timestamp - pending.at(count).timestamp % DAY == day)
+        {
+            count++;
+        }
+
+        // unbuffered, so nothing of a failed write is retried on close
+        QFile file(segment(pair, day));
+        if (!file.open(QIODevice::ReadWrite | QIODevice::Unbuffered) || !recover(file))
+        {
+            break;
+        }
+        QByteArray block = encode(pending.constData(), count, scale);
+        qint64 size = file.size();
+        file.seek(size);
+        if (file.write(block) != block.size() || fsync(file.handle()) != 0)
+        {
+            // cut the torn block off, or have the next write look again
+            if (!file.resize(size))
+            {
+                m_recovered.remove(file.fileName());
+            }
+            break;
+        }
+        file.close();
+        pending.remove(0, count);
+    }
+
+    // keep the ticks for the next attempt, but never grow without bound
+    if (pending.size() >= 4 * BlockSamples)
+    {
+        pending.clear();
+    }
+}
+
+bool TickLog::rewrite(int pair, uint day, const QVector<Tick> &ticks)
+{
+    // the old segment stays in place until the new one is complete
+    QSaveFile file(segment(pair, day));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    int scale = Symbols::info(pair).scale;
+    for (int i = 0; i < ticks.size(); i += BlockSamples)
+    {
+        QByteArray block = encode(ticks.constData() + i, qMin(int(BlockSamples), ticks.size() - i), scale);
+        if (file.write(block) != block.size())
+        {
+            file.cancelWriting();
+            return false;
+        }
+    }
+    if (!file.commit())
+    {
+        return false;
+    }
+    m_recovered.insert(file.fileName());
+    return true;
+}
+
+bool TickLog::recover(QFile &file)
+{
+    // validate a segment once per run, the first write may follow a crash
+    if (m_recovered.contains(file.fileName()))
+    {
+        return true;
+    }
+
+    QByteArray data = file.readAll();
+    int offset = 0;
+    while (offset < data.size())
+    {
+        int size = blockSize(data.constData() + offset, data.size() - offset);
+        const uchar *block = reinterpret_cast<const uchar *>(data.constData() + offset);
+        if (size == 0 || qFromLittleEndian<quint32>(block + 4) != crc32(block + 8, size - 8))
+        {
+            break;
+        }
+        offset += size;
+    }
+    if (offset < data.size() && !file.resize(offset))
+    {
+        return false;
+    }
+    m_recovered.insert(file.fileName());
+    return true;
+}
+
+TickCursor::TickCursor(const TickLog *log, int pair, uint from, uint to)
+    :   m_from(from)
+    ,   m_to(to)
+    ,   m_index(0)
+{
+    // segment names sort by date, only the days of the range are visited
+    QString name = QString::fromLatin1(Symbols::info(pair).name);
+    QString first = QFileInfo(log->segment(pair, from - from % DAY)).fileName();
+    QString last = QFileInfo(log->segment(pair, to - to % DAY)).fileName();
+    QDir directory(log->path());
+    QStringList segments = directory.entryList(QStringList() << name + "-*.tlg", QDir::Files, QDir::Name);
+    for (int i = 0; i < segments.size(); i++)
+    {
+        if (segments.at(i) >= first && segments.at(i) <= last)
+        {
+            m_segments.append(directory.filePath(segments.at(i)));
+        }
+    }
+}
+
+bool TickCursor::next(Tick &tick)
+{
+    while (true)
+    {
+        while (m_index < m_ticks.size())
+        {
+            const Tick &current = m_ticks.at(m_index++);
+            if (current.timestamp >= m_from && current.timestamp <= m_to)
+            {
+                tick = current;
+                return true;
+            }
+        }
+        if (!nextBlock())
+        {
+            return false;
+        }
+    }
+}
+
+bool TickCursor::nextBlock()
+{
+    m_ticks.clear();
+    m_index = 0;
+    char header[TickLog::HeaderSize];
+    while (true)
+    {
+        if (!m_file.isOpen())
+        {
+            if (m_segments.isEmpty())
+            {
+                return false;
+            }
+            m_file.setFileName(m_segments.takeFirst());
+            if (!m_file.open(QIODevice::ReadOnly))
+            {
+                continue;
+            }
+        }
+
+        qint64 available = m_file.size() - m_file.pos();
+        if (m_file.read(header, TickLog::HeaderSize) != TickLog::HeaderSize)
+        {
+            m_file.close();
+            continue;
+        }
+        int size = TickLog::blockSize(header, int(qMin(available, qint64(0x7fffffff))));
+        if (size == 0)
+        {
+            // torn tail, nothing valid follows in this segment
+            m_file.close();
+            continue;
+        }
+
+        const uchar *data = reinterpret_cast<const uchar *>(header);
+        uint first = qFromLittleEndian<quint32>(data + 8);
+        uint last = qFromLittleEndian<quint32>(data + 12);
+        if (last < m_from || first > m_to)
+        {
+            m_file.seek(m_file.pos() + size - TickLog::HeaderSize);
+            continue;
+        }
+
+        m_buffer.resize(size);
+        memcpy(m_buffer.data(), header, TickLog::HeaderSize);
+        if (m_file.read(m_buffer.data() + TickLog::HeaderSize, size - TickLog::HeaderSize) != size - TickLog::HeaderSize
+            || TickLog::decode(m_buffer.constData(), size, m_ticks) < 0)
+        {
+            m_file.close();
+            continue;
+        }
+        return true;
+    }
+}
+
+void TickLog::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::History, m_pending);
+    for (int pair = 0; pair < m_pending.size(); pair++)
+    {
+        report.add(MemoryReport::History, m_pending.at(pair));
+    }
+    report.add(MemoryReport::History, m_stretches);
+    QSet<QString>::const_iterator it;
+    for (it = m_recovered.constBegin(); it != m_recovered.constEnd(); ++it)
+    {
+        report.add(MemoryReport::History, sizeof(QString) + 2 * sizeof(void *));
+        report.add(MemoryReport::History, *it);
+    }
+}
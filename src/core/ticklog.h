@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICKLOG_H
+#define TICKLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class MemoryReport;
+
+struct Tick
+{
+    uint timestamp;
+    qint64 mantissa;    // in the scale of the pair
+};
+
+/*
+ * Append-only history of every quote. Each pair gets one segment file per
+ * UTC day in ticks/, made of self-contained blocks:
+ *
+ *   magic, crc32, first and last timestamp, first value, count, scale,
+ *   size of each column, then the columns: a bit stream of delta-of-delta
+ *   timestamps and one of XOR-compressed values.
+ *
+ * Ticks are batched in memory and written a block at a time, either when a
+ * block is full or when FlushInterval seconds of tick time have passed, and
+ * every write is followed by an fsync. A power loss loses at most one
+ * interval; a torn or corrupt block at the end of a segment is cut off
+ * before the segment is appended to again, and readers stop at it. A failed
+ * write is cut off right away and its ticks stay batched for the next one.
+ *
+ * Older ticks, e.g. from a backfill, are merged by rewriting the affected
+ * day segments in time order and replacing them atomically.
+ *
+ * The log also tracks the unbroken stretch of ticks this process added per
+ * pair; a pause of more than LiveGap seconds starts a new one. Only the time
+ * before a stretch needs a backfill.
+ */
+class TickLog
+{
+public:
+    enum {
+        BlockSamples = 256,
+        FlushInterval = 300,
+        HeaderSize = 32,
+        LiveGap = 3600
+    };
+
+    explicit TickLog(const QString &directory = QString("ticks"));
+    ~TickLog();
+
+    void add(int pair, qint64 mantissa, uint timestamp);
+    void flush();
+    int merge(int pair, QVector<Tick> ticks, uint tolerance);
+
+    QVector<Tick> read(int pair, uint from, uint to);
+    QVector<Tick> pending(int pair) const;
+    uint liveSince(int pair) const;
+    uint gapSince(int pair) const;
+    QString segment(int pair, uint day) const;
+    QString path() const;
+    void measure(MemoryReport &report) const;
+
+    static QByteArray encode(const Tick *ticks, int count, int scale);
+    static int decode(const char *block, int size, QVector<Tick> &ticks);
+    static int blockSize(const char *header, int available);
+
+private:
+    void write(int pair);
+    bool recover(QFile &file);
+    bool rewrite(int pair, uint day, const QVector<Tick> &ticks);
+
+    struct Stretch
+    {
+        uint since;     // first tick, 0 before any
+        uint latest;
+        uint gap;       // last tick of the previous stretch, 0 for the first
+    };
+
+    QString m_path;
+    QVector<QVector<Tick> > m_pending;
+    QVector<Stretch> m_stretches;
+    QSet<QString> m_recovered;
+    uint m_flushed;
+};
+
+/*
+ * Sequential reader over the segments of one pair. Only one decoded block is
+ * held at a time, so scans of any range run in constant memory; blocks
+ * outside the range are skipped by their header alone.
+ */
+class TickCursor
+{
+public:
+    TickCursor(const TickLog *log, int pair, uint from, uint to);
+
+    bool next(Tick &tick);
+
+private:
+    bool nextBlock();
+
+    uint m_from;
+    uint m_to;
+    QStringList m_segments;
+    QFile m_file;
+    QByteArray m_buffer;
+    QVector<Tick> m_ticks;
+    int m_index;
+};
+
+#endif // TICKLOG_H
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadStorage>
+
+#include <cstdio>
+
+#include "trace.h"
+
+QBasicAtomicInt Trace::s_enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+    static const QNetworkRequest::Attribute START = QNetworkRequest::Attribute(QNetworkRequest::User + 1);
+
+    struct Event
+    {
+        const char *category;
+        const char *name;
+        qint64 start;
+        qint64 duration;    // complete spans
+        quintptr id;        // async spans
+        char phase;
+    };
+
+    // written by its thread only, count is published after the event
+    struct Buffer
+    {
+        Buffer(int id, const QByteArray &name)
+            :   thread(id)
+            ,   threadName(name)
+            ,   events(new Event[Trace::BufferSize])
+        {
+        }
+
+        int thread;
+        QByteArray threadName;
+        Event *events;
+        QAtomicInt count;
+        QAtomicInt dropped;
+    };
+
+    // QThreadStorage deletes pointers at thread exit, the buffers have to
+    // outlive their threads until the export
+    struct Handle
+    {
+        Handle()
+            :   buffer(0)
+        {
+        }
+
+        Buffer *buffer;
+    };
+
+    struct State
+    {
+        State()
+        {
+            clock.start();
+        }
+
+        QElapsedTimer clock;
+        QMutex mutex;
+        QList<Buffer *> buffers;
+        QThreadStorage<Handle> local;
+        QString path;
+        QAtomicInt requests;
+    };
+
+    State &state()
+    {
+        static State instance;
+        return instance;
+    }
+
+    Buffer *localBuffer()
+    {
+        Handle &handle = state().local.localData();
+        if (!handle.buffer)
+        {
+            QThread *thread = QThread::currentThread();
+            QByteArray name = thread->objectName().toUtf8();
+            if (name.isEmpty())
+            {
+                name = (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+                        ? QByteArray("main") : QByteArray(thread->metaObject()->className());
+            }
+            QMutexLocker lock(&state().mutex);
+            handle.buffer = new Buffer(state().buffers.size() + 1, name);
+            state().buffers.append(handle.buffer);
+        }
+        return handle.buffer;
+    }
+
+    void append(char phase, const char *category, const char *name, qint64 start, qint64 duration, quintptr id = 0)
+    {
+        Buffer *buffer = localBuffer();
+        int count = buffer->count.load();
+        if (count >= Trace::BufferSize)
+        {
+            buffer->dropped.ref();
+            return;
+        }
+        Event &event = buffer->events[count];
+        event.phase = phase;
+        event.category = category;
+        event.name = name;
+        event.start = start;
+        event.duration = duration;
+        event.id = id;
+        buffer->count.storeRelease(count + 1);
+    }
+
+    void writeAtExit()
+    {
+        if (!Trace::write(state().path))
+        {
+            fprintf(stderr, "trace: cannot write %s\n", qPrintable(state().path));
+        }
+    }
+}
+
+void Trace::setEnabled(bool enabled)
+{
+    // starts the clock before any thread asks for it
+    state();
+    s_enabled.store(enabled ? 1 : 0);
+}
+
+void Trace::start(const QString &path)
+{
+    if (state().path.isEmpty())
+    {
+        qAddPostRoutine(writeAtExit);
+    }
+    state().path = path;
+    setEnabled(true);
+}
+
+qint64 Trace::now()
+{
+    return state().clock.nsecsElapsed() / 1000;
+}
+
+void Trace::complete(const char *category, const char *name, qint64 start)
+{
+    append('X', category, name, start, now() - start);
+}
+
+void Trace::begin(const char *category, const char *name)
+{
+    if (isEnabled())
+    {
+        append('B', category, name, now(), 0);
+    }
+}
+
+void Trace::end(const char *category, const char *name)
+{
+    if (isEnabled())
+    {
+        append('E', category, name, now(), 0);
+    }
+}
+
+void Trace::asyncBegin(const char *category, const char *name, quintptr id)
+{
+    if (isEnabled())
+    {
+        append('b', category, name, now(), 0, id);
+    }
+}
+
+void Trace::asyncEnd(const char *category, const char *name, quintptr id)
+{
+    if (isEnabled())
+    {
+        append('e', category, name, now(), 0, id);
+    }
+}
+
+void Trace::stamp(QNetworkRequest &request)
+{
+    if (isEnabled())
+    {
+        request.setAttribute(START, now());
+    }
+}
+
+void Trace::finished(const QNetworkReply *reply, const char *category, const char *name)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+    QVariant start = reply->request().attribute(START);
+    if (start.isValid())
+    {
+        // both ends are only known now, requests overlap each other
+        quintptr id = quintptr(state().requests.fetchAndAddRelaxed(1)) + 1;
+        append('b', category, name, start.toLongLong(), 0, id);
+        append('e', category, name, now(), 0, id);
+    }
+}
+
+QByteArray Trace::toJson()
+{
+    QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray json("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+
+    QMutexLocker lock(&state().mutex);
+    for (int i = 0; i < state().buffers.size(); i++)
+    {
+        const Buffer *buffer = state().buffers.at(i);
+        QByteArray tid = QByteArray::number(buffer->thread);
+        json.append(first ? "\n" : ",\n");
+        first = false;
+        json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid)
+            .append(",\"tid\":").append(tid)
+            .append(",\"args\":{\"name\":\"").append(buffer->threadName).append("\"}}");
+
+        int count = buffer->count.loadAcquire();
+        for (int n = 0; n < count; n++)
+        {
+            const Event &event = buffer->events[n];
+            json.append(",\n{\"name\":\"").append(event.name)
+                .append("\",\"cat\":\"").append(event.category)
+                .append("\",\"ph\":\"").append(event.phase)
+                .append("\",\"ts\":").append(QByteArray::number(event.start));
+            if (event.phase == 'X')
+            {
+                json.append(",\"dur\":").append(QByteArray::number(event.duration));
+            }
+            else if (event.phase == 'b' || event.phase == 'e')
+            {
+                json.append(",\"id\":\"0x").append(QByteArray::number(quint64(event.id), 16)).append('"');
+            }
+            json.append(",\"pid\":").append(pid).append(",\"tid\":").append(tid).append('}');
+        }
+    }
+    json.append("\n]}\n");
+    return json;
+}
+
+bool Trace::write(const QString &path)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    QByteArray json = toJson();
+    return file.write(json) == json.size() && file.commit();
+}
+
+int Trace::dropped()
+{
+    int dropped = 0;
+    QMutexLocker lock(&state().mutex);
+    for (int i = 0; i < state().buffers.size(); i++)
+    {
+        dropped += state().buffers.at(i)->dropped.load();
+    }
+    return dropped;
+}
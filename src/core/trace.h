@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QString>
+
+class QNetworkReply;
+class QNetworkRequest;
+
+/*
+ * Opt-in timeline of the refresh pipeline, exported as Chrome trace-event
+ * JSON (chrome://tracing, Perfetto). Scopes and begin/end pairs have to nest
+ * on their thread, they time parsing, storing and the ui refresh. Requests
+ * and fetch cycles overlap everything else and are async spans with an id
+ * instead. Every thread appends to a buffer of its own without locking; a
+ * full buffer drops further events and counts them.
+ *
+ * Disabled, a TRACE_SCOPE costs one relaxed load of a static atomic flag.
+ * Names and categories are kept as pointers, they have to be string literals.
+ */
+class Trace
+{
+public:
+    enum {
+        BufferSize = 65536     // events per thread
+    };
+
+    class Scope
+    {
+    public:
+        Scope(const char *category, const char *name)
+            :   m_category(category)
+            ,   m_name(name)
+            ,   m_start(isEnabled() ? now() : -1)
+        {
+        }
+
+        ~Scope()
+        {
+            if (m_start >= 0)
+            {
+                complete(m_category, m_name, m_start);
+            }
+        }
+
+    private:
+        const char *m_category;
+        const char *m_name;
+        qint64 m_start;
+    };
+
+    static bool isEnabled()
+    {
+        return s_enabled.load() != 0;
+    }
+
+    static void setEnabled(bool enabled);
+    // enables tracing and writes the timeline to path when the application exits
+    static void start(const QString &path);
+
+    // microseconds on the trace clock
+    static qint64 now();
+    static void complete(const char *category, const char *name, qint64 start);
+    static void begin(const char *category, const char *name);
+    static void end(const char *category, const char *name);
+    static void asyncBegin(const char *category, const char *name, quintptr id);
+    static void asyncEnd(const char *category, const char *name, quintptr id);
+
+    // a request span runs from stamp() to finished()
+    static void stamp(QNetworkRequest &request);
+    static void finished(const QNetworkReply *reply, const char *category, const char *name);
+
+    static QByteArray toJson();
+    static bool write(const QString &path);
+    static int dropped();
+
+private:
+    static QBasicAtomicInt s_enabled;
+};
+
+#define TRACE_JOIN2(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN2(a, b)
+#define TRACE_SCOPE(category, name) Trace::Scope TRACE_JOIN(traceScope, __LINE__)(category, name)
+
+#endif // TRACE_H
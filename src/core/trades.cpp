@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QByteArray>
+#include <QNetworkRequest>
+
+#include "trades.h"
+#include "jsonscanner.h"
+#include "memoryreport.h"
+#include "trace.h"
+
+namespace {
+    static const QString BITFINEX_TRADES = "https://api.bitfinex.com/v1/trades/%1?limit_trades=%2";
+    static const QString POLONIEX_TRADES = "https://poloniex.com/public?command=returnTradeHistory&currencyPair=%1";
+
+    static const int WORDS = SeenWindow::Bits / 64;
+
+    uint digits(const char *p, int count)
+    {
+        uint value = 0;
+        for (int i = 0; i < count; i++)
+        {
+            value = value * 10 + uint(p[i] - '0');
+        }
+        return value;
+    }
+
+    // "2014-12-03 10:00:00" in utc, 0 if malformed
+    uint parseDate(const char *begin, const char *end)
+    {
+        if (end - begin < 19)
+        {
+            return 0;
+        }
+        int year = int(digits(begin, 4));
+        uint month = digits(begin + 5, 2);
+        uint day = digits(begin + 8, 2);
+        if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31)
+        {
+            return 0;
+        }
+
+        // days since the epoch of a proleptic gregorian date
+        year -= month <= 2;
+        int era = year / 400;
+        uint yoe = uint(year - era * 400);
+        uint doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        uint doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        uint days = uint(era * 146097) + doe - 719468;
+        return days * 86400 + digits(begin + 11, 2) * 3600 + digits(begin + 14, 2) * 60 + digits(begin + 17, 2);
+    }
+
+    quint64 parseId(const char *begin, const char *end)
+    {
+        quint64 value = 0;
+        for (const char *p = begin; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+            value = value * 10 + quint64(*p - '0');
+        }
+        return value;
+    }
+}
+
+SeenWindow::SeenWindow()
+    :   m_words(WORDS, 0)
+    ,   m_base(0)
+    ,   m_empty(true)
+{
+}
+
+bool SeenWindow::insert(quint64 id)
+{
+    // returns true if the id was not seen before
+    if (m_empty)
+    {
+        // start with the id in the middle, late older ids still fit
+        m_base = (id - qMin(id, quint64(Bits / 2))) & ~quint64(63);
+        m_empty = false;
+    }
+    if (id < m_base)
+    {
+        return false;
+    }
+    if (id >= m_base + Bits)
+    {
+        // slide forward, the words leaving the window are reused
+        quint64 base = ((id >> 6) - WORDS + 1) << 6;
+        quint64 moved = (base - m_base) >> 6;
+        for (quint64 word = 0; word < qMin(moved, quint64(WORDS)); word++)
+        {
+            m_words[int(((m_base >> 6) + word) % WORDS)] = 0;
+        }
+        m_base = base;
+    }
+
+    quint64 &word = m_words[int((id >> 6) % WORDS)];
+    quint64 bit = quint64(1) << (id & 63);
+    if (word & bit)
+    {
+        return false;
+    }
+    word |= bit;
+    return true;
+}
+
+TradeFeed::TradeFeed(DataUsage *usage, QObject *parent)
+    :   QObject(parent)
+    ,   m_usage(usage)
+    ,   m_manager(this)
+    ,   m_feeds(Symbols::count())
+    ,   m_enabled(false)
+{
+    qRegisterMetaType<Trade>();
+    qRegisterMetaType<QVector<Trade> >();
+    connect(&m_manager, SIGNAL(finished(QNetworkReply*)), this, SLOT(onResult(QNetworkReply*)));
+}
+
+TradeFeed::~TradeFeed()
+{
+}
+
+bool TradeFeed::isEnabled() const
+{
+    return m_enabled;
+}
+
+void TradeFeed::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool TradeFeed::isTracked(int pair) const
+{
+    Exchange::Id exchange = Symbols::info(pair).exchange;
+    return exchange == Exchange::Bitfinex || exchange == Exchange::Poloniex;
+}
+
+const Ring<Trade> &TradeFeed::recent(int pair) const
+{
+    return m_feeds.at(pair).recent;
+}
+
+void TradeFeed::fetch()
+{
+    for (int pair = 0; pair < m_feeds.size(); pair++)
+    {
+        if (!isTracked(pair) || m_feeds.at(pair).busy || m_usage->skips(pair))
+        {
+            continue;
+        }
+        QNetworkRequest request;
+        request.setUrl(url(pair));
+        request.setAttribute(QNetworkRequest::User, pair);
+        Trace::stamp(request);
+        m_manager.get(request);
+        m_feeds[pair].busy = true;
+    }
+}
+
+QUrl TradeFeed::url(int pair) const
+{
+    // the newest second seen is requested again, its trades are deduplicated
+    const PairInfo &info = Symbols::info(pair);
+    uint newest = m_feeds.at(pair).newest;
+    QString url;
+    if (info.exchange == Exchange::Bitfinex)
+    {
+        url = BITFINEX_TRADES.arg(info.market).arg(int(PageLimit));
+        if (newest > 0)
+        {
+            url.append("&timestamp=").append(QString::number(newest));
+        }
+    }
+    else
+    {
+        url = POLONIEX_TRADES.arg(info.market);
+        if (newest > 0)
+        {
+            url.append("&start=").append(QString::number(newest));
+        }
+    }
+    return QUrl(url);
+}
+
+void TradeFeed::onResult(QNetworkReply *reply)
+{
+    int pair = reply->request().attribute(QNetworkRequest::User).toInt();
+    Feed &feed = m_feeds[pair];
+    feed.busy = false;
+    Trace::finished(reply, "trades", "request");
+    m_usage->add(Symbols::info(pair).exchange, reply);
+
+    QVector<Trade> trades;
+    if (reply->error() == QNetworkReply::NoError)
+    {
+        TRACE_SCOPE("trades", "parse");
+        parse(reply->readAll(), pair, trades);
+    }
+    reply->deleteLater();
+
+    // replies are newest first, the ring and the signal go oldest first
+    QVector<Trade> added;
+    for (int i = trades.size() - 1; i >= 0; i--)
+    {
+        const Trade &trade = trades.at(i);
+        if (!feed.seen.insert(trade.id))
+        {
+            continue;
+        }
+        if (feed.recent.size() == RecentTrades)
+        {
+            feed.recent.removeFirst();
+        }
+        feed.recent.append(trade);
+        feed.newest = qMax(feed.newest, trade.time);
+        added.append(trade);
+    }
+    if (!added.isEmpty())
+    {
+        emit tradesAdded(pair, added);
+    }
+}
+
+void TradeFeed::parse(const QByteArray &data, int pair, QVector<Trade> &trades)
+{
+    // an array of flat objects; poloniex calls the fields tradeID, date and
+    // rate, bitfinex tid, timestamp and price
+    JsonScanner scanner(data.constData(), data.size());
+    JsonScanner::Token token;
+    Trade trade;
+    int scale = Symbols::info(pair).scale;
+    while ((token = scanner.next()) != JsonScanner::End)
+    {
+        if (token == JsonScanner::BeginObject && scanner.depth() == 2)
+        {
+            trade.id = 0;
+            trade.time = 0;
+            trade.price = Price();
+            trade.amount = 0.0;
+            trade.buy = false;
+        }
+        else if (token == JsonScanner::EndObject && scanner.depth() == 1)
+        {
+            if (trade.id > 0 && trade.time > 0 && trade.price.isValid() && trade.amount > 0.0)
+            {
+                trades.append(trade);
+            }
+        }
+        else if (token == JsonScanner::Key && scanner.depth() == 2)
+        {
+            if (scanner.equals("tradeID") || scanner.equals("tid"))
+            {
+                scanner.next();
+                trade.id = parseId(scanner.begin(), scanner.end());
+            }
+            else if (scanner.equals("date"))
+            {
+                scanner.next();
+                trade.time = parseDate(scanner.begin(), scanner.end());
+            }
+            else if (scanner.equals("timestamp"))
+            {
+                scanner.next();
+                trade.time = uint(parseId(scanner.begin(), scanner.end()));
+            }
+            else if (scanner.equals("rate") || scanner.equals("price"))
+            {
+                scanner.next();
+                trade.price = Price::parse(scanner.begin(), scanner.end(), scale);
+            }
+            else if (scanner.equals("amount"))
+            {
+                scanner.next();
+                trade.amount = Price::parse(scanner.begin(), scanner.end()).toDouble();
+            }
+            else if (scanner.equals("type"))
+            {
+                scanner.next();
+                trade.buy = scanner.equals("buy");
+            }
+        }
+    }
+}
+
+void SeenWindow::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Prices, m_words);
+}
+
+void TradeFeed::measure(MemoryReport &report) const
+{
+    report.add(MemoryReport::Network, m_manager);
+    report.add(MemoryReport::Prices, m_feeds);
+    for (int pair = 0; pair < m_feeds.size(); pair++)
+    {
+        report.add(MemoryReport::Prices, m_feeds.at(pair).recent);
+        m_feeds.at(pair).seen.measure(report);
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRADES_H
+#define TRADES_H
+
+#include <QObject>
+#include <QMetaType>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QUrl>
+#include <QVector>
+
+#include "datausage.h"
+#include "price.h"
+#include "ring.h"
+#include "symbols.h"
+
+class MemoryReport;
+
+struct Trade
+{
+    quint64 id;
+    uint time;
+    Price price;
+    double amount;
+    bool buy;
+};
+
+Q_DECLARE_METATYPE(Trade)
+Q_DECLARE_METATYPE(QVector<Trade>)
+
+/*
+ * Trade ids seen recently, as a bitmap over a window of Bits ids that slides
+ * forward with the newest id. Ids that fell behind the window count as seen:
+ * they are older than anything a refresh can still return as new.
+ */
+class SeenWindow
+{
+public:
+    enum {
+        Bits = 1024
+    };
+
+    SeenWindow();
+
+    bool insert(quint64 id);
+    void measure(MemoryReport &report) const;
+
+private:
+    QVector<quint64> m_words;
+    quint64 m_base;
+    bool m_empty;
+};
+
+/*
+ * Recent executed trades of the Bitfinex and Poloniex pairs. Every refresh
+ * asks only for trades since the newest one seen, the overlap at that second
+ * is dropped by id, so the traffic follows the trading activity. New trades
+ * go into a ring per pair and out through tradesAdded(), oldest first.
+ *
+ * Both endpoints return the newest PageLimit trades of the range, a burst
+ * larger than that between two refreshes leaves a gap.
+ */
+class TradeFeed : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum {
+        RecentTrades = 256,
+        PageLimit = 200
+    };
+
+    explicit TradeFeed(DataUsage *usage, QObject *parent = 0);
+    ~TradeFeed();
+
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    bool isTracked(int pair) const;
+    const Ring<Trade> &recent(int pair) const;
+    void measure(MemoryReport &report) const;
+
+public slots:
+    void fetch();
+
+signals:
+    void tradesAdded(int pair, const QVector<Trade> &trades);
+
+private slots:
+    void onResult(QNetworkReply *reply);
+
+private:
+    struct Feed
+    {
+        Feed()
+            :   recent(RecentTrades)
+            ,   newest(0)
+            ,   busy(false)
+        {
+        }
+
+        Ring<Trade> recent;
+        SeenWindow seen;
+        uint newest;
+        bool busy;
+    };
+
+    QUrl url(int pair) const;
+    static void parse(const QByteArray &data, int pair, QVector<Trade> &trades);
+
+    DataUsage *m_usage;
+    QNetworkAccessManager m_manager;
+    QVector<Feed> m_feeds;
+    bool m_enabled;
+};
+
+#endif // TRADES_H
@@ -0,0 +1,20 @@
+# D-Bus service and client of the ticker core, lets the app, the cover and
+# other processes share one polling engine.
+
+QT += dbus
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+HEADERS += \
+    $$PWD/tickerbus.h \
+    $$PWD/tickerservice.h \
+    $$PWD/tickerclient.h
+
+SOURCES += \
+    $$PWD/tickerbus.cpp \
+    $$PWD/tickerservice.cpp \
+    $$PWD/tickerclient.cpp
+
+OTHER_FILES += \
+    $$PWD/org.drkjolla.Ticker.service
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDBusMetaType>
+
+#include "tickerbus.h"
+
+QuoteUpdate QuoteUpdate::fromTable(const PriceTable &prices, int pair)
+{
+    const Quote &quote = prices.quote(pair);
+    QuoteUpdate update;
+    update.pair = QString::fromLatin1(Symbols::info(pair).name);
+    update.mantissa = quote.value.mantissa();
+    update.scale = quote.value.scale();
+    update.updated = quote.updated;
+    update.errors = quote.errors;
+    update.present = 0;
+    for (int field = PriceTable::Ask; field < PriceTable::FieldCount; field++)
+    {
+        if (prices.has(pair, PriceTable::Field(field)))
+        {
+            update.present |= (1 << field);
+        }
+        update.fields.append(prices.field(pair, PriceTable::Field(field)).mantissa());
+    }
+    return update;
+}
+
+void QuoteUpdate::applyFields(PriceTable &prices, int pair) const
+{
+    for (int field = PriceTable::Ask; field < PriceTable::FieldCount; field++)
+    {
+        int index = field - PriceTable::Ask;
+        if ((present & (1 << field)) && index < fields.size())
+        {
+            PriceTable::Field f = PriceTable::Field(field);
+            prices.setField(pair, f, Price(fields.at(index), PriceTable::scale(pair, f)));
+        }
+    }
+}
+
+bool QuoteUpdate::sameRate(const QuoteUpdate &other) const
+{
+    // everything but the time, a repeated rate is no change
+    return mantissa == other.mantissa && scale == other.scale && errors == other.errors
+        && present == other.present && fields == other.fields;
+}
+
+void QuoteUpdate::registerType()
+{
+    qDBusRegisterMetaType<QuoteUpdate>();
+    qDBusRegisterMetaType<QuoteUpdateList>();
+}
+
+QDBusArgument &operator<<(QDBusArgument &argument, const QuoteUpdate &update)
+{
+    argument.beginStructure();
+    argument << update.pair << update.mantissa << update.scale << update.updated << update.errors;
+    argument << update.present << update.fields;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument &operator>>(const QDBusArgument &argument, QuoteUpdate &update)
+{
+    argument.beginStructure();
+    argument >> update.pair >> update.mantissa >> update.scale >> update.updated >> update.errors;
+    argument >> update.present >> update.fields;
+    argument.endStructure();
+    return argument;
+}
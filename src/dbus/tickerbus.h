@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICKERBUS_H
+#define TICKERBUS_H
+
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <QDBusArgument>
+
+#include "pricetable.h"
+
+namespace TickerBus {
+    static const char SERVICE[]   = "org.drkjolla.Ticker";
+    static const char PATH[]      = "/org/drkjolla/Ticker";
+    static const char INTERFACE[] = "org.drkjolla.Ticker";
+}
+
+/*
+ * Quote of a single pair as sent over the bus, D-Bus signature (sxiuiyax).
+ * Pairs travel by name, so clients of other builds keep working when the
+ * pair ids change. The trailing array holds the mantissas of the remaining
+ * ticker fields from PriceTable::Ask on, the byte before it says which of
+ * them are known.
+ */
+struct QuoteUpdate
+{
+    QString pair;
+    qlonglong mantissa;
+    int scale;
+    uint updated;
+    int errors;
+    uchar present;
+    QList<qlonglong> fields;
+
+    static QuoteUpdate fromTable(const PriceTable &prices, int pair);
+    void applyFields(PriceTable &prices, int pair) const;
+    bool sameRate(const QuoteUpdate &other) const;
+    static void registerType();
+};
+
+typedef QList<QuoteUpdate> QuoteUpdateList;
+
+Q_DECLARE_METATYPE(QuoteUpdate)
+Q_DECLARE_METATYPE(QuoteUpdateList)
+
+QDBusArgument &operator<<(QDBusArgument &argument, const QuoteUpdate &update);
+const QDBusArgument &operator>>(const QDBusArgument &argument, QuoteUpdate &update);
+
+#endif // TICKERBUS_H
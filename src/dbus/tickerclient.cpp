@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QMetaObject>
+
+#include "tickerclient.h"
+
+namespace {
+    static const int FLUSH_TIMEOUT = 5000;
+}
+
+TickerClient::TickerClient(TickerCore *core, QObject *parent)
+    :   QObject(parent)
+    ,   m_core(core)
+    ,   m_watcher(TickerBus::SERVICE, QDBusConnection::sessionBus(),
+                  QDBusServiceWatcher::WatchForRegistration | QDBusServiceWatcher::WatchForUnregistration)
+    ,   m_available(false)
+    ,   m_interval(-1)
+    ,   m_budget(-1)
+{
+    QuoteUpdate::registerType();
+    connect(this, SIGNAL(applied()), m_core, SIGNAL(fetched()));
+    connect(&m_watcher, SIGNAL(serviceRegistered(QString)), this, SLOT(onServiceRegistered(QString)));
+    connect(&m_watcher, SIGNAL(serviceUnregistered(QString)), this, SLOT(onServiceUnregistered(QString)));
+    QDBusConnection::sessionBus().connect(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "PriceChanged",
+                                          this, SLOT(onPriceChanged(QuoteUpdateList)));
+}
+
+TickerClient::~TickerClient()
+{
+}
+
+bool TickerClient::isAvailable()
+{
+    return m_available;
+}
+
+void TickerClient::start()
+{
+    QDBusConnectionInterface *bus = QDBusConnection::sessionBus().interface();
+    if (!bus)
+    {
+        return;
+    }
+    if (bus->isServiceRegistered(TickerBus::SERVICE))
+    {
+        setAvailable(true);
+        return;
+    }
+    // bus activation, the watcher reports the service once it is up
+    bus->call(QDBus::NoBlock, "StartServiceByName", QString(TickerBus::SERVICE), uint(0));
+}
+
+void TickerClient::refresh()
+{
+    if (!m_available)
+    {
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "Refresh");
+    QDBusConnection::sessionBus().send(message);
+}
+
+void TickerClient::setInterval(int minutes)
+{
+    m_interval = minutes;
+    if (!m_available)
+    {
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "SetInterval");
+    message << minutes;
+    QDBusConnection::sessionBus().send(message);
+}
+
+void TickerClient::setBudget(qint64 bytes)
+{
+    m_budget = bytes;
+    if (!m_available)
+    {
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "SetBudget");
+    message << qlonglong(bytes);
+    QDBusConnection::sessionBus().send(message);
+}
+
+void TickerClient::setLowPriority(const QStringList &pairs)
+{
+    m_lowPriority = pairs;
+    if (!m_available)
+    {
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "SetLowPriority");
+    message << pairs;
+    QDBusConnection::sessionBus().send(message);
+}
+
+void TickerClient::setHolding(const QString &asset, double amount)
+{
+    if (!m_available)
+    {
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "SetHolding");
+    message << asset << amount;
+    QDBusConnection::sessionBus().send(message);
+}
+
+void TickerClient::flush()
+{
+    // flushed() follows once the service wrote its buffered ticks, so a
+    // history read started then sees them; without the service right away
+    if (!m_available)
+    {
+        QMetaObject::invokeMethod(this, "flushed", Qt::QueuedConnection);
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "Flush");
+    QDBusPendingCallWatcher *call = new QDBusPendingCallWatcher(
+                QDBusConnection::sessionBus().asyncCall(message, FLUSH_TIMEOUT), this);
+    connect(call, SIGNAL(finished(QDBusPendingCallWatcher*)), this, SLOT(onFlushFinished(QDBusPendingCallWatcher*)));
+}
+
+void TickerClient::onServiceRegistered(const QString &service)
+{
+    Q_UNUSED(service);
+    setAvailable(true);
+}
+
+void TickerClient::onServiceUnregistered(const QString &service)
+{
+    Q_UNUSED(service);
+    setAvailable(false);
+}
+
+void TickerClient::onPriceChanged(const QuoteUpdateList &quotes)
+{
+    if (m_available)
+    {
+        apply(quotes);
+    }
+}
+
+void TickerClient::onQuotesFinished(QDBusPendingCallWatcher *call)
+{
+    QDBusPendingReply<QuoteUpdateList> reply = *call;
+    if (!reply.isError())
+    {
+        apply(reply.value());
+    }
+    call->deleteLater();
+}
+
+void TickerClient::onFlushFinished(QDBusPendingCallWatcher *call)
+{
+    // an error or a timeout still lets the reader go on with what is written
+    call->deleteLater();
+    emit flushed();
+}
+
+void TickerClient::setAvailable(bool available)
+{
+    if (available == m_available)
+    {
+        return;
+    }
+    m_available = available;
+    m_core->setMirror(available);
+    if (available)
+    {
+        if (m_interval >= 0)
+        {
+            setInterval(m_interval);
+        }
+        if (m_budget >= 0)
+        {
+            setBudget(m_budget);
+            setLowPriority(m_lowPriority);
+        }
+        sync();
+    }
+    emit availableChanged(available);
+}
+
+void TickerClient::sync()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(TickerBus::SERVICE, TickerBus::PATH, TickerBus::INTERFACE, "Quotes");
+    QDBusPendingCallWatcher *call = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(call, SIGNAL(finished(QDBusPendingCallWatcher*)), this, SLOT(onQuotesFinished(QDBusPendingCallWatcher*)));
+}
+
+void TickerClient::apply(const QuoteUpdateList &quotes)
+{
+    for (int i = 0; i < quotes.size(); i++)
+    {
+        const QuoteUpdate &update = quotes.at(i);
+        int pair = Symbols::find(update.pair);
+        if (pair == Pair::Invalid)
+        {
+            continue;
+        }
+
+        Quote &quote = m_core->prices()->quote(pair);
+        Price value(update.mantissa, update.scale);
+        bool fresh = value.isValid() && (value != quote.value || update.updated != quote.updated);
+        quote.value = value;
+        quote.updated = update.updated;
+        quote.errors = update.errors;
+        update.applyFields(*m_core->prices(), pair);
+        if (fresh)
+        {
+            m_core->ingest(pair);
+        }
+    }
+    emit applied();
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICKERCLIENT_H
+#define TICKERCLIENT_H
+
+#include <QObject>
+#include <QStringList>
+#include <QDBusServiceWatcher>
+
+#include "tickercore.h"
+#include "tickerbus.h"
+
+class QDBusPendingCallWatcher;
+
+/*
+ * Mirrors the quotes of the ticker service into a local core. While the
+ * service is on the bus the core is switched to mirror mode and never
+ * fetches itself; every PriceChanged signal is written into its price table
+ * and ingested, so statistics, alerts and the portfolio keep working. Each
+ * applied batch ends with the core's fetched(), as a local cycle would.
+ * Holdings are stored by the service, setHolding() hands them over.
+ */
+class TickerClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TickerClient(TickerCore *core, QObject *parent = 0);
+    ~TickerClient();
+
+    bool isAvailable();
+
+public slots:
+    void start();
+    void refresh();
+    void setInterval(int minutes);
+    void setBudget(qint64 bytes);
+    void setLowPriority(const QStringList &pairs);
+    void setHolding(const QString &asset, double amount);
+    void flush();
+
+signals:
+    void availableChanged(bool available);
+    void applied();
+    void flushed();
+
+private slots:
+    void onServiceRegistered(const QString &service);
+    void onServiceUnregistered(const QString &service);
+    void onPriceChanged(const QuoteUpdateList &quotes);
+    void onQuotesFinished(QDBusPendingCallWatcher *call);
+    void onFlushFinished(QDBusPendingCallWatcher *call);
+
+private:
+    void setAvailable(bool available);
+    void sync();
+    void apply(const QuoteUpdateList &quotes);
+
+    TickerCore *m_core;
+    QDBusServiceWatcher m_watcher;
+    bool m_available;
+    int m_interval;
+    qint64 m_budget;
+    QStringList m_lowPriority;
+};
+
+#endif // TICKERCLIENT_H
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDBusConnection>
+
+#include "tickerservice.h"
+
+TickerService::TickerService(TickerCore *core, QObject *parent)
+    :   QObject(parent)
+    ,   m_core(core)
+    ,   m_timer(this)
+    ,   m_interval(5)
+{
+    QuoteUpdate::registerType();
+    m_published = Quotes().toVector();
+    m_timer.setInterval(timerInterval());
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(poll()));
+    connect(m_core, SIGNAL(fetched()), this, SLOT(onFetched()));
+    connect(m_core->network(), SIGNAL(onlineChanged(bool)), this, SLOT(onOnlineChanged(bool)));
+    connect(m_core->usage(), SIGNAL(levelChanged(int)), this, SLOT(onLevelChanged()));
+    m_timer.start();
+}
+
+TickerService::~TickerService()
+{
+}
+
+bool TickerService::registerService()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    return bus.registerObject(TickerBus::PATH, this, QDBusConnection::ExportScriptableContents)
+        && bus.registerService(TickerBus::SERVICE);
+}
+
+QuoteUpdateList TickerService::Quotes()
+{
+    QuoteUpdateList quotes;
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        quotes.append(QuoteUpdate::fromTable(*m_core->prices(), pair));
+    }
+    return quotes;
+}
+
+void TickerService::Refresh()
+{
+    m_core->fetch();
+    if (m_interval > 0)
+    {
+        m_timer.start();
+    }
+}
+
+void TickerService::SetInterval(int minutes)
+{
+    // 0 pauses polling, e.g. while the app is in offline mode
+    m_interval = qBound(0, minutes, 99);
+    if (m_interval == 0)
+    {
+        m_timer.stop();
+        return;
+    }
+    m_timer.setInterval(timerInterval());
+    if (!m_timer.isActive())
+    {
+        m_timer.start();
+    }
+}
+
+int TickerService::Interval()
+{
+    return m_interval;
+}
+
+void TickerService::SetBudget(qlonglong bytes)
+{
+    // 0 turns the budget off
+    m_core->usage()->setBudget(bytes);
+}
+
+void TickerService::SetLowPriority(const QStringList &pairs)
+{
+    // the list replaces the previous one, unknown names are ignored
+    DataUsage *usage = m_core->usage();
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        usage->setLowPriority(pair, false);
+    }
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        usage->setLowPriority(Symbols::find(pairs.at(i)), true);
+    }
+}
+
+void TickerService::SetHolding(const QString &asset, double amount)
+{
+    // unknown assets and negative amounts are ignored
+    m_core->portfolio()->setHolding(asset, amount);
+}
+
+void TickerService::Flush()
+{
+    m_core->ticks()->flush();
+}
+
+void TickerService::onFetched()
+{
+    QuoteUpdateList changed;
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        QuoteUpdate update = QuoteUpdate::fromTable(*m_core->prices(), pair);
+        QuoteUpdate &published = m_published[pair];
+        if (!update.sameRate(published))
+        {
+            changed.append(update);
+            published = update;
+        }
+    }
+    if (!changed.isEmpty())
+    {
+        emit PriceChanged(changed);
+    }
+}
+
+void TickerService::onOnlineChanged(bool online)
+{
+    // no point in waking up without connectivity, catch up on reconnect
+    if (online && m_interval > 0)
+    {
+        poll();
+        m_timer.start();
+    }
+    else
+    {
+        m_timer.stop();
+    }
+}
+
+void TickerService::onLevelChanged()
+{
+    // a running timer restarts with the new interval
+    if (m_interval > 0)
+    {
+        m_timer.setInterval(timerInterval());
+    }
+}
+
+void TickerService::poll()
+{
+    if (m_core->network()->isOnline())
+    {
+        m_core->fetch();
+    }
+}
+
+int TickerService::timerInterval() const
+{
+    return m_interval * 60000 * m_core->usage()->intervalFactor();
+}
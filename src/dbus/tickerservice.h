@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICKERSERVICE_H
+#define TICKERSERVICE_H
+
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include "tickercore.h"
+#include "tickerbus.h"
+
+/*
+ * Publishes a ticker core on the session bus as org.drkjolla.Ticker and
+ * keeps polling on its own while no UI is running. After every refresh
+ * cycle PriceChanged carries only the quotes whose rate, fields or errors
+ * differ from the last published state; Quotes() returns all of them for a
+ * warm start.
+ *
+ * The service does the polling, so it also counts the data usage. Close to
+ * the monthly budget the poll interval is stretched and the pairs set by
+ * SetLowPriority() are left out.
+ *
+ * The service writes the history, so holdings entered in the app reach the
+ * portfolio through SetHolding().
+ */
+class TickerService : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.drkjolla.Ticker")
+
+public:
+    explicit TickerService(TickerCore *core, QObject *parent = 0);
+    ~TickerService();
+
+    bool registerService();
+
+public slots:
+    Q_SCRIPTABLE QuoteUpdateList Quotes();
+    Q_SCRIPTABLE void Refresh();
+    Q_SCRIPTABLE void SetInterval(int minutes);
+    Q_SCRIPTABLE int Interval();
+    Q_SCRIPTABLE void SetBudget(qlonglong bytes);
+    Q_SCRIPTABLE void SetLowPriority(const QStringList &pairs);
+    Q_SCRIPTABLE void SetHolding(const QString &asset, double amount);
+    Q_SCRIPTABLE void Flush();
+
+signals:
+    Q_SCRIPTABLE void PriceChanged(const QuoteUpdateList &quotes);
+
+private slots:
+    void onFetched();
+    void onOnlineChanged(bool online);
+    void onLevelChanged();
+    void poll();
+
+private:
+    int timerInterval() const;
+
+    TickerCore *m_core;
+    QVector<QuoteUpdate> m_published;
+    QTimer m_timer;
+    int m_interval;
+};
+
+#endif // TICKERSERVICE_H
@@ -19,10 +19,52 @@
 
 #include "sailfishapp.h"
 #include "tickerhandler.h"
+#include "pricechart.h"
+#include "tickerservice.h"
+#include "trace.h"
+#include "shutdown.h"
+
+namespace {
+    // headless engine started through d-bus activation, keeps polling
+    // while the ui is closed
+    int runDaemon(int argc, char *argv[])
+    {
+        QCoreApplication app(argc, argv);
+        app.setOrganizationName("harbour-drkjolla");
+        app.setApplicationName("harbour-drkjolla");
+        // the session ends us with SIGTERM, the history is flushed on the way out
+        Shutdown::install();
+
+        TickerCore core;
+        TickerService service(&core);
+        if (!service.registerService())
+        {
+            return 1;
+        }
+        service.Refresh();
+        return app.exec();
+    }
+}
 
 int main(int argc, char *argv[])
 {
+    // DRKJOLLA_TRACE=/path/trace.json records a timeline until exit
+    QByteArray trace = qgetenv("DRKJOLLA_TRACE");
+    if (!trace.isEmpty())
+    {
+        Trace::start(QString::fromLocal8Bit(trace));
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (qstrcmp(argv[i], "--daemon") == 0)
+        {
+            return runDaemon(argc, argv);
+        }
+    }
+
     qmlRegisterType<TickerHandler>("harbour.drkjolla.tickerHandler", 1, 7, "TickerHandler");
+    qmlRegisterType<PriceChart>("harbour.drkjolla.priceChart", 1, 7, "PriceChart");
 
     return SailfishApp::main(argc, argv);
 }
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QPainter>
+#include <QPolygonF>
+#include <QSet>
+
+#include "pricechart.h"
+#include "tickerhandler.h"
+#include "memoryreport.h"
+
+namespace {
+    // items live on the gui thread only
+    QSet<const PriceChart *> s_charts;
+}
+
+PriceChart::PriceChart(QQuickItem *parent)
+    :   QQuickPaintedItem(parent)
+    ,   m_pair(Pair::Invalid)
+    ,   m_span(86400)
+    ,   m_offset(0)
+    ,   m_color(Qt::white)
+    ,   m_dirty(false)
+    ,   m_from(0)
+    ,   m_to(0)
+    ,   m_minimum(0.0)
+    ,   m_maximum(0.0)
+{
+    setAntialiasing(true);
+    s_charts.insert(this);
+}
+
+PriceChart::~PriceChart()
+{
+    s_charts.remove(this);
+}
+
+QObject *PriceChart::ticker() const
+{
+    return m_ticker.data();
+}
+
+void PriceChart::setTicker(QObject *ticker)
+{
+    if (m_ticker)
+    {
+        disconnect(m_ticker->core(), 0, this, 0);
+    }
+    m_ticker = qobject_cast<TickerHandler *>(ticker);
+    if (m_ticker)
+    {
+        connect(m_ticker->core(), SIGNAL(quoteUpdated(int)), this, SLOT(onQuoteUpdated(int)));
+    }
+    emit tickerChanged();
+    invalidate();
+}
+
+QString PriceChart::pair() const
+{
+    return m_pair == Pair::Invalid ? QString() : QString(Symbols::info(m_pair).name);
+}
+
+void PriceChart::setPair(const QString &pair)
+{
+    m_pair = Symbols::find(pair);
+    emit pairChanged();
+    invalidate();
+}
+
+int PriceChart::span() const
+{
+    return m_span;
+}
+
+void PriceChart::setSpan(int span)
+{
+    m_span = qBound(600, span, 5 * 365 * 86400);
+    emit spanChanged();
+    invalidate();
+}
+
+int PriceChart::offset() const
+{
+    return m_offset;
+}
+
+void PriceChart::setOffset(int offset)
+{
+    offset = qMax(0, offset);
+    if (offset == m_offset)
+    {
+        return;
+    }
+    m_offset = offset;
+    emit offsetChanged();
+    invalidate();
+}
+
+QColor PriceChart::color() const
+{
+    return m_color;
+}
+
+void PriceChart::setColor(const QColor &color)
+{
+    m_color = color;
+    emit colorChanged();
+    update();
+}
+
+QString PriceChart::minimum() const
+{
+    return m_series.isEmpty() ? QString("---") : Price::fromDouble(m_minimum, Symbols::info(m_pair).scale).toString(Symbols::info(m_pair).precision);
+}
+
+QString PriceChart::maximum() const
+{
+    return m_series.isEmpty() ? QString("---") : Price::fromDouble(m_maximum, Symbols::info(m_pair).scale).toString(Symbols::info(m_pair).precision);
+}
+
+int PriceChart::points() const
+{
+    return m_series.size();
+}
+
+void PriceChart::paint(QPainter *painter)
+{
+    if (m_series.size() < 2)
+    {
+        return;
+    }
+
+    uint from = m_from;
+    uint to = m_to;
+    double range = qMax(m_maximum - m_minimum, m_maximum * 1e-6);
+    double xScale = width() / double(to - from);
+    double yScale = (height() - 2.0) / range;
+
+    QPolygonF line;
+    line.reserve(m_series.size());
+    for (int i = 0; i < m_series.size(); i++)
+    {
+        const ChartPoint &point = m_series.at(i);
+        line.append(QPointF((point.time - from) * xScale,
+                            height() - 1.0 - (point.value - m_minimum) * yScale));
+    }
+
+    QPen pen(m_color);
+    pen.setWidthF(2.0);
+    painter->setPen(pen);
+    painter->drawPolyline(line);
+}
+
+void PriceChart::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickPaintedItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.width() != oldGeometry.width())
+    {
+        invalidate();
+    }
+}
+
+void PriceChart::onQuoteUpdated(int pair)
+{
+    // a panned view stays where it is
+    if (pair == m_pair && m_offset == 0)
+    {
+        invalidate();
+    }
+}
+
+void PriceChart::invalidate()
+{
+    // property changes in a row only load the series once
+    if (!m_dirty)
+    {
+        m_dirty = true;
+        QMetaObject::invokeMethod(this, "load", Qt::QueuedConnection);
+    }
+}
+
+void PriceChart::load()
+{
+    m_dirty = false;
+    m_series.clear();
+    m_to = QDateTime::currentDateTime().toTime_t() - m_offset;
+    m_from = m_to - m_span;
+    if (m_ticker && m_pair != Pair::Invalid && width() > 0)
+    {
+        m_series = m_ticker->core()->charts()->series(m_pair, m_from, m_to, int(width()));
+    }
+
+    m_minimum = 0.0;
+    m_maximum = 0.0;
+    for (int i = 0; i < m_series.size(); i++)
+    {
+        double value = m_series.at(i).value;
+        if (i == 0 || value < m_minimum)
+        {
+            m_minimum = value;
+        }
+        if (i == 0 || value > m_maximum)
+        {
+            m_maximum = value;
+        }
+    }
+    emit seriesChanged();
+    update();
+}
+
+void PriceChart::measure(MemoryReport &report)
+{
+    QSet<const PriceChart *>::const_iterator it;
+    for (it = s_charts.constBegin(); it != s_charts.constEnd(); ++it)
+    {
+        report.add(MemoryReport::Ui, sizeof(PriceChart));
+        report.add(MemoryReport::Ui, (*it)->m_series);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRICECHART_H
+#define PRICECHART_H
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickPaintedItem>
+#include <QVector>
+
+#include "chartcache.h"
+
+class TickerHandler;
+class MemoryReport;
+
+/*
+ * Line chart of one pair, drawn from the downsampled series of the chart
+ * cache. The view covers span seconds ending offset seconds before now; an
+ * offset of 0 follows new quotes live.
+ */
+class PriceChart : public QQuickPaintedItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject *ticker READ ticker WRITE setTicker NOTIFY tickerChanged)
+    Q_PROPERTY(QString pair READ pair WRITE setPair NOTIFY pairChanged)
+    Q_PROPERTY(int span READ span WRITE setSpan NOTIFY spanChanged)
+    Q_PROPERTY(int offset READ offset WRITE setOffset NOTIFY offsetChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QString minimum READ minimum NOTIFY seriesChanged)
+    Q_PROPERTY(QString maximum READ maximum NOTIFY seriesChanged)
+    Q_PROPERTY(int points READ points NOTIFY seriesChanged)
+
+public:
+    explicit PriceChart(QQuickItem *parent = 0);
+    ~PriceChart();
+
+    QObject *ticker() const;
+    void setTicker(QObject *ticker);
+    QString pair() const;
+    void setPair(const QString &pair);
+    int span() const;
+    void setSpan(int span);
+    int offset() const;
+    void setOffset(int offset);
+    QColor color() const;
+    void setColor(const QColor &color);
+
+    QString minimum() const;
+    QString maximum() const;
+    int points() const;
+
+    void paint(QPainter *painter);
+
+    // series of every chart item alive
+    static void measure(MemoryReport &report);
+
+signals:
+    void tickerChanged();
+    void pairChanged();
+    void spanChanged();
+    void offsetChanged();
+    void colorChanged();
+    void seriesChanged();
+
+protected:
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+
+private slots:
+    void onQuoteUpdated(int pair);
+    void load();
+
+private:
+    void invalidate();
+
+    QPointer<TickerHandler> m_ticker;
+    int m_pair;
+    int m_span;
+    int m_offset;
+    QColor m_color;
+
+    bool m_dirty;
+    uint m_from;
+    uint m_to;
+    QVector<ChartPoint> m_series;
+    double m_minimum;
+    double m_maximum;
+};
+
+#endif // PRICECHART_H
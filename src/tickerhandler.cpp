@@ -16,34 +16,76 @@
  */
 
 #include <QDateTime>
+#include <QDir>
+#include <QGuiApplication>
+#include <QQuickWindow>
 #include <QStandardPaths>
+#include <QTimer>
 #include "tickerhandler.h"
+#include "trace.h"
+#include "memoryreport.h"
+#include "pricechart.h"
 
 namespace {
     static const int     VERSION_MAJOR   = 1;
     static const int     VERSION_MINOR   = 7;
     static const QString VERSION_STRING  = "1";
     static const QString RELEASE_DATE    = "03/December/2014";
+    static const int     SERVICE_TIMEOUT = 2000;
 }
 
 TickerHandler::TickerHandler(QObject *parent)
   :   QObject(parent)
+  ,   m_updateInterval(5)
+  ,   m_cellularInterval(0)
+  ,   m_apiPort(0)
+  ,   m_dataBudget(0)
   ,   m_updated(1)
-  ,   m_bitfinex(this)
-  ,   m_cryptsy(this)
-  ,   m_poloniex(this)
+  ,   m_offlineMode(false)
+  ,   m_btcEnabled(false)
+  ,   m_drkEnabled(true)
+  ,   m_ancEnabled(true)
+  ,   m_btcdEnabled(true)
+  ,   m_cloakEnabled(false)
+  ,   m_xmrEnabled(true)
+  ,   m_xcEnabled(true)
+  ,   m_framesTraced(false)
+  ,   m_exportDays(30)
+  ,   m_exportJson(false)
+  ,   m_core(this)
+  ,   m_client(&m_core, this)
+  ,   m_api(&m_core, this)
+  ,   m_export(m_core.ticks(), this)
   ,   m_settings(QString(QStandardPaths::ConfigLocation), QSettings::NativeFormat, this)
 {
     setDefaults();
+    loadAlerts();
 
+    connect(m_core.alerts(), SIGNAL(triggered(int,int,Price)), this, SLOT(onAlertTriggered(int,int,Price)));
+    connect(m_core.network(), SIGNAL(onlineChanged(bool)), this, SLOT(onOnlineChanged(bool)));
+    connect(m_core.network(), SIGNAL(meteredChanged(bool)), this, SLOT(syncService()));
+    connect(&m_client, SIGNAL(availableChanged(bool)), this, SLOT(onServiceChanged(bool)));
+    connect(&m_export, SIGNAL(done(bool,qint64,QString)), this, SLOT(onExportDone(bool,qint64,QString)));
+    connect(&m_client, SIGNAL(flushed()), this, SLOT(onFlushed()));
+
+    // prefer the shared background service, fetch locally only if it does
+    // not show up in time
+    m_client.start();
     if (!isOfflineMode())
-        update();
+    {
+        QTimer::singleShot(m_client.isAvailable() ? 0 : SERVICE_TIMEOUT, this, SLOT(update()));
+    }
 }
 
 TickerHandler::~TickerHandler()
 {
 }
 
+TickerCore *TickerHandler::core()
+{
+    return &m_core;
+}
+
 void TickerHandler::setDefaults()
 {
     if (m_settings.allKeys().contains("update/interval", Qt::CaseInsensitive))
@@ -57,6 +99,17 @@ void TickerHandler::setDefaults()
         setUpdateInterval();
     }
 
+    if (m_settings.allKeys().contains("update/cellular", Qt::CaseInsensitive))
+    {
+        m_settings.beginGroup("update");
+        setCellularInterval(m_settings.value("cellular", 0).toInt());
+        m_settings.endGroup();
+    }
+    else
+    {
+        setCellularInterval();
+    }
+
     if (m_settings.allKeys().contains("update/offline", Qt::CaseInsensitive))
     {
         m_settings.beginGroup("update");
@@ -68,6 +121,28 @@ void TickerHandler::setDefaults()
         setOfflineMode();
     }
 
+    if (m_settings.allKeys().contains("update/budget", Qt::CaseInsensitive))
+    {
+        m_settings.beginGroup("update");
+        setDataBudget(m_settings.value("budget", 0).toInt());
+        m_settings.endGroup();
+    }
+    else
+    {
+        setDataBudget();
+    }
+
+    if (m_settings.allKeys().contains("api/port", Qt::CaseInsensitive))
+    {
+        m_settings.beginGroup("api");
+        setApiPort(m_settings.value("port", 0).toInt());
+        m_settings.endGroup();
+    }
+    else
+    {
+        setApiPort();
+    }
+
     if (m_settings.allKeys().contains("coins/btc", Qt::CaseInsensitive))
     {
         m_settings.beginGroup("coins");
@@ -148,13 +223,23 @@ void TickerHandler::setDefaults()
 
 void TickerHandler::update(bool forced)
 {
-    if (!isOfflineMode() || forced)
+    // the service polls on its own, only manual refreshes are forwarded
+    if (m_client.isAvailable())
     {
-        if (m_updated <= (QDateTime().currentDateTime().toTime_t() - (m_updateInterval * 60)) || forced)
+        if (forced)
         {
-            m_bitfinex.fetch();
-            m_cryptsy.fetch();
-            m_poloniex.fetch();
+            m_client.refresh();
+        }
+        return;
+    }
+
+    if ((!isOfflineMode() && m_core.network()->isOnline()) || forced)
+    {
+        // near the data budget the interval is stretched
+        int interval = effectiveInterval() * m_core.usage()->intervalFactor();
+        if (m_updated <= (QDateTime().currentDateTime().toTime_t() - (interval * 60)) || forced)
+        {
+            m_core.fetch();
             m_updated = QDateTime().currentDateTime().toTime_t();
         }
     }
@@ -178,6 +263,29 @@ void TickerHandler::setUpdateInterval(int interval)
     m_settings.beginGroup("update");
     m_settings.endGroup();
     m_updateInterval = interval;
+    syncService();
+}
+
+void TickerHandler::setCellularInterval(int interval)
+{
+    // 0 disables the separate interval for metered connections
+    if (interval < 0)
+    {
+        interval = 0;
+    }
+    else if (interval > 99)
+    {
+        interval = 99;
+    }
+    m_settings.beginGroup("update");
+    m_settings.setValue("cellular", interval);
+    m_settings.endGroup();
+    m_settings.sync();
+    sync();
+    m_settings.beginGroup("update");
+    m_settings.endGroup();
+    m_cellularInterval = interval;
+    syncService();
 }
 
 void TickerHandler::setOfflineMode(bool enabled)
@@ -190,6 +298,49 @@ void TickerHandler::setOfflineMode(bool enabled)
     m_settings.beginGroup("update");
     m_settings.endGroup();
     m_offlineMode = enabled;
+    syncService();
+}
+
+void TickerHandler::setApiPort(int port)
+{
+    // 0 disables the local http api
+    if (port < 0 || port > 65535)
+    {
+        port = 0;
+    }
+    m_settings.beginGroup("api");
+    m_settings.setValue("port", port);
+    m_settings.endGroup();
+    m_settings.sync();
+    m_apiPort = port;
+
+    if (port == 0)
+    {
+        m_api.close();
+    }
+    else if (!m_api.isListening() || m_api.port() != port)
+    {
+        m_api.listen(port);
+    }
+}
+
+void TickerHandler::setDataBudget(int megabytes)
+{
+    // monthly mobile data budget, 0 disables it
+    if (megabytes < 0)
+    {
+        megabytes = 0;
+    }
+    else if (megabytes > 99999)
+    {
+        megabytes = 99999;
+    }
+    m_settings.beginGroup("update");
+    m_settings.setValue("budget", megabytes);
+    m_settings.endGroup();
+    m_settings.sync();
+    m_dataBudget = megabytes;
+    syncUsage();
 }
 
 void TickerHandler::setBtcEnabled(bool enabled)
@@ -202,6 +353,7 @@ void TickerHandler::setBtcEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_btcEnabled = enabled;
+    syncUsage();
 }
 
 void TickerHandler::setDrkEnabled(bool enabled)
@@ -214,6 +366,7 @@ void TickerHandler::setDrkEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_drkEnabled = enabled;
+    syncUsage();
 }
 
 void TickerHandler::setAncEnabled(bool enabled)
@@ -226,6 +379,7 @@ void TickerHandler::setAncEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_ancEnabled = enabled;
+    syncUsage();
 }
 
 void TickerHandler::setBtcdEnabled(bool enabled)
@@ -238,6 +392,7 @@ void TickerHandler::setBtcdEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_btcdEnabled = enabled;
+    syncUsage();
 }
 
 void TickerHandler::setCloakEnabled(bool enabled)
@@ -250,6 +405,7 @@ void TickerHandler::setCloakEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_cloakEnabled = enabled;
+    syncUsage();
 }
 
 void TickerHandler::setXmrEnabled(bool enabled)
@@ -262,6 +418,7 @@ void TickerHandler::setXmrEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_xmrEnabled = enabled;
+    syncUsage();
 }
 
 void TickerHandler::setXcEnabled(bool enabled)
@@ -274,6 +431,7 @@ void TickerHandler::setXcEnabled(bool enabled)
     m_settings.beginGroup("coins");
     m_settings.endGroup();
     m_xcEnabled = enabled;
+    syncUsage();
 }
 
 int TickerHandler::updateInterval()
@@ -281,11 +439,69 @@ int TickerHandler::updateInterval()
     return m_updateInterval;
 }
 
+int TickerHandler::cellularInterval()
+{
+    return m_cellularInterval;
+}
+
+int TickerHandler::apiPort()
+{
+    return m_apiPort;
+}
+
+int TickerHandler::dataBudget()
+{
+    return m_dataBudget;
+}
+
+QStringList TickerHandler::dataUsage()
+{
+    // the service counts while it polls, its totals are on disk
+    DataUsage *usage = m_core.usage();
+    if (!m_core.isWriter())
+    {
+        usage->reload();
+    }
+
+    QStringList lines;
+    for (int exchange = 0; exchange < Symbols::exchangeCount(); exchange++)
+    {
+        if (usage->bytes(exchange) == 0)
+        {
+            continue;
+        }
+        lines.append(QString(Symbols::exchangeName(Exchange::Id(exchange))).append(": ")
+                     .append(QString::number(usage->bytes(exchange) / 1048576.0, 'f', 2)).append(" MB, ")
+                     .append(QString::number(usage->meteredBytes(exchange) / 1048576.0, 'f', 2)).append(" MB mobile"));
+    }
+    QString total = QString("Total: ").append(QString::number(usage->meteredTotal() / 1048576.0, 'f', 2)).append(" MB mobile");
+    if (usage->budget() > 0)
+    {
+        total = total.append(" of ").append(QString::number(m_dataBudget)).append(" MB");
+    }
+    if (usage->level() != DataUsage::Normal)
+    {
+        total = total.append(", refreshing ").append(QString::number(usage->intervalFactor())).append("x less often");
+    }
+    lines.append(total);
+    return lines;
+}
+
+bool TickerHandler::isApiListening()
+{
+    return m_api.isListening();
+}
+
 bool TickerHandler::isOfflineMode()
 {
     return m_offlineMode;
 }
 
+bool TickerHandler::isNetworkOnline()
+{
+    return m_core.network()->isOnline();
+}
+
 bool TickerHandler::isBtcEnabled()
 {
     return m_btcEnabled;
@@ -323,420 +539,721 @@ bool TickerHandler::isXcEnabled()
 
 QString TickerHandler::bitfinexBtcUsd()
 {
-    QString ticker("BTC disabled.");
-    if (isBtcEnabled()) {
-        if (m_bitfinex.getBtcUsd() > 0.0f)
-        {
-            ticker = QString("USD ").append(QString::number(m_bitfinex.getBtcUsd(), 'f', 2));
-        }
-        else
-        {
-            ticker = QString("USD ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isBtcEnabled(), Pair::BitfinexBtcUsd);
 }
 
 QString TickerHandler::bitfinexDrkUsd()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_bitfinex.getDrkUsd() > 0.0f)
-        {
-            ticker = QString("USD ").append(QString::number(m_bitfinex.getDrkUsd(), 'f', 2));
-        }
-        else
-        {
-            ticker = QString("USD ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isDrkEnabled(), Pair::BitfinexDrkUsd);
 }
 
 QString TickerHandler::bitfinexDrkBtc()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_bitfinex.getDrkBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_bitfinex.getDrkBtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isDrkEnabled(), Pair::BitfinexDrkBtc);
 }
 
 QString TickerHandler::cryptsyBtcUsd()
 {
-    QString ticker("BTC disabled.");
-    if (isBtcEnabled()) {
-        if (m_cryptsy.getBtcUsd() > 0.0f)
-        {
-            ticker = QString("USD ").append(QString::number(m_cryptsy.getBtcUsd(), 'f', 2));
-        }
-        else
-        {
-            ticker = QString("USD ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isBtcEnabled(), Pair::CryptsyBtcUsd);
 }
 
 QString TickerHandler::cryptsyDrkUsd()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_cryptsy.getDrkUsd() > 0.0f)
-        {
-            ticker = QString("USD ").append(QString::number(m_cryptsy.getDrkUsd(), 'f', 2));
-        }
-        else
-        {
-            ticker = QString("USD ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isDrkEnabled(), Pair::CryptsyDrkUsd);
 }
 
 QString TickerHandler::cryptsyDrkBtc()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_cryptsy.getDrkBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_cryptsy.getDrkBtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isDrkEnabled(), Pair::CryptsyDrkBtc);
 }
 
 QString TickerHandler::cryptsyDrkLtc()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_cryptsy.getDrkLtc() > 0.0f)
-        {
-            ticker = QString("LTC ").append(QString::number(m_cryptsy.getDrkLtc(), 'f', 3));
-        }
-        else
-        {
-            ticker = QString("LTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isDrkEnabled(), Pair::CryptsyDrkLtc);
 }
 
 QString TickerHandler::cryptsyAncBtc()
 {
-    QString ticker("ANC disabled.");
-    if (isAncEnabled()) {
-        if (m_cryptsy.getAncBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_cryptsy.getAncBtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isAncEnabled(), Pair::CryptsyAncBtc);
 }
 
 QString TickerHandler::cryptsyAncLtc()
 {
-    QString ticker("ANC disabled.");
-    if (isAncEnabled()) {
-        if (m_cryptsy.getAncLtc() > 0.0f)
-        {
-            ticker = QString("LTC ").append(QString::number(m_cryptsy.getAncLtc(), 'f', 3));
-        }
-        else
-        {
-            ticker = QString("LTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isAncEnabled(), Pair::CryptsyAncLtc);
 }
 
 QString TickerHandler::cryptsyBtcdBtc()
 {
-    QString ticker("BTCD disabled.");
-    if (isBtcdEnabled()) {
-        if (m_cryptsy.getBtcdBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_cryptsy.getBtcdBtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isBtcdEnabled(), Pair::CryptsyBtcdBtc);
 }
 
 QString TickerHandler::cryptsyCloakBtc()
 {
-    QString ticker("CLOAK disabled.");
-    if (isCloakEnabled()) {
-        if (m_cryptsy.getCloakBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_cryptsy.getCloakBtc(), 'f', 7));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isCloakEnabled(), Pair::CryptsyCloakBtc);
 }
 
 QString TickerHandler::cryptsyCloakLtc()
 {
-    QString ticker("CLOAK disabled.");
-    if (isCloakEnabled()) {
-        if (m_cryptsy.getCloakLtc() > 0.0f)
-        {
-            ticker = QString("LTC ").append(QString::number(m_cryptsy.getCloakLtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("LTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isCloakEnabled(), Pair::CryptsyCloakLtc);
 }
 
 QString TickerHandler::cryptsyXcBtc()
 {
-    QString ticker("XC disabled.");
-    if (isXcEnabled()) {
-        if (m_cryptsy.getXcBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_cryptsy.getXcBtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isXcEnabled(), Pair::CryptsyXcBtc);
 }
 
 QString TickerHandler::cryptsyXcLtc()
 {
-    QString ticker("XC disabled.");
-    if (isXcEnabled()) {
-        if (m_cryptsy.getXcLtc() > 0.0f)
-        {
-            ticker = QString("LTC ").append(QString::number(m_cryptsy.getXcLtc(), 'f', 3));
-        }
-        else
-        {
-            ticker = QString("LTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isXcEnabled(), Pair::CryptsyXcLtc);
 }
 
 QString TickerHandler::poloniexBtcUsd()
 {
-    QString ticker("BTC disabled.");
-    if (isBtcEnabled()) {
-        if (m_poloniex.getBtcUsd() > 0.0f)
-        {
-            ticker = QString("USD ").append(QString::number(m_poloniex.getBtcUsd(), 'f', 2));
-        }
-        else
-        {
-            ticker = QString("USD ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isBtcEnabled(), Pair::PoloniexBtcUsd);
 }
 
 QString TickerHandler::poloniexXmrUsd()
 {
-    QString ticker("XMR disabled.");
-    if (isXmrEnabled()) {
-        if (m_poloniex.getXmrUsd() > 0.0f)
-        {
-            ticker = QString("USD ").append(QString::number(m_poloniex.getXmrUsd(), 'f', 2));
-        }
-        else
-        {
-            ticker = QString("USD ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isXmrEnabled(), Pair::PoloniexXmrUsd);
 }
 
 QString TickerHandler::poloniexDrkBtc()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_poloniex.getDrkBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_poloniex.getDrkBtc(), 'f', 5));
-        }
-        else
-        {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
-        }
-    }
-    return ticker;
+    return ticker(isDrkEnabled(), Pair::PoloniexDrkBtc);
 }
 
 QString TickerHandler::poloniexDrkXmr()
 {
-    QString ticker("DRK disabled.");
-    if (isDrkEnabled()) {
-        if (m_poloniex.getDrkXmr() > 0.0f)
+    return ticker(isDrkEnabled(), Pair::PoloniexDrkXmr);
+}
+
+QString TickerHandler::poloniexBtcdBtc()
+{
+    return ticker(isBtcdEnabled(), Pair::PoloniexBtcdBtc);
+}
+
+QString TickerHandler::poloniexBtcdXmr()
+{
+    return ticker(isBtcdEnabled(), Pair::PoloniexBtcdXmr);
+}
+
+QString TickerHandler::poloniexXcBtc()
+{
+    return ticker(isXcEnabled(), Pair::PoloniexXcBtc);
+}
+
+QString TickerHandler::poloniexXmrBtc()
+{
+    return ticker(isXmrEnabled(), Pair::PoloniexXmrBtc);
+}
+
+void TickerHandler::onOnlineChanged(bool online)
+{
+    // single catch-up cycle on reconnect, skipped if the data is still fresh
+    if (online)
+    {
+        update();
+    }
+}
+
+void TickerHandler::onServiceChanged(bool available)
+{
+    // without the service the local core takes over polling right away
+    if (!available)
+    {
+        m_updated = 1;
+        update();
+    }
+}
+
+void TickerHandler::onExportDone(bool ok, qint64 rows, const QString &error)
+{
+    if (ok)
+    {
+        emit exportFinished(QString("Exported %1 prices.").arg(rows));
+    }
+    else
+    {
+        emit exportFinished(QString("Export failed: %1").arg(error));
+    }
+}
+
+void TickerHandler::syncService()
+{
+    m_client.setInterval(isOfflineMode() ? 0 : effectiveInterval());
+}
+
+void TickerHandler::onAlertTriggered(int rule, int pair, const Price &price)
+{
+    QString message = describeAlert(m_core.alerts()->rule(rule));
+    emit alert(message.append(", now ").append(price.toString(Symbols::info(pair).precision)));
+}
+
+QString TickerHandler::describeAlert(const AlertEngine::Rule &rule)
+{
+    const PairInfo &info = Symbols::info(rule.pair);
+    QString message = QString(Symbols::exchangeName(info.exchange)).append(" ")
+            .append(info.base).append("/").append(info.quote).append(" ");
+
+    switch (rule.type)
+    {
+    case AlertEngine::Above:
+        message = message.append("rose above ").append(rule.threshold.toString(info.precision));
+        break;
+    case AlertEngine::Below:
+        message = message.append("fell below ").append(rule.threshold.toString(info.precision));
+        break;
+    case AlertEngine::PercentMove:
+        message = message.append("moved ").append(QString::number(rule.percent)).append("%");
+        break;
+    case AlertEngine::Spread:
+        message = message.append("spread to ").append(Symbols::exchangeName(Symbols::info(rule.other).exchange))
+                .append(" exceeds ").append(QString::number(rule.percent)).append("%");
+        break;
+    }
+    return message;
+}
+
+int TickerHandler::effectiveInterval()
+{
+    if (m_core.network()->isMetered() && m_cellularInterval > m_updateInterval)
+    {
+        return m_cellularInterval;
+    }
+    return m_updateInterval;
+}
+
+void TickerHandler::syncUsage()
+{
+    // pairs of disabled coins are not shown, near the budget they are
+    // left out; configured pairs are always kept
+    DataUsage *usage = m_core.usage();
+    QStringList low;
+    for (int pair = 0; pair < Pair::Count; pair++)
+    {
+        const PairInfo &info = Symbols::info(pair);
+        bool lowPriority = !isCoinEnabled(info.base);
+        usage->setLowPriority(pair, lowPriority);
+        if (lowPriority)
         {
-            ticker = QString("XMR ").append(QString::number(m_poloniex.getDrkXmr(), 'f', 3));
+            low.append(QString::fromLatin1(info.name));
         }
-        else
+    }
+    usage->setBudget(qint64(m_dataBudget) * 1048576);
+    m_client.setBudget(usage->budget());
+    m_client.setLowPriority(low);
+}
+
+bool TickerHandler::isCoinEnabled(const char *coin)
+{
+    QByteArray name(coin);
+    if (name == "BTC")
+    {
+        return m_btcEnabled;
+    }
+    if (name == "DRK")
+    {
+        return m_drkEnabled;
+    }
+    if (name == "ANC")
+    {
+        return m_ancEnabled;
+    }
+    if (name == "BTCD")
+    {
+        return m_btcdEnabled;
+    }
+    if (name == "CLOAK")
+    {
+        return m_cloakEnabled;
+    }
+    if (name == "XMR")
+    {
+        return m_xmrEnabled;
+    }
+    if (name == "XC")
+    {
+        return m_xcEnabled;
+    }
+    return true;
+}
+
+QString TickerHandler::ticker(bool enabled, int pair)
+{
+    const PairInfo &info = Symbols::info(pair);
+    if (!enabled)
+    {
+        return QString(info.base).append(" disabled.");
+    }
+
+    const Quote &quote = m_core.prices()->quote(pair);
+    QString text = QString(info.quote).append(" ");
+    if (quote.isValid())
+    {
+        text = text.append(quote.value.toString(info.precision));
+    }
+    else
+    {
+        return text.append("---");
+    }
+
+    // show the age of the last good value instead of blanking it
+    if (isOfflineMode() || !m_core.network()->isOnline())
+    {
+        text = text.append(" (cached, ").append(age(quote)).append(")");
+    }
+    else if (quote.errors > 0)
+    {
+        text = text.append(" (").append(age(quote)).append(")");
+    }
+    return text;
+}
+
+QString TickerHandler::age(const Quote &quote)
+{
+    uint now = QDateTime().currentDateTime().toTime_t();
+    uint seconds = now > quote.updated ? now - quote.updated : 0;
+    if (seconds < 60)
+    {
+        return QString("just now");
+    }
+    else if (seconds < 3600)
+    {
+        return QString::number(seconds / 60).append(" min ago");
+    }
+    else if (seconds < 86400)
+    {
+        return QString::number(seconds / 3600).append(" h ago");
+    }
+    return QString::number(seconds / 86400).append(" d ago");
+}
+
+QStringList TickerHandler::configuredPairs()
+{
+    // pairs from the exchange config, shown generically by the ui
+    QStringList names;
+    for (int pair = Pair::Count; pair < Symbols::count(); pair++)
+    {
+        names.append(QString(Symbols::info(pair).name));
+    }
+    return names;
+}
+
+QString TickerHandler::price(const QString &name)
+{
+    int pair = Symbols::find(name);
+    if (pair == Pair::Invalid)
+    {
+        return QString();
+    }
+    const PairInfo &info = Symbols::info(pair);
+    return QString(Symbols::exchangeName(info.exchange)).append(" ").append(info.base).append(": ")
+        .append(ticker(true, pair));
+}
+
+QObject *TickerHandler::statistics(const QString &name)
+{
+    // e.g. statistics("bitfinexBtcUsd").change, owned by the ticker handler
+    return m_core.statistics()->pair(Symbols::find(name));
+}
+
+QVariantMap TickerHandler::quoteRecord(const QString &name)
+{
+    // e.g. quoteRecord("poloniexXmrBtc").spread, formatted strings keyed by
+    // field name, fields the exchange did not send are left out
+    QVariantMap record;
+    int pair = Symbols::find(name);
+    if (pair == Pair::Invalid)
+    {
+        return record;
+    }
+
+    const PriceTable *prices = m_core.prices();
+    int precision = Symbols::info(pair).precision;
+    for (int i = 0; i < PriceTable::FieldCount; i++)
+    {
+        PriceTable::Field field = PriceTable::Field(i);
+        if (prices->has(pair, field))
         {
-            ticker = QString("XMR ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
+            int digits = (field == PriceTable::Volume || field == PriceTable::Change) ? int(Price::DefaultScale) : precision;
+            record.insert(PriceTable::fieldName(field), prices->field(pair, field).toString(digits));
         }
     }
-    return ticker;
+    if (prices->has(pair, PriceTable::Bid) && prices->has(pair, PriceTable::Ask))
+    {
+        record.insert("mid", prices->mid(pair).toString(precision));
+        record.insert("spread", prices->spread(pair).toString(precision));
+    }
+    return record;
 }
 
-QString TickerHandler::poloniexBtcdBtc()
+QString TickerHandler::consensus(const QString &base, const QString &quote)
+{
+    // e.g. consensus("DRK", "BTC"): median across exchanges with best bid/ask
+    const Consensus *consensus = m_core.consensus();
+    int market = consensus->find(base, quote);
+    if (market < 0 || !consensus->book(market).isValid())
+    {
+        return QString(quote).append(" ---");
+    }
+
+    const Consensus::Book &book = consensus->book(market);
+    int precision = Symbols::info(book.bestBid).precision;
+    QString text = QString(quote).append(" ").append(book.median.toString(precision));
+    text.append(" (").append(book.bid.toString(precision));
+    if (book.bestAsk != Pair::Invalid)
+    {
+        text.append(" / ").append(book.ask.toString(precision));
+    }
+    text.append(")");
+    if (book.rejected > 0)
+    {
+        text.append(", ").append(QString::number(book.rejected)).append(" ignored");
+    }
+    return text;
+}
+
+QStringList TickerHandler::consensusMarkets()
 {
-    QString ticker("BTCD disabled.");
-    if (isBtcdEnabled()) {
-        if (m_poloniex.getBtcdBtc() > 0.0f)
+    QStringList markets;
+    const Consensus *consensus = m_core.consensus();
+    for (int market = 0; market < consensus->count(); market++)
+    {
+        markets.append(QString(consensus->base(market)).append("/").append(consensus->quote(market)));
+    }
+    return markets;
+}
+
+void TickerHandler::fetchBooks(const QString &market)
+{
+    int index = consensusMarkets().indexOf(market);
+    if (index < 0)
+    {
+        return;
+    }
+    QVector<int> pairs = m_core.consensus()->pairs(index);
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        m_core.fetchBook(pairs.at(i));
+    }
+}
+
+QString TickerHandler::fillEstimate(const QString &market, double amount, bool buy)
+{
+    // one line per venue with a book, then the best split across all of them
+    int index = consensusMarkets().indexOf(market);
+    if (index < 0 || !(amount > 0.0))
+    {
+        return QString();
+    }
+
+    const Consensus *consensus = m_core.consensus();
+    QVector<int> pairs = consensus->pairs(index);
+    QVector<const OrderBook *> books;
+    OrderBook::Side side = buy ? OrderBook::Asks : OrderBook::Bids;
+    int precision = Symbols::info(pairs.first()).precision;
+    QString text;
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        const OrderBook &book = m_core.books()->book(pairs.at(i));
+        books.append(&book);
+        if (book.isEmpty(side))
         {
-            ticker = QString("BTC ").append(QString::number(m_poloniex.getBtcdBtc(), 'f', 5));
+            continue;
+        }
+
+        OrderBook::Fill fill = book.fill(side, amount);
+        text.append(Symbols::exchangeName(Symbols::info(pairs.at(i)).exchange)).append(": ");
+        if (fill.complete)
+        {
+            text.append(QString::number(fill.average, 'f', precision))
+                .append(" (").append(QString::number(fill.slippage * 100.0, 'f', 2)).append("%)");
         }
         else
         {
-            ticker = QString("BTC ---");
+            text.append("only ").append(QString::number(fill.amount, 'f', 4)).append(" ").append(consensus->base(index));
         }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
+        text.append("\n");
+    }
+    if (text.isEmpty())
+    {
+        return QString("No order books yet.");
+    }
+
+    QVector<double> shares;
+    OrderBook::Fill fill = OrderBook::split(books, side, amount, &shares);
+    text.append("Split: ").append(QString::number(fill.average, 'f', precision))
+        .append(" (").append(QString::number(fill.slippage * 100.0, 'f', 2)).append("%)");
+    if (!fill.complete)
+    {
+        text.append(", only ").append(QString::number(fill.amount, 'f', 4)).append(" ").append(consensus->base(index));
+    }
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        if (shares.at(i) > 0.0)
+        {
+            text.append("\n  ").append(Symbols::exchangeName(Symbols::info(pairs.at(i)).exchange))
+                .append(" ").append(QString::number(shares.at(i), 'f', 4));
         }
     }
-    return ticker;
+    return text;
 }
 
-QString TickerHandler::poloniexBtcdXmr()
+QStringList TickerHandler::pairNames()
+{
+    QStringList names;
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        names.append(QString(Symbols::info(pair).name));
+    }
+    return names;
+}
+
+int TickerHandler::addAlert(const QString &name, const QString &type, double value, const QString &other)
+{
+    // type is one of "above", "below", "move" or "spread", value is a price
+    // for thresholds and a percentage otherwise
+    int pair = Symbols::find(name);
+    if (pair == Pair::Invalid)
+    {
+        return 0;
+    }
+
+    int id = 0;
+    if (type == "above" || type == "below")
+    {
+        id = m_core.alerts()->addThreshold(pair, type == "above", Price::fromDouble(value, Symbols::info(pair).scale));
+    }
+    else if (type == "move")
+    {
+        id = m_core.alerts()->addPercentMove(pair, value);
+    }
+    else if (type == "spread" && Symbols::find(other) != Pair::Invalid)
+    {
+        id = m_core.alerts()->addSpread(pair, Symbols::find(other), value);
+    }
+    if (id > 0)
+    {
+        saveAlerts();
+    }
+    return id;
+}
+
+void TickerHandler::removeAlert(int id)
+{
+    m_core.alerts()->remove(id);
+    saveAlerts();
+}
+
+void TickerHandler::clearAlerts()
+{
+    m_core.alerts()->clear();
+    saveAlerts();
+}
+
+int TickerHandler::alertCount()
+{
+    return m_core.alerts()->count();
+}
+
+QVariantList TickerHandler::alertRules()
+{
+    // id and text of every rule, in the order they were added
+    QList<AlertEngine::Rule> rules = m_core.alerts()->rules();
+    QMap<int, QVariant> sorted;
+    for (int i = 0; i < rules.size(); i++)
+    {
+        QVariantMap entry;
+        entry.insert("id", rules.at(i).id);
+        entry.insert("text", describeAlert(rules.at(i)));
+        sorted.insert(rules.at(i).id, entry);
+    }
+    return sorted.values();
+}
+
+QStringList TickerHandler::portfolioAssets()
+{
+    return m_core.portfolio()->assets();
+}
+
+void TickerHandler::setHolding(const QString &asset, double amount)
+{
+    // the writer of the history stores it, usually the service
+    m_core.portfolio()->setHolding(asset, amount);
+    if (!m_core.isWriter())
+    {
+        m_client.setHolding(asset, amount);
+    }
+}
+
+double TickerHandler::holding(const QString &asset)
+{
+    return m_core.portfolio()->holding(asset);
+}
+
+QString TickerHandler::portfolioBtc()
 {
-    QString ticker("BTCD disabled.");
-    if (isBtcdEnabled()) {
-        if (m_poloniex.getBtcdXmr() > 0.0f)
+    return QString("BTC ").append(Price::fromDouble(m_core.portfolio()->totalBtc()).toString(5));
+}
+
+QString TickerHandler::portfolioUsd()
+{
+    if (m_core.portfolio()->totalUsd() <= 0.0f)
+    {
+        return QString("USD ---");
+    }
+    return QString("USD ").append(Price::fromDouble(m_core.portfolio()->totalUsd(), 4).toString(2));
+}
+
+void TickerHandler::loadAlerts()
+{
+    int size = m_settings.beginReadArray("alerts");
+    for (int i = 0; i < size; i++)
+    {
+        m_settings.setArrayIndex(i);
+        int pair = Symbols::find(m_settings.value("pair").toString());
+        int other = Symbols::find(m_settings.value("other").toString());
+        int type = m_settings.value("type").toInt();
+        double value = m_settings.value("value").toDouble();
+        if (pair == Pair::Invalid)
         {
-            ticker = QString("XMR ").append(QString::number(m_poloniex.getBtcdXmr(), 'f', 3));
+            continue;
         }
-        else
+        switch (type)
         {
-            ticker = QString("XMR ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
+        case AlertEngine::Above:
+        case AlertEngine::Below:
+            m_core.alerts()->addThreshold(pair, type == AlertEngine::Above, Price::fromDouble(value, Symbols::info(pair).scale));
+            break;
+        case AlertEngine::PercentMove:
+            m_core.alerts()->addPercentMove(pair, value);
+            break;
+        case AlertEngine::Spread:
+            if (other != Pair::Invalid)
+            {
+                m_core.alerts()->addSpread(pair, other, value);
+            }
+            break;
         }
     }
-    return ticker;
+    m_settings.endArray();
 }
 
-QString TickerHandler::poloniexXcBtc()
+void TickerHandler::saveAlerts()
 {
-    QString ticker("XC disabled.");
-    if (isXcEnabled()) {
-        if (m_poloniex.getXcBtc() > 0.0f)
+    QList<AlertEngine::Rule> rules = m_core.alerts()->rules();
+    m_settings.beginWriteArray("alerts", rules.size());
+    for (int i = 0; i < rules.size(); i++)
+    {
+        const AlertEngine::Rule &rule = rules.at(i);
+        m_settings.setArrayIndex(i);
+        m_settings.setValue("pair", QString(Symbols::info(rule.pair).name));
+        m_settings.setValue("other", QString(Symbols::info(rule.other).name));
+        m_settings.setValue("type", int(rule.type));
+        if (rule.type == AlertEngine::Above || rule.type == AlertEngine::Below)
         {
-            ticker = QString("BTC ").append(QString::number(m_poloniex.getXcBtc(), 'f', 5));
+            m_settings.setValue("value", rule.threshold.toDouble());
         }
         else
         {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
+            m_settings.setValue("value", rule.percent);
         }
     }
-    return ticker;
+    m_settings.endArray();
+    m_settings.sync();
 }
 
-QString TickerHandler::poloniexXmrBtc()
+QString TickerHandler::exportHistory(int days, bool json)
 {
-    QString ticker("XMR disabled.");
-    if (isXmrEnabled()) {
-        if (m_poloniex.getXmrBtc() > 0.0f)
-        {
-            ticker = QString("BTC ").append(QString::number(m_poloniex.getXmrBtc(), 'f', 5));
-        }
-        else
+    if (m_export.isRunning() || !m_exportPath.isEmpty())
+    {
+        return QString();
+    }
+
+    QString path = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    QDir().mkpath(path);
+    path.append("/drkjolla-").append(QDateTime::currentDateTime().toString("yyyyMMdd-hhmm")).append(json ? ".json" : ".csv");
+    m_exportPath = path;
+    m_exportDays = qBound(1, days, 3650);
+    m_exportJson = json;
+
+    // the service may still buffer the newest ticks, the export starts once
+    // it wrote them; what this process buffers the export copies itself
+    m_client.flush();
+    return path;
+}
+
+void TickerHandler::onFlushed()
+{
+    if (m_exportPath.isEmpty())
+    {
+        return;
+    }
+
+    uint to = QDateTime::currentDateTime().toTime_t();
+    uint from = to - m_exportDays * 86400u;
+    QList<int> pairs;
+    for (int pair = 0; pair < Symbols::count(); pair++)
+    {
+        pairs.append(pair);
+    }
+
+    QString path = m_exportPath;
+    m_exportPath.clear();
+    if (!m_export.exportTo(path, pairs, from, to, m_exportJson ? HistoryExport::Json : HistoryExport::Csv))
+    {
+        emit exportFinished(QString("Export failed: an export is already running"));
+    }
+}
+
+QString TickerHandler::memoryReport()
+{
+    MemoryReport report;
+    m_core.measure(report);
+    m_api.measure(report);
+    PriceChart::measure(report);
+    return QString::fromLatin1(report.toText());
+}
+
+void TickerHandler::beginRefresh()
+{
+    if (!Trace::isEnabled())
+    {
+        return;
+    }
+
+    // frames are timed on the render thread, from the sync with the item
+    // tree to the buffer swap
+    if (!m_framesTraced)
+    {
+        QWindowList windows = QGuiApplication::topLevelWindows();
+        for (int i = 0; i < windows.size(); i++)
         {
-            ticker = QString("BTC ---");
-        }
-        if (isOfflineMode()) {
-            ticker = ticker.append(" (cached)");
+            QQuickWindow *window = qobject_cast<QQuickWindow *>(windows.at(i));
+            if (window)
+            {
+                connect(window, SIGNAL(beforeSynchronizing()), this, SLOT(onFrameStarted()), Qt::DirectConnection);
+                connect(window, SIGNAL(frameSwapped()), this, SLOT(onFrameSwapped()), Qt::DirectConnection);
+                m_framesTraced = true;
+            }
         }
     }
-    return ticker;
+    Trace::begin("ui", "refresh");
+}
+
+void TickerHandler::endRefresh()
+{
+    Trace::end("ui", "refresh");
+}
+
+void TickerHandler::onFrameStarted()
+{
+    Trace::begin("ui", "frame");
+}
+
+void TickerHandler::onFrameSwapped()
+{
+    Trace::end("ui", "frame");
 }
 
 QString TickerHandler::version(bool shrt)
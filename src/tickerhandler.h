@@ -17,10 +17,12 @@
 
 #include <QObject>
 #include <QSettings>
+#include <QVariantMap>
 
-#include "bitfinex.h"
-#include "cryptsy.h"
-#include "poloniex.h"
+#include "tickercore.h"
+#include "httpapi.h"
+#include "tickerclient.h"
+#include "historyexport.h"
 
 class TickerHandler : public QObject
 {
@@ -30,12 +32,17 @@ public:
     explicit TickerHandler(QObject *parent = 0);
     ~TickerHandler();
 
+    TickerCore *core();
+
 public slots:
     void setDefaults();
     void update(bool forced = false);
 
     void setUpdateInterval(int interval = 5);
+    void setCellularInterval(int interval = 0);
     void setOfflineMode(bool enabled = false);
+    void setApiPort(int port = 0);
+    void setDataBudget(int megabytes = 0);
     void setBtcEnabled(bool enabled = false);
     void setDrkEnabled(bool enabled = true);
     void setAncEnabled(bool enabled = true);
@@ -45,7 +52,13 @@ public slots:
     void setXcEnabled(bool enabled = true);
 
     int updateInterval();
+    int cellularInterval();
+    int apiPort();
+    int dataBudget();
+    QStringList dataUsage();
+    bool isApiListening();
     bool isOfflineMode();
+    bool isNetworkOnline();
     bool isBtcEnabled();
     bool isDrkEnabled();
     bool isAncEnabled();
@@ -77,11 +90,65 @@ public slots:
     QString poloniexXcBtc();
     QString poloniexXmrBtc();
 
+    QStringList configuredPairs();
+    QString price(const QString &name);
+    QObject *statistics(const QString &name);
+    QVariantMap quoteRecord(const QString &name);
+    QString consensus(const QString &base, const QString &quote);
+    QStringList consensusMarkets();
+    void fetchBooks(const QString &market);
+    QString fillEstimate(const QString &market, double amount, bool buy);
+    QStringList pairNames();
+
+    int addAlert(const QString &name, const QString &type, double value, const QString &other = QString());
+    void removeAlert(int id);
+    void clearAlerts();
+    int alertCount();
+    QVariantList alertRules();
+
+    QStringList portfolioAssets();
+    void setHolding(const QString &asset, double amount);
+    double holding(const QString &asset);
+    QString portfolioBtc();
+    QString portfolioUsd();
+
+    QString exportHistory(int days = 30, bool json = false);
+    QString memoryReport();
+
+    void beginRefresh();
+    void endRefresh();
+
     QString version(bool shrt = false);
     QString versionDate();
 
+signals:
+    void alert(const QString &message);
+    void exportFinished(const QString &message);
+
+private slots:
+    void onOnlineChanged(bool online);
+    void onServiceChanged(bool available);
+    void syncService();
+    void onExportDone(bool ok, qint64 rows, const QString &error);
+    void onFlushed();
+    void onAlertTriggered(int rule, int pair, const Price &price);
+    void onFrameStarted();
+    void onFrameSwapped();
+
 private:
+    int effectiveInterval();
+    void syncUsage();
+    bool isCoinEnabled(const char *coin);
+    void loadAlerts();
+    void saveAlerts();
+    QString describeAlert(const AlertEngine::Rule &rule);
+    QString ticker(bool enabled, int pair);
+    QString age(const Quote &quote);
+
     int m_updateInterval;
+    int m_cellularInterval;
+    int m_apiPort;
+    int m_dataBudget;
     uint m_updated;
     bool m_offlineMode;
     bool m_btcEnabled;
@@ -91,10 +158,15 @@ private:
     bool m_cloakEnabled;
     bool m_xmrEnabled;
     bool m_xcEnabled;
+    bool m_framesTraced;
+    QString m_exportPath;       // waiting for the service to flush
+    int m_exportDays;
+    bool m_exportJson;
 
-    BitFinex m_bitfinex;
-    Cryptsy m_cryptsy;
-    PoloniEx m_poloniex;
+    TickerCore m_core;
+    TickerClient m_client;
+    HttpApi m_api;
+    HistoryExport m_export;
 
     QSettings m_settings;
 };
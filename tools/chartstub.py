@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+#
+# This program is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Local stand-in for the Poloniex chart endpoint, used to test the backfill
+# without touching the exchange. Serves recorded returnChartData responses
+# from DIR/<currencyPair>.json, filtered by start and end like the original:
+#
+#   python tools/chartstub.py --record BTC_XMR --days 30 --dir recordings
+#   python tools/chartstub.py --dir recordings --port 8422 --fail-every 5
+#   drkjolla-cli --backfill 30 --backfill-url http://localhost:8422/public
+#
+# --fail-every N answers every Nth request with a 503 to exercise resuming.
+
+import argparse
+import json
+import os
+import sys
+import time
+
+try:
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+    from urllib.parse import urlparse, parse_qs
+    from urllib.request import urlopen
+except ImportError:
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+    from urlparse import urlparse, parse_qs
+    from urllib2 import urlopen
+
+EMPTY = [{"date": 0, "high": 0, "low": 0, "open": 0, "close": 0,
+          "volume": 0, "quoteVolume": 0, "weightedAverage": 0}]
+
+
+def record(pair, days, directory):
+    end = int(time.time())
+    start = end - days * 86400
+    url = ("https://poloniex.com/public?command=returnChartData"
+           "&currencyPair=%s&start=%d&end=%d&period=300" % (pair, start, end))
+    data = urlopen(url).read()
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+    with open(os.path.join(directory, pair + ".json"), "wb") as out:
+        out.write(data)
+
+
+class Handler(BaseHTTPRequestHandler):
+    requests = 0
+
+    def do_GET(self):
+        Handler.requests += 1
+        if self.server.fail_every and Handler.requests % self.server.fail_every == 0:
+            self.send_error(503)
+            return
+
+        query = parse_qs(urlparse(self.path).query)
+        if query.get("command", [""])[0] != "returnChartData":
+            self.send_error(404)
+            return
+        pair = query.get("currencyPair", [""])[0]
+        start = int(query.get("start", ["0"])[0])
+        end = int(query.get("end", ["9999999999"])[0])
+
+        candles = []
+        path = os.path.join(self.server.directory, os.path.basename(pair) + ".json")
+        if os.path.exists(path):
+            with open(path) as recording:
+                candles = [c for c in json.load(recording) if start <= c["date"] <= end]
+
+        body = json.dumps(candles or EMPTY).encode("ascii")
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--dir", default="recordings")
+    parser.add_argument("--port", type=int, default=8422)
+    parser.add_argument("--fail-every", type=int, default=0)
+    parser.add_argument("--record", metavar="PAIR")
+    parser.add_argument("--days", type=int, default=30)
+    args = parser.parse_args()
+
+    if args.record:
+        record(args.record, args.days, args.dir)
+        return 0
+
+    server = HTTPServer(("127.0.0.1", args.port), Handler)
+    server.directory = args.dir
+    server.fail_every = args.fail_every
+    sys.stderr.write("serving %s on port %d\n" % (args.dir, args.port))
+    server.serve_forever()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2014 Alexander Schoedon <schoedon@uni-potsdam.de>
+#
+# This program is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Generates the perfect hash table of src/core/symbols.cpp. Keep MARKETS in the same
+# order as the Pair::Id enum and paste the output over the generated block.
+
+import sys
+
+MARKETS = [
+    (0, "btcusd"), (0, "drkusd"), (0, "drkbtc"),
+    (1, "2"), (1, "213"), (1, "155"), (1, "214"), (1, "66"), (1, "121"),
+    (1, "256"), (1, "227"), (1, "228"), (1, "210"), (1, "216"),
+    (2, "XUSD_BTC"), (2, "XUSD_XMR"), (2, "BTC_DRK"), (2, "XMR_DRK"),
+    (2, "BTC_BTCD"), (2, "XMR_BTCD"), (2, "BTC_XC"), (2, "BTC_XMR"),
+]
+
+TABLE_SIZE = 64
+
+
+def phash(seed, exchange, key):
+    # must match Symbols::hash()
+    h = (2166136261 ^ seed) & 0xffffffff
+    for c in bytearray([exchange]) + bytearray(key.encode("ascii")):
+        h ^= c
+        h = (h * 16777619) & 0xffffffff
+    return h
+
+
+def main():
+    for seed in range(1 << 24):
+        slots = [phash(seed, e, k) % TABLE_SIZE for e, k in MARKETS]
+        if len(set(slots)) == len(slots):
+            break
+    else:
+        sys.exit("no perfect seed found, increase TABLE_SIZE")
+
+    table = [-1] * TABLE_SIZE
+    for pair, slot in enumerate(slots):
+        table[slot] = pair
+
+    print("    static const quint32 SEED = %d;" % seed)
+    print("    static const int TABLE_SIZE = %d;" % TABLE_SIZE)
+    print("    static const qint8 TABLE[TABLE_SIZE] = {")
+    for i in range(0, TABLE_SIZE, 16):
+        row = ", ".join("%2d" % v for v in table[i:i + 16])
+        print("        %s%s" % (row, "," if i + 16 < TABLE_SIZE else ""))
+    print("    };")
+
+
+if __name__ == "__main__":
+    main()